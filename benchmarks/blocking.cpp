@@ -0,0 +1,38 @@
+// One generation at a time against `step(generations)` on a Game of Life
+// 8192x8192 grid, 64 MiB per buffer.
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+#include "game_of_life.hpp"
+
+int main() {
+	constexpr size_t size        = 8192;
+	constexpr size_t generations = 32;
+
+	gol::GameOfLife             single(size, size);
+	std::mt19937                rng(42);
+	std::bernoulli_distribution alive(0.3);
+	for (size_t x = 0; x < size; ++x) {
+		for (size_t y = 0; y < size; ++y) {
+			if (alive(rng)) { single(x, y) = gol::State::Alive; }
+		}
+	}
+	gol::GameOfLife blocked = single;
+
+	auto time = [](auto&& run) {
+		const auto start = std::chrono::steady_clock::now();
+		run();
+		const std::chrono::duration<double, std::nano> elapsed =
+		    std::chrono::steady_clock::now() - start;
+		return elapsed.count() / generations / (size * size);
+	};
+	const double single_ns = time([&] {
+		for (size_t i = 0; i < generations; ++i) { single.step(); }
+	});
+	const double blocked_ns = time([&] { blocked.step(generations); });
+
+	std::printf("step()            %.3f ns/cell\n", single_ns);
+	std::printf("step(%zu)          %.3f ns/cell\n", generations, blocked_ns);
+	return 0;
+}
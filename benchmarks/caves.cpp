@@ -0,0 +1,75 @@
+// Cave maps per second at 80x50, the size of a roguelike level, with 5
+// smoothing passes and every region but the largest pruned: one `Caves`
+// automaton per map, the way a single map is made, against `CaveBatch` on
+// one thread and on every core.
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "caves.hpp"
+
+using namespace caves;
+
+namespace {
+constexpr size_t width  = 80;
+constexpr size_t height = 50;
+constexpr size_t maps   = 20000;
+
+double seconds_since(const std::chrono::steady_clock::time_point start) {
+	const std::chrono::duration<double> elapsed =
+	    std::chrono::steady_clock::now() - start;
+	return elapsed.count();
+}
+} // namespace
+
+int main() {
+	CaveOptions options;
+	options.largest_only = true;
+
+	// Floors over every map, which all three have to agree on.
+	size_t     automaton_floors = 0;
+	const auto start            = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < maps; ++i) {
+		Caves caves(width, height);
+		caves.generate(options, i);
+		for (size_t x = 0; x < width; ++x) {
+			for (size_t y = 0; y < height; ++y) {
+				automaton_floors += caves(x, y) == State::Floor;
+			}
+		}
+	}
+	const double automaton_seconds = seconds_since(start);
+
+	std::printf("%zux%zu, %zu passes, largest region only, %zu maps\n",
+	            width,
+	            height,
+	            options.passes,
+	            maps);
+	std::printf("Caves::generate:      %10.0f maps/s\n",
+	            maps / automaton_seconds);
+
+	CaveBatch            batch(width, height, options);
+	std::vector<CaveMap> out;
+	std::vector<size_t>  thread_counts{1};
+	if (std::thread::hardware_concurrency() > 1) {
+		thread_counts.push_back(std::thread::hardware_concurrency());
+	}
+	for (const size_t threads : thread_counts) {
+		batch.set_threads(threads);
+		// Once to size the buffers and the maps, then timed in place.
+		batch.generate(out, 0, maps);
+		const auto batch_start = std::chrono::steady_clock::now();
+		batch.generate(out, 0, maps);
+		const double seconds = seconds_since(batch_start);
+		size_t       floors  = 0;
+		for (const CaveMap& map : out) { floors += map.floors; }
+		std::printf("CaveBatch, %2zu %s: %10.0f maps/s (%.2fx)%s\n",
+		            threads,
+		            threads == 1 ? "thread " : "threads",
+		            maps / seconds,
+		            automaton_seconds / seconds,
+		            floors == automaton_floors ? "" : " (mismatch)");
+	}
+	return 0;
+}
@@ -0,0 +1,95 @@
+// Saving and restoring a checkpoint of a 32768x32768 (about 1 billion cell)
+// Game of Life grid with 1% of its cells alive, with and without
+// compression, against loading the same grid from plain text. The size can
+// be given as the first argument.
+//
+// Restoring an uncompressed checkpoint only maps it, so the first step after
+// it is timed as well, which is when its cells are actually read.
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+
+#include "game_of_life.hpp"
+
+namespace {
+double seconds_since(const std::chrono::steady_clock::time_point start) {
+	const std::chrono::duration<double> elapsed =
+	    std::chrono::steady_clock::now() - start;
+	return elapsed.count();
+}
+} // namespace
+
+int main(int argc, char** argv) {
+	const size_t size       = argc > 1 ? std::stoul(argv[1]) : 32768;
+	const auto   directory  = std::filesystem::temp_directory_path();
+	const auto   raw        = directory / "cellular_benchmark.checkpoint";
+	const auto   compressed = directory / "cellular_benchmark_rle.checkpoint";
+	const auto   text       = directory / "cellular_benchmark.txt";
+
+	std::printf("%zux%zu cells\n", size, size);
+	std::printf("%-30s %10s %10s\n", "", "seconds", "MiB");
+	auto report = [](const char* name, const double seconds, const auto& path) {
+		std::printf("%-30s %10.2f %10.1f\n",
+		            name,
+		            seconds,
+		            std::filesystem::file_size(path) / 1048576.0);
+	};
+
+	{
+		gol::GameOfLife             automaton(size, size);
+		std::mt19937                rng(42);
+		std::bernoulli_distribution alive(0.01);
+		for (size_t x = 0; x < size; ++x) {
+			for (size_t y = 0; y < size; ++y) {
+				if (alive(rng)) { automaton(x, y) = gol::State::Alive; }
+			}
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		automaton.save_checkpoint(raw);
+		report("save", seconds_since(start), raw);
+
+		start = std::chrono::steady_clock::now();
+		automaton.save_checkpoint(compressed, cellular::io::Compression::rle);
+		report("save compressed", seconds_since(start), compressed);
+
+		std::ofstream out(text, std::ios::binary);
+		std::string   line(size, '*');
+		for (size_t y = 0; y < size; ++y) {
+			for (size_t x = 0; x < size; ++x) {
+				line[x] = automaton.state_to_char(automaton(x, y));
+			}
+			out << line << '\n';
+		}
+	}
+
+	{
+		gol::GameOfLife automaton(1, 1);
+		auto            start = std::chrono::steady_clock::now();
+		automaton.restore_checkpoint(raw);
+		report("restore", seconds_since(start), raw);
+		start = std::chrono::steady_clock::now();
+		automaton.step();
+		report("first step after restore", seconds_since(start), raw);
+	}
+	{
+		gol::GameOfLife automaton(1, 1);
+		const auto      start = std::chrono::steady_clock::now();
+		automaton.restore_checkpoint(compressed);
+		report("restore compressed", seconds_since(start), compressed);
+	}
+	{
+		gol::GameOfLife automaton(1, 1);
+		const auto      start = std::chrono::steady_clock::now();
+		automaton.set_grid_from_file(text);
+		report("load plain text", seconds_since(start), text);
+	}
+
+	std::filesystem::remove(raw);
+	std::filesystem::remove(compressed);
+	std::filesystem::remove(text);
+	return 0;
+}
@@ -0,0 +1,95 @@
+// Time per generation of the scalar step on a 2048x2048 Game of Life grid,
+// with the rule called through the virtual `next_state` and bound at compile
+// time through `StaticAutomaton`. Neither has a `CountRule`, so both go
+// through the loop over every cell.
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+#include "cellular_layout.hpp"
+#include "cellular_static.hpp"
+#include "game_of_life.hpp"
+
+using gol::State;
+
+namespace {
+inline State life(const State current_cell, const unsigned int live) {
+	return live == 3 || (current_cell == State::Alive && live == 2)
+	           ? State::Alive
+	           : State::Dead;
+}
+
+template<typename Layout>
+class VirtualLife : public Automaton<State, Layout> {
+public:
+	using Automaton<State, Layout>::Automaton;
+	char  state_to_char(State) const override { return '*'; }
+	State char_to_state(char) const override { return State::Dead; }
+	State cycle_state(const State current_cell) const override {
+		return current_cell;
+	}
+
+protected:
+	State next_state(const State  current_cell,
+	                 const size_t x,
+	                 const size_t y) override {
+		return life(current_cell, this->count_moore(x, y, State::Alive));
+	}
+};
+
+template<typename Layout>
+class StaticLife : public StaticAutomaton<StaticLife<Layout>, State, Layout> {
+public:
+	using StaticAutomaton<StaticLife, State, Layout>::StaticAutomaton;
+	char  state_to_char(State) const override { return '*'; }
+	State char_to_state(char) const override { return State::Dead; }
+	State cycle_state(const State current_cell) const override {
+		return current_cell;
+	}
+	State next_cell(const State  current_cell,
+	                const size_t x,
+	                const size_t y) const {
+		return life(current_cell, this->count_moore(x, y, State::Alive));
+	}
+};
+
+template<typename Life>
+double seconds_per_generation(const int generations) {
+	constexpr size_t            size = 2048;
+	Life                        automaton(size, size);
+	std::mt19937                rng(42);
+	std::bernoulli_distribution alive(0.3);
+	for (size_t x = 0; x < size; ++x) {
+		for (size_t y = 0; y < size; ++y) {
+			automaton(x, y) = alive(rng) ? State::Alive : State::Dead;
+		}
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < generations; ++i) { automaton.step(); }
+	const std::chrono::duration<double> elapsed =
+	    std::chrono::steady_clock::now() - start;
+	return elapsed.count() / generations;
+}
+
+template<typename Layout>
+void compare(const char* name) {
+	constexpr int generations  = 10;
+	const double  virtual_time =
+	    seconds_per_generation<VirtualLife<Layout>>(generations);
+	const double static_time =
+	    seconds_per_generation<StaticLife<Layout>>(generations);
+	std::printf("%-14s virtual %8.3f ms  static %8.3f ms  %6.2fx\n",
+	            name,
+	            virtual_time * 1e3,
+	            static_time * 1e3,
+	            virtual_time / static_time);
+}
+} // namespace
+
+int main() {
+	std::printf("2048x2048, ms/generation\n");
+	compare<stdex::layout_right>("layout_right");
+	compare<layout_tiled<64>>("layout_tiled");
+	return 0;
+}
@@ -0,0 +1,74 @@
+// Game of Life on a 4096x4096 random soup split over 1, 2, 4 and 8 worker
+// processes, against a single `GameOfLife`. Scattering and gathering the
+// grid are timed separately from stepping.
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+#include "cellular_domain.hpp"
+#include "game_of_life.hpp"
+
+namespace {
+double seconds_since(const std::chrono::steady_clock::time_point start) {
+	const std::chrono::duration<double> elapsed =
+	    std::chrono::steady_clock::now() - start;
+	return elapsed.count();
+}
+} // namespace
+
+int main() {
+	constexpr size_t size        = 4096;
+	constexpr int    generations = 20;
+
+	gol::GameOfLife             whole(size, size);
+	std::mt19937                rng(42);
+	std::bernoulli_distribution alive(0.3);
+	for (size_t x = 0; x < size; ++x) {
+		for (size_t y = 0; y < size; ++y) {
+			if (alive(rng)) { whole(x, y) = gol::State::Alive; }
+		}
+	}
+
+	std::printf("%zux%zu random soup, %d generations\n",
+	            size,
+	            size,
+	            generations);
+	std::printf("%-10s %12s %12s %12s\n",
+	            "workers",
+	            "scatter s",
+	            "ms/gen",
+	            "gather s");
+	{
+		gol::GameOfLife single = whole;
+		const auto      start  = std::chrono::steady_clock::now();
+		single.step(generations);
+		std::printf("%-10s %12s %12.3f %12s\n",
+		            "none",
+		            "-",
+		            seconds_since(start) * 1e3 / generations,
+		            "-");
+	}
+	for (const size_t workers : {1, 2, 4, 8}) {
+		cellular::Domain<gol::GameOfLife> domain(size, size, workers);
+
+		auto start = std::chrono::steady_clock::now();
+		domain.scatter(whole);
+		const double scatter = seconds_since(start);
+
+		start = std::chrono::steady_clock::now();
+		domain.step(generations);
+		const double step = seconds_since(start) / generations;
+
+		gol::GameOfLife gathered(size, size);
+		start = std::chrono::steady_clock::now();
+		domain.gather(gathered);
+		const double gather = seconds_since(start);
+
+		std::printf("%-10zu %12.3f %12.3f %12.3f\n",
+		            workers,
+		            scatter,
+		            step * 1e3,
+		            gather);
+	}
+	return 0;
+}
@@ -0,0 +1,83 @@
+// Steps 4096 independent 64x64 random soups, one at a time as `GameOfLife`
+// and `PackedGameOfLife` objects and all together in a `LifeEnsemble`, on
+// one thread and on every hardware thread.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "game_of_life.hpp"
+#include "life_ensemble.hpp"
+#include "packed_game_of_life.hpp"
+
+using namespace gol;
+
+namespace {
+constexpr size_t size      = 64;
+constexpr size_t instances = 4096;
+
+/// Seconds per generation of every instance in `automata`.
+template<typename Life>
+double seconds_per_generation(std::vector<Life>& automata,
+                              const int          generations) {
+	const auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < generations; ++i) {
+		for (Life& automaton : automata) { automaton.step(); }
+	}
+	const std::chrono::duration<double> elapsed =
+	    std::chrono::steady_clock::now() - start;
+	return elapsed.count() / generations;
+}
+
+double seconds_per_generation(LifeEnsemble& ensemble, const int generations) {
+	const auto start = std::chrono::steady_clock::now();
+	ensemble.step(generations);
+	const std::chrono::duration<double> elapsed =
+	    std::chrono::steady_clock::now() - start;
+	return elapsed.count() / generations;
+}
+} // namespace
+
+int main() {
+	std::mt19937                rng(42);
+	std::bernoulli_distribution alive(0.3);
+	std::vector<GameOfLife>     dense;
+	for (size_t i = 0; i < instances; ++i) {
+		dense.emplace_back(size, size);
+		for (size_t x = 0; x < size; ++x) {
+			for (size_t y = 0; y < size; ++y) {
+				dense.back()(x, y) = alive(rng) ? State::Alive : State::Dead;
+			}
+		}
+	}
+	std::vector<PackedGameOfLife> packed(dense.begin(), dense.end());
+	LifeEnsemble                  ensemble(size, size, instances);
+	for (size_t i = 0; i < instances; ++i) { ensemble.assign(i, dense[i]); }
+
+	const size_t threads = std::max(1U, std::thread::hardware_concurrency());
+	LifeEnsemble parallel = ensemble;
+	parallel.set_threads(threads);
+
+	const double dense_time    = seconds_per_generation(dense, 2);
+	const double packed_time   = seconds_per_generation(packed, 20);
+	const double ensemble_time = seconds_per_generation(ensemble, 200);
+	const double parallel_time = seconds_per_generation(parallel, 200);
+
+	std::printf("%zu instances of %zux%zu\n", instances, size, size);
+	auto report = [](const char* name, const double time, const double base) {
+		std::printf("%-20s %10.3f ms/generation %12.0f instances/s %8.1fx\n",
+		            name,
+		            time * 1e3,
+		            instances / time,
+		            base / time);
+	};
+	report("dense", dense_time, dense_time);
+	report("packed", packed_time, dense_time);
+	report("ensemble", ensemble_time, dense_time);
+	char name[32];
+	std::snprintf(name, sizeof(name), "ensemble, %zu threads", threads);
+	report(name, parallel_time, dense_time);
+	return 0;
+}
@@ -0,0 +1,78 @@
+// Time per generation of a 512x512 Game of Life soup stepped on its own, and
+// stepped while every generation is exported as a PPM frame at twice the
+// size, with the frames encoded and written by 1 and by 2 background
+// workers. The exporter only costs the simulation its copy of the grid
+// unless the workers fall behind.
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+
+#include "cellular_export.hpp"
+#include "game_of_life.hpp"
+
+using namespace gol;
+
+namespace {
+constexpr size_t size   = 512;
+constexpr size_t frames = 100;
+
+GameOfLife soup() {
+	GameOfLife                  automaton(size, size);
+	std::mt19937                rng(42);
+	std::bernoulli_distribution alive(0.3);
+	for (size_t x = 0; x < size; ++x) {
+		for (size_t y = 0; y < size; ++y) {
+			automaton(x, y) = alive(rng) ? State::Alive : State::Dead;
+		}
+	}
+	return automaton;
+}
+
+/// Seconds per generation, exporting into `directory` with `workers`
+/// threads, or not at all for 0.
+double run(const std::filesystem::path& directory, const size_t workers) {
+	GameOfLife automaton = soup();
+	const auto start     = std::chrono::steady_clock::now();
+	if (workers == 0) {
+		automaton.step(frames);
+	} else {
+		cellular::ExportOptions options;
+		options.directory = directory;
+		options.scale     = 2;
+		options.workers   = workers;
+		cellular::FrameExporter<State> exporter(
+		    {{State::Dead, {0, 0, 0}}, {State::Alive, {255, 255, 255}}},
+		    options);
+		for (size_t generation = 0; generation < frames; ++generation) {
+			exporter.submit(automaton);
+			automaton.step();
+		}
+		exporter.finish();
+	}
+	const std::chrono::duration<double> elapsed =
+	    std::chrono::steady_clock::now() - start;
+	return elapsed.count() / frames;
+}
+} // namespace
+
+int main() {
+	const std::filesystem::path directory =
+	    std::filesystem::temp_directory_path() / "cellular_export_benchmark";
+	std::filesystem::create_directories(directory);
+
+	const double plain = run(directory, 0);
+	std::printf("%zux%zu, %zu generations\n", size, size, frames);
+	std::printf("stepping only:          %8.3f ms/generation\n", plain * 1e3);
+	for (const size_t workers : {1, 2}) {
+		const double exported = run(directory, workers);
+		std::printf("with PPM export, %zu %s: %8.3f ms/generation (%.2fx)\n",
+		            workers,
+		            workers == 1 ? "worker " : "workers",
+		            exported * 1e3,
+		            exported / plain);
+	}
+
+	std::filesystem::remove_all(directory);
+	return 0;
+}
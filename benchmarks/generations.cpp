@@ -0,0 +1,84 @@
+// Time to consume 200 generations of a 1024x1024 Game of Life soup, with a
+// consumer that renders every generation as text, through `generations`,
+// which steps in between, and through `pipelined_generations`, which steps
+// on another thread while the consumer works.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+
+#include "cellular_stream.hpp"
+#include "game_of_life.hpp"
+
+using namespace gol;
+
+namespace {
+constexpr size_t size   = 1024;
+constexpr size_t frames = 200;
+
+GameOfLife soup() {
+	GameOfLife                  automaton(size, size);
+	std::mt19937                rng(42);
+	std::bernoulli_distribution alive(0.3);
+	for (size_t x = 0; x < size; ++x) {
+		for (size_t y = 0; y < size; ++y) {
+			automaton(x, y) = alive(rng) ? State::Alive : State::Dead;
+		}
+	}
+	return automaton;
+}
+
+struct Consumed {
+	double seconds;
+	/// Live cells in the last text, which both streams have to agree on.
+	size_t alive;
+};
+
+/// Consume `stream` like a writer would.
+template<typename Stream>
+Consumed consume(Stream&& stream, const GameOfLife& characters) {
+	const auto  start = std::chrono::steady_clock::now();
+	std::string text(size * (size + 1), '\n');
+	size_t      taken = 0;
+	for (const auto& grid : stream) {
+		for (size_t y = 0; y < size; ++y) {
+			for (size_t x = 0; x < size; ++x) {
+				text[y * (size + 1) + x] = characters.state_to_char(grid(x, y));
+			}
+		}
+		if (++taken == frames) { break; }
+	}
+	const std::chrono::duration<double> elapsed =
+	    std::chrono::steady_clock::now() - start;
+	const char alive = characters.state_to_char(State::Alive);
+	return {elapsed.count(),
+	        static_cast<size_t>(std::count(text.begin(), text.end(), alive))};
+}
+} // namespace
+
+int main() {
+	const GameOfLife characters(1, 1);
+
+	GameOfLife     in_place = soup();
+	const Consumed serial =
+	    consume(cellular::generations(in_place), characters);
+	GameOfLife     threaded = soup();
+	const Consumed pipelined =
+	    consume(cellular::pipelined_generations(threaded), characters);
+
+	std::printf("%zux%zu, %zu generations rendered as text, %zu alive in the"
+	            " last\n",
+	            size,
+	            size,
+	            frames,
+	            serial.alive);
+	std::printf("generations:           %8.3f ms/generation\n",
+	            serial.seconds * 1e3 / frames);
+	std::printf("pipelined_generations: %8.3f ms/generation%s\n",
+	            pipelined.seconds * 1e3 / frames,
+	            pipelined.alive == serial.alive ? "" : " (mismatch)");
+	std::printf("speedup:               %8.2fx\n",
+	            serial.seconds / pipelined.seconds);
+	return 0;
+}
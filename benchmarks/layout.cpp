@@ -0,0 +1,153 @@
+// Time and cache misses per generation of the scalar `Automaton::step` in
+// every grid layout, on an 8192x8192 Game of Life grid (64 MiB, far larger
+// than L2). Cache misses are read from perf events on Linux and reported as
+// n/a where those aren't available.
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "cellular_layout.hpp"
+#include "game_of_life.hpp"
+
+using gol::State;
+
+namespace {
+/// Game of Life stored with `Layout`, without a `CountRule` so that every
+/// layout goes through the same scalar code.
+template<typename Layout>
+class LayoutLife : public Automaton<State, Layout> {
+public:
+	using Automaton<State, Layout>::Automaton;
+	char  state_to_char(State) const override { return '*'; }
+	State char_to_state(char) const override { return State::Dead; }
+	State cycle_state(const State current_cell) const override {
+		return current_cell;
+	}
+
+protected:
+	State next_state(const State  current_cell,
+	                 const size_t x,
+	                 const size_t y) override {
+		const unsigned int live = this->count_moore(x, y, State::Alive);
+		return live == 3 || (current_cell == State::Alive && live == 2)
+		           ? State::Alive
+		           : State::Dead;
+	}
+};
+
+/// A hardware cache event counter, or a no-op one where there are none.
+class CacheCounter {
+public:
+	CacheCounter(const std::uint64_t config) {
+#ifdef __linux__
+		perf_event_attr attr{};
+		attr.type           = PERF_TYPE_HW_CACHE;
+		attr.size           = sizeof(attr);
+		attr.config         = config;
+		attr.disabled       = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv     = 1;
+		m_fd = static_cast<int>(
+		    syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#else
+		(void)config;
+#endif
+	}
+	~CacheCounter() {
+#ifdef __linux__
+		if (m_fd >= 0) { close(m_fd); }
+#endif
+	}
+
+	void start() {
+#ifdef __linux__
+		if (m_fd >= 0) {
+			ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+			ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+		}
+#endif
+	}
+	/// The count since `start`, or -1 if the event isn't available.
+	double stop() {
+#ifdef __linux__
+		std::uint64_t count = 0;
+		if (m_fd >= 0) {
+			ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+			if (read(m_fd, &count, sizeof(count)) == sizeof(count)) {
+				return static_cast<double>(count);
+			}
+		}
+#endif
+		return -1;
+	}
+
+private:
+	int m_fd = -1;
+};
+
+#ifdef __linux__
+constexpr std::uint64_t read_misses(const std::uint64_t cache) {
+	return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+	       | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+constexpr std::uint64_t l1d_misses = read_misses(PERF_COUNT_HW_CACHE_L1D);
+constexpr std::uint64_t llc_misses = read_misses(PERF_COUNT_HW_CACHE_LL);
+#else
+constexpr std::uint64_t l1d_misses = 0;
+constexpr std::uint64_t llc_misses = 0;
+#endif
+
+constexpr size_t size        = 8192;
+constexpr int    generations = 3;
+
+template<typename Layout>
+void run(const char* name) {
+	LayoutLife<Layout>          automaton(size, size);
+	std::mt19937                rng(42);
+	std::bernoulli_distribution alive(0.3);
+	for (size_t x = 0; x < size; ++x) {
+		for (size_t y = 0; y < size; ++y) {
+			if (alive(rng)) { automaton(x, y) = State::Alive; }
+		}
+	}
+
+	CacheCounter l1d(l1d_misses);
+	CacheCounter llc(llc_misses);
+	l1d.start();
+	llc.start();
+	const auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < generations; ++i) { automaton.step(); }
+	const std::chrono::duration<double> elapsed =
+	    std::chrono::steady_clock::now() - start;
+	const double l1d_count = l1d.stop();
+	const double llc_count = llc.stop();
+
+	std::printf("%-16s  %13.1f", name, elapsed.count() / generations * 1e3);
+	for (const double count : {l1d_count, llc_count}) {
+		if (count < 0) {
+			std::printf("  %14s", "n/a");
+		} else {
+			std::printf("  %14.4f", count / generations / (size * size));
+		}
+	}
+	std::printf("\n");
+}
+} // namespace
+
+int main() {
+	std::printf(
+	    "layout            ms/generation  L1d miss/cell  LLC miss/cell\n");
+	run<stdex::layout_right>("layout_right");
+	run<layout_tiled<32>>("layout_tiled<32>");
+	run<layout_tiled<64>>("layout_tiled<64>");
+	run<layout_morton<64>>("layout_morton<64>");
+	return 0;
+}
@@ -0,0 +1,102 @@
+// Loading a 16384x16384 Game of Life soup from plain text and RLE files into
+// `GameOfLife` and `PackedGameOfLife`. The peak RSS after every load is the
+// grids plus the pages of the mapped file, which are clean page cache that
+// the OS can drop, rather than copies of the file's contents.
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+
+#ifdef __unix__
+#include <sys/resource.h>
+#endif
+
+#include "game_of_life.hpp"
+#include "packed_game_of_life.hpp"
+
+namespace {
+constexpr size_t size = 16384;
+
+/// Peak resident set size of the process in MiB, or -1 if unknown.
+double peak_rss_mib() {
+#ifdef __unix__
+	rusage usage{};
+	if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+		return usage.ru_maxrss / 1048576.0;
+#else
+		return usage.ru_maxrss / 1024.0;
+#endif
+	}
+#endif
+	return -1;
+}
+
+/// Write the same random soup as plain text and RLE.
+void write_soup(const std::filesystem::path& plain,
+                const std::filesystem::path& rle) {
+	std::ofstream               plain_out(plain, std::ios::binary);
+	std::ofstream               rle_out(rle, std::ios::binary);
+	std::mt19937                rng(42);
+	std::bernoulli_distribution alive(0.3);
+	rle_out << "x = " << size << ", y = " << size << ", rule = B3/S23\n";
+	std::string line(size, '*');
+	std::string runs;
+	for (size_t y = 0; y < size; ++y) {
+		runs.clear();
+		for (size_t x = 0; x < size;) {
+			const bool state = alive(rng);
+			size_t     run   = 1;
+			line[x]          = state ? '#' : '*';
+			while (x + run < size && run < 8 && alive(rng) == state) {
+				line[x + run] = state ? '#' : '*';
+				++run;
+			}
+			x += run;
+			if (run > 1) { runs += std::to_string(run); }
+			runs += state ? 'o' : 'b';
+		}
+		plain_out << line << '\n';
+		rle_out << runs << (y + 1 == size ? "!\n" : "$\n");
+	}
+}
+
+template<typename Life>
+void load(const char* name, const std::filesystem::path& path) {
+	const auto start = std::chrono::steady_clock::now();
+	const Life automaton(path);
+	const std::chrono::duration<double> elapsed =
+	    std::chrono::steady_clock::now() - start;
+	const double mib = std::filesystem::file_size(path) / 1048576.0;
+	std::printf("%-28s %10.1f %10.1f %12.1f\n",
+	            name,
+	            mib,
+	            mib / elapsed.count(),
+	            peak_rss_mib());
+	(void)automaton(0, 0);
+}
+} // namespace
+
+int main() {
+	const auto directory = std::filesystem::temp_directory_path();
+	const auto plain     = directory / "cellular_load_benchmark.txt";
+	const auto rle       = directory / "cellular_load_benchmark.rle";
+	write_soup(plain, rle);
+
+	std::printf("%-28s %10s %10s %12s\n",
+	            "load",
+	            "MiB",
+	            "MiB/s",
+	            "peak RSS MiB");
+	// Smallest grid first, since the peak RSS only ever goes up.
+	load<gol::PackedGameOfLife>("PackedGameOfLife from RLE", rle);
+	load<gol::PackedGameOfLife>("PackedGameOfLife from text", plain);
+	load<gol::GameOfLife>("GameOfLife from RLE", rle);
+	load<gol::GameOfLife>("GameOfLife from text", plain);
+
+	std::filesystem::remove(plain);
+	std::filesystem::remove(rle);
+	return 0;
+}
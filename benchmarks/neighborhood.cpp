@@ -0,0 +1,71 @@
+// Compares the map based neighborhood functions with the fixed-size views on
+// a 4096x4096 Game of Life grid.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+#include "game_of_life.hpp"
+
+using namespace gol;
+
+// Game of Life as it was written against the map based neighborhood API,
+// without a `CountRule` so that it steps through `next_state`.
+class MapGameOfLife : public Automaton<State> {
+public:
+	using Automaton<State>::Automaton;
+	char  state_to_char(State) const override { return '*'; }
+	State char_to_state(char) const override { return State::Dead; }
+	State cycle_state(const State current_cell) const override {
+		return current_cell;
+	}
+
+protected:
+	State next_state(const State  current_cell,
+	                 const size_t x,
+	                 const size_t y) override {
+		const auto&  neighborhood = moore_neighborhood_at(x, y);
+		unsigned int live_neighbors =
+		    std::count_if(std::begin(neighborhood),
+		                  std::end(neighborhood),
+		                  [](std::pair<const char*, State> const& p) {
+			                  return p.second == State::Alive;
+		                  });
+		if (live_neighbors == 3) { return State::Alive; }
+		return live_neighbors == 2 ? current_cell : State::Dead;
+	}
+};
+
+template<typename Life>
+double seconds_per_generation(Life& automaton, const int generations) {
+	std::mt19937                rng(42);
+	std::bernoulli_distribution alive(0.3);
+	for (size_t x = 0; x < automaton.width(); ++x) {
+		for (size_t y = 0; y < automaton.height(); ++y) {
+			automaton(x, y) = alive(rng) ? State::Alive : State::Dead;
+		}
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < generations; ++i) { automaton.step(); }
+	const std::chrono::duration<double> elapsed =
+	    std::chrono::steady_clock::now() - start;
+	return elapsed.count() / generations;
+}
+
+int main() {
+	constexpr size_t size        = 4096;
+	constexpr int    generations = 3;
+
+	MapGameOfLife map_life(size, size);
+	GameOfLife    view_life(size, size);
+
+	const double map_time  = seconds_per_generation(map_life, generations);
+	const double view_time = seconds_per_generation(view_life, generations);
+
+	std::printf("%zux%zu, %d generations\n", size, size, generations);
+	std::printf("map:     %8.3f s/generation\n", map_time);
+	std::printf("view:    %8.3f s/generation\n", view_time);
+	std::printf("speedup: %8.2fx\n", map_time / view_time);
+	return 0;
+}
@@ -0,0 +1,52 @@
+// Compares the enum-per-cell `GameOfLife` with the bit-packed
+// `PackedGameOfLife` on a 4096x4096 random soup.
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+#include "game_of_life.hpp"
+#include "packed_game_of_life.hpp"
+
+using namespace gol;
+
+template<typename Life>
+double seconds_per_generation(Life& automaton, const int generations) {
+	const auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < generations; ++i) { automaton.step(); }
+	const std::chrono::duration<double> elapsed =
+	    std::chrono::steady_clock::now() - start;
+	return elapsed.count() / generations;
+}
+
+int main() {
+	constexpr size_t size = 4096;
+
+	GameOfLife                  dense(size, size);
+	std::mt19937                rng(42);
+	std::bernoulli_distribution alive(0.3);
+	for (size_t x = 0; x < size; ++x) {
+		for (size_t y = 0; y < size; ++y) {
+			dense(x, y) = alive(rng) ? State::Alive : State::Dead;
+		}
+	}
+	PackedGameOfLife packed(dense);
+
+	const double dense_time  = seconds_per_generation(dense, 3);
+	const double packed_time = seconds_per_generation(packed, 100);
+
+	// Both engines keep a current and a next buffer.
+	const double dense_bytes  = 2.0 * size * size * sizeof(State);
+	const double packed_bytes = 2.0 * size * size / 8;
+
+	std::printf("%zux%zu random soup\n", size, size);
+	std::printf("dense:   %10.3f ms/generation %8.1f MiB\n",
+	            dense_time * 1e3,
+	            dense_bytes / (1 << 20));
+	std::printf("packed:  %10.3f ms/generation %8.1f MiB\n",
+	            packed_time * 1e3,
+	            packed_bytes / (1 << 20));
+	std::printf("speedup: %10.2fx, memory: %.0fx less\n",
+	            dense_time / packed_time,
+	            dense_bytes / packed_bytes);
+	return 0;
+}
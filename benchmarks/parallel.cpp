@@ -0,0 +1,45 @@
+// Scaling of the parallel `Automaton::step` on a 4096x4096 Game of Life
+// grid, from one thread up to the amount of hardware threads.
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <thread>
+
+#include "game_of_life.hpp"
+
+using namespace gol;
+
+int main() {
+	constexpr size_t size        = 4096;
+	constexpr int    generations = 5;
+
+	GameOfLife                  life(size, size);
+	std::mt19937                rng(42);
+	std::bernoulli_distribution alive(0.3);
+	for (size_t x = 0; x < size; ++x) {
+		for (size_t y = 0; y < size; ++y) {
+			life(x, y) = alive(rng) ? State::Alive : State::Dead;
+		}
+	}
+
+	const size_t max_threads = std::max(1U, std::thread::hardware_concurrency());
+	double       serial_time = 0;
+	std::printf("threads  ms/generation  speedup\n");
+	for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+		GameOfLife automaton = life;
+		automaton.set_threads(threads);
+
+		const auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < generations; ++i) { automaton.step(); }
+		const std::chrono::duration<double> elapsed =
+		    std::chrono::steady_clock::now() - start;
+
+		const double time = elapsed.count() / generations;
+		if (threads == 1) { serial_time = time; }
+		std::printf("%7zu  %13.3f  %7.2f\n",
+		            threads,
+		            time * 1e3,
+		            serial_time / time);
+	}
+	return 0;
+}
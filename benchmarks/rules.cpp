@@ -0,0 +1,66 @@
+// Steps a 4096x4096 random soup under rules given as strings, comparing the
+// specialized packed kernels against the runtime one and against the dense
+// lookup table step.
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+#include "cellular_rule.hpp"
+#include "life_like.hpp"
+#include "packed_game_of_life.hpp"
+
+namespace {
+template<typename Life>
+double seconds_per_generation(Life& automaton, const int generations) {
+	const auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < generations; ++i) { automaton.step(); }
+	const std::chrono::duration<double> elapsed =
+	    std::chrono::steady_clock::now() - start;
+	return elapsed.count() / generations;
+}
+} // namespace
+
+int main() {
+	constexpr size_t size = 4096;
+
+	std::printf("%zux%zu random soup, ms/generation\n", size, size);
+	std::printf("%-16s %10s %10s\n", "rule", "packed", "dense");
+	// Life and HighLife have specializations, the others run through the
+	// runtime packed kernel.
+	for (const char* rule :
+	     {"B3/S23", "B36/S23", "B3/S12345", "B368/S245", "B2/S/C3"}) {
+		const auto parsed = cellular::LifeLikeRule::parse(rule);
+
+		life_like::LifeLike         dense(size, size, parsed);
+		std::mt19937                rng(42);
+		std::bernoulli_distribution alive(0.3);
+		for (size_t x = 0; x < size; ++x) {
+			for (size_t y = 0; y < size; ++y) {
+				if (alive(rng)) { dense(x, y) = 1; }
+			}
+		}
+
+		double packed_time = 0;
+		if (parsed.states == 2) {
+			gol::PackedGameOfLife packed(size, size);
+			packed.set_rule(parsed);
+			for (size_t x = 0; x < size; ++x) {
+				for (size_t y = 0; y < size; ++y) {
+					if (dense(x, y)) { packed(x, y) = gol::State::Alive; }
+				}
+			}
+			packed_time = seconds_per_generation(packed, 50);
+		}
+		const double dense_time = seconds_per_generation(dense, 5);
+
+		if (parsed.states == 2) {
+			std::printf("%-16s %10.3f %10.3f\n",
+			            rule,
+			            packed_time * 1e3,
+			            dense_time * 1e3);
+		} else {
+			std::printf("%-16s %10s %10.3f\n", rule, "-", dense_time * 1e3);
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,59 @@
+// Throughput of the `CountRule` kernel for every instruction set the CPU
+// supports, on a 4096x4096 Game of Life grid.
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "cellular_simd.hpp"
+
+using namespace cellular;
+
+int main() {
+	constexpr size_t size        = 4096;
+	constexpr int    generations = 20;
+
+	const CountRule rule =
+	    CountRule::from(1, 2, [](const int state, const unsigned int count) {
+		    return count == 3 || (state == 1 && count == 2);
+	    });
+
+	std::vector<std::uint8_t>   grid(size * size);
+	std::mt19937                rng(42);
+	std::bernoulli_distribution alive(0.3);
+	for (auto& cell : grid) { cell = alive(rng); }
+	const std::vector<std::uint8_t> dead_line(size, 0);
+
+	constexpr simd::Isa isas[] = {simd::Isa::scalar,
+	                              simd::Isa::ssse3,
+	                              simd::Isa::avx2};
+	std::printf("isa     ns/cell\n");
+	for (const auto isa : isas) {
+		if (!simd::supported(isa)) { continue; }
+		std::vector<std::uint8_t> current = grid;
+		std::vector<std::uint8_t> next(size * size);
+
+		const auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < generations; ++i) {
+			for (size_t x = 0; x < size; ++x) {
+				simd::step_line(
+				    rule,
+				    x > 0 ? &current[(x - 1) * size] : dead_line.data(),
+				    &current[x * size],
+				    x + 1 < size ? &current[(x + 1) * size] : dead_line.data(),
+				    &next[x * size],
+				    size,
+				    isa);
+			}
+			current.swap(next);
+		}
+		const std::chrono::duration<double, std::nano> elapsed =
+		    std::chrono::steady_clock::now() - start;
+
+		const char* names[] = {"scalar", "ssse3", "avx2"};
+		std::printf("%-6s  %7.3f\n",
+		            names[static_cast<int>(isa)],
+		            elapsed.count() / generations / (size * size));
+	}
+	return 0;
+}
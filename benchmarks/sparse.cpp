@@ -0,0 +1,83 @@
+// Compares `GameOfLife` with the chunked `SparseAutomaton`: on a 1024x1024
+// soup that fills the grid, where chunking only costs, and on small soups
+// scattered over a plane that a dense grid would need gigabytes for.
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+#include "cellular_rule.hpp"
+#include "cellular_sparse.hpp"
+#include "game_of_life.hpp"
+
+using namespace gol;
+
+using SparseLife = SparseAutomaton<State>;
+
+template<typename Life>
+double seconds_per_generation(Life& automaton, const int generations) {
+	const auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < generations; ++i) { automaton.step(); }
+	const std::chrono::duration<double> elapsed =
+	    std::chrono::steady_clock::now() - start;
+	return elapsed.count() / generations;
+}
+
+void fill(GameOfLife& dense, std::mt19937& rng) {
+	std::bernoulli_distribution alive(0.3);
+	for (size_t x = 0; x < dense.width(); ++x) {
+		for (size_t y = 0; y < dense.height(); ++y) {
+			dense(x, y) = alive(rng) ? State::Alive : State::Dead;
+		}
+	}
+}
+
+/// Both keep a current and a next buffer.
+double sparse_mib(const SparseLife& sparse) {
+	return 2.0 * sparse.chunk_count() * SparseLife::chunk_size
+	       * SparseLife::chunk_size / (1 << 20);
+}
+
+int main() {
+	std::mt19937 rng(42);
+
+	constexpr size_t size = 1024;
+	GameOfLife       dense(size, size);
+	fill(dense, rng);
+	SparseLife full(rules::life.count_rule());
+	full.assign(dense);
+	const double dense_time = seconds_per_generation(dense, 20);
+	const double full_time  = seconds_per_generation(full, 20);
+	std::printf("%zux%zu random soup\n", size, size);
+	std::printf("dense:   %10.3f ms/generation %8.1f MiB\n",
+	            dense_time * 1e3,
+	            2.0 * size * size / (1 << 20));
+	std::printf("sparse:  %10.3f ms/generation %8.1f MiB\n",
+	            full_time * 1e3,
+	            sparse_mib(full));
+
+	// 64 soups of 64x64 cells, spread over a 65536x65536 plane.
+	constexpr std::int64_t             plane = 65536;
+	constexpr int                      soups = 64;
+	GameOfLife                         soup(64, 64);
+	SparseLife                         spread(rules::life.count_rule());
+	std::uniform_int_distribution<int> place(-plane / 2, plane / 2 - 64);
+	for (int i = 0; i < soups; ++i) {
+		fill(soup, rng);
+		spread.assign(soup, place(rng), place(rng));
+	}
+	// Let the soups burn down first, most of their area dies within that.
+	spread.step(100);
+	const double spread_time = seconds_per_generation(spread, 200);
+	std::printf("%d 64x64 soups on a %lldx%lld plane\n",
+	            soups,
+	            static_cast<long long>(plane),
+	            static_cast<long long>(plane));
+	std::printf("dense:   %10s                %8.1f MiB\n",
+	            "-",
+	            2.0 * plane * plane / (1 << 20));
+	std::printf("sparse:  %10.3f ms/generation %8.1f MiB, %zu chunks\n",
+	            spread_time * 1e3,
+	            sparse_mib(spread),
+	            spread.chunk_count());
+	return 0;
+}
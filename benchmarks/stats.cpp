@@ -0,0 +1,48 @@
+// Cost of the per-generation statistics: a 2048x2048 Game of Life soup
+// stepped with and without an observer registered.
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+#include "cellular_stats.hpp"
+#include "game_of_life.hpp"
+
+using namespace gol;
+
+namespace {
+double seconds_per_generation(GameOfLife& automaton, const int generations) {
+	const auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < generations; ++i) { automaton.step(); }
+	const std::chrono::duration<double> elapsed =
+	    std::chrono::steady_clock::now() - start;
+	return elapsed.count() / generations;
+}
+} // namespace
+
+int main() {
+	constexpr size_t size        = 2048;
+	constexpr int    generations = 20;
+
+	GameOfLife                  plain(size, size);
+	std::mt19937                rng(42);
+	std::bernoulli_distribution alive(0.3);
+	for (size_t x = 0; x < size; ++x) {
+		for (size_t y = 0; y < size; ++y) {
+			plain(x, y) = alive(rng) ? State::Alive : State::Dead;
+		}
+	}
+	GameOfLife observed = plain;
+	StatsLog   log({"dead", "alive"});
+	observed.add_observer(log.observer());
+	// The first observed step counts the population from scratch.
+	observed.step();
+
+	const double plain_time    = seconds_per_generation(plain, generations);
+	const double observed_time = seconds_per_generation(observed, generations);
+	std::printf("%zux%zu random soup\n", size, size);
+	std::printf("plain:    %8.3f ms/generation\n", plain_time * 1e3);
+	std::printf("observed: %8.3f ms/generation, %+.1f%%\n",
+	            observed_time * 1e3,
+	            (observed_time / plain_time - 1) * 100);
+	return 0;
+}
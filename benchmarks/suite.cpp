@@ -0,0 +1,369 @@
+// Standard workloads for `GameOfLife` and `Wireworld` at a range of grid
+// sizes, plus thread scaling curves. Prints a table and optionally writes the
+// results as JSON or CSV, for comparing releases.
+//
+// Usage: suite [--sizes 64,256,...] [--threads N] [--scaling-size N]
+//              [--workloads name,...] [--json PATH] [--csv PATH]
+//
+// Peak RSS is the process-wide high-water mark at the end of a run. Runs go
+// from small to large grids, so it tracks the largest grid so far.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __unix__
+#include <sys/resource.h>
+#endif
+
+#include "game_of_life.hpp"
+#include "wireworld.hpp"
+
+namespace {
+/// A pattern, line by line in the automaton's own characters.
+using Pattern = std::vector<std::string>;
+
+const Pattern gosper_glider_gun{
+    "************************#***********",
+    "**********************#*#***********",
+    "************##******##************##",
+    "***********#***#****##************##",
+    "##********#*****#***##**************",
+    "##********#***#*##****#*#***********",
+    "**********#*****#*******#***********",
+    "***********#***#********************",
+    "************##**********************",
+};
+
+const Pattern r_pentomino{
+    "*##",
+    "##*",
+    "*#*",
+};
+
+// A loop that an electron runs around, sending a copy down the wire on its
+// right every 10 generations.
+const Pattern wireworld_clock{
+    " o*##",
+    "#    ###################################################",
+    " ####",
+};
+
+// The same clock feeding a chain of diodes.
+const Pattern wireworld_diodes{
+    " o*##      ##        ##        ##        ##",
+    "#    ##### ######### ######### ######### ########",
+    " ####      ##        ##        ##        ##",
+};
+
+template<typename Automaton>
+void stamp(Automaton&     automaton,
+           const Pattern& pattern,
+           const size_t   left,
+           const size_t   top) {
+	for (size_t y = 0; y < pattern.size(); ++y) {
+		for (size_t x = 0; x < pattern[y].size(); ++x) {
+			if (left + x < automaton.width() && top + y < automaton.height()) {
+				automaton(left + x, top + y) =
+				    automaton.char_to_state(pattern[y][x]);
+			}
+		}
+	}
+}
+
+/// Copies of `pattern` every `spacing` cells in both directions.
+template<typename Automaton>
+void tile(Automaton& automaton, const Pattern& pattern, const size_t spacing) {
+	for (size_t x = 0; x < automaton.width(); x += spacing) {
+		for (size_t y = 0; y < automaton.height(); y += spacing) {
+			stamp(automaton, pattern, x, y);
+		}
+	}
+}
+
+/// Random cells, alive with probability `density`.
+auto soup(const double density) {
+	return [density](gol::GameOfLife& automaton) {
+		std::mt19937                rng(42);
+		std::bernoulli_distribution alive(density);
+		for (size_t x = 0; x < automaton.width(); ++x) {
+			for (size_t y = 0; y < automaton.height(); ++y) {
+				if (alive(rng)) { automaton(x, y) = gol::State::Alive; }
+			}
+		}
+	};
+}
+
+/// Steps a workload by the given amount of generations.
+using Stepper = std::function<void(size_t)>;
+
+struct Workload {
+	std::string name;
+	std::string automaton;
+	/// Mostly empty workloads, which also run with activity tracking.
+	bool sparse;
+	/// Build the workload on a `size`x`size` grid, stepped by `threads`
+	/// threads, with activity tracking if `track` is true.
+	std::function<Stepper(size_t size, size_t threads, bool track)> make;
+};
+
+/// `Workload::make` for an `Automaton` that `setup` fills in.
+template<typename Automaton, typename Setup>
+auto make(Setup setup) {
+	return [setup](const size_t size, const size_t threads, const bool track) {
+		auto automaton = std::make_shared<Automaton>(size, size);
+		setup(*automaton);
+		automaton->set_threads(threads);
+		automaton->set_activity_tracking(track);
+		return Stepper([automaton](const size_t generations) {
+			for (size_t i = 0; i < generations; ++i) { automaton->step(); }
+		});
+	};
+}
+
+std::vector<Workload> workloads() {
+	using gol::GameOfLife;
+	using wireworld::Wireworld;
+	return {
+	    {"soup-10", "GameOfLife", false, make<GameOfLife>(soup(0.1))},
+	    {"soup-30", "GameOfLife", false, make<GameOfLife>(soup(0.3))},
+	    {"soup-50", "GameOfLife", false, make<GameOfLife>(soup(0.5))},
+	    {"glider-guns",
+	     "GameOfLife",
+	     false,
+	     make<GameOfLife>([](GameOfLife& automaton) {
+		     tile(automaton, gosper_glider_gun, 64);
+	     })},
+	    {"r-pentomino",
+	     "GameOfLife",
+	     true,
+	     make<GameOfLife>([](GameOfLife& automaton) {
+		     stamp(automaton,
+		           r_pentomino,
+		           automaton.width() / 2,
+		           automaton.height() / 2);
+	     })},
+	    {"clocks",
+	     "Wireworld",
+	     true,
+	     make<Wireworld>([](Wireworld& automaton) {
+		     tile(automaton, wireworld_clock, 64);
+	     })},
+	    {"diodes",
+	     "Wireworld",
+	     true,
+	     make<Wireworld>([](Wireworld& automaton) {
+		     tile(automaton, wireworld_diodes, 64);
+	     })},
+	};
+}
+
+struct Result {
+	std::string workload;
+	std::string automaton;
+	size_t      size;
+	size_t      threads;
+	bool        tracked;
+	size_t      generations;
+	double      seconds;
+	long        peak_rss_kib;
+
+	double cells_per_second() const {
+		return static_cast<double>(size * size) * generations / seconds;
+	}
+	double ns_per_cell() const { return 1e9 / cells_per_second(); }
+};
+
+/// Peak resident set size of the process in KiB, or -1 if unknown.
+long peak_rss_kib() {
+#ifdef __unix__
+	rusage usage{};
+	if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+		return usage.ru_maxrss / 1024;
+#else
+		return usage.ru_maxrss;
+#endif
+	}
+#endif
+	return -1;
+}
+
+Result run(const Workload& workload,
+           const size_t    size,
+           const size_t    threads,
+           const bool      track) {
+	// Enough generations for around 2^26 cell updates, so small grids aren't
+	// dominated by timer resolution and large ones don't take forever.
+	const size_t generations =
+	    std::clamp<size_t>((size_t{1} << 26) / (size * size), 1, 1000);
+
+	const Stepper step = workload.make(size, threads, track);
+	step(1);
+	const auto start = std::chrono::steady_clock::now();
+	step(generations);
+	const std::chrono::duration<double> elapsed =
+	    std::chrono::steady_clock::now() - start;
+
+	return {workload.name,
+	        workload.automaton,
+	        size,
+	        threads,
+	        track,
+	        generations,
+	        elapsed.count(),
+	        peak_rss_kib()};
+}
+
+void print_header() {
+	std::printf("%-12s %-10s %6s %7s %7s %5s %12s %8s %9s\n",
+	            "workload",
+	            "automaton",
+	            "size",
+	            "threads",
+	            "tracked",
+	            "gens",
+	            "Mcells/s",
+	            "ns/cell",
+	            "RSS MiB");
+}
+
+void print(const Result& result) {
+	std::printf("%-12s %-10s %6zu %7zu %7s %5zu %12.1f %8.3f %9.1f\n",
+	            result.workload.c_str(),
+	            result.automaton.c_str(),
+	            result.size,
+	            result.threads,
+	            result.tracked ? "yes" : "no",
+	            result.generations,
+	            result.cells_per_second() / 1e6,
+	            result.ns_per_cell(),
+	            result.peak_rss_kib / 1024.0);
+}
+
+void write_json(const std::string& path, const std::vector<Result>& results) {
+	std::ofstream out(path);
+	out << "{\n  \"hardware_threads\": " << std::thread::hardware_concurrency()
+	    << ",\n  \"results\": [";
+	for (size_t i = 0; i < results.size(); ++i) {
+		const Result& result = results[i];
+		out << (i == 0 ? "\n" : ",\n") << "    {\"workload\": \""
+		    << result.workload << "\", \"automaton\": \"" << result.automaton
+		    << "\", \"size\": " << result.size
+		    << ", \"threads\": " << result.threads
+		    << ", \"tracked\": " << (result.tracked ? "true" : "false")
+		    << ", \"generations\": " << result.generations
+		    << ", \"seconds\": " << result.seconds
+		    << ", \"cells_per_second\": " << result.cells_per_second()
+		    << ", \"ns_per_cell\": " << result.ns_per_cell()
+		    << ", \"peak_rss_kib\": " << result.peak_rss_kib << "}";
+	}
+	out << "\n  ]\n}\n";
+}
+
+void write_csv(const std::string& path, const std::vector<Result>& results) {
+	std::ofstream out(path);
+	out << "workload,automaton,size,threads,tracked,generations,seconds,"
+	       "cells_per_second,ns_per_cell,peak_rss_kib\n";
+	for (const Result& result : results) {
+		out << result.workload << ',' << result.automaton << ','
+		    << result.size << ',' << result.threads << ','
+		    << (result.tracked ? 1 : 0) << ',' << result.generations << ','
+		    << result.seconds << ',' << result.cells_per_second() << ','
+		    << result.ns_per_cell() << ',' << result.peak_rss_kib << '\n';
+	}
+}
+
+std::vector<std::string> split(const std::string& list) {
+	std::vector<std::string> ret;
+	std::stringstream        stream(list);
+	for (std::string item; std::getline(stream, item, ',');) {
+		ret.push_back(item);
+	}
+	return ret;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+	std::vector<size_t> sizes{64, 256, 1024, 4096, 16384};
+	size_t threads = std::max(1U, std::thread::hardware_concurrency());
+	size_t scaling_size = 2048;
+	std::vector<std::string> names;
+	std::string              json_path;
+	std::string              csv_path;
+
+	try {
+		for (int i = 1; i < argc; ++i) {
+			const std::string option = argv[i];
+			if (i + 1 == argc) {
+				throw std::invalid_argument("missing value for " + option);
+			}
+			const std::string value = argv[++i];
+			if (option == "--sizes") {
+				sizes.clear();
+				for (const auto& size : split(value)) {
+					sizes.push_back(std::stoul(size));
+				}
+			} else if (option == "--threads") {
+				threads = std::stoul(value);
+			} else if (option == "--scaling-size") {
+				scaling_size = std::stoul(value);
+			} else if (option == "--workloads") {
+				names = split(value);
+			} else if (option == "--json") {
+				json_path = value;
+			} else if (option == "--csv") {
+				csv_path = value;
+			} else {
+				throw std::invalid_argument("unknown option " + option);
+			}
+		}
+	} catch (const std::exception& error) {
+		std::fprintf(stderr, "suite: %s\n", error.what());
+		return 1;
+	}
+
+	std::vector<Workload> selected;
+	for (Workload& workload : workloads()) {
+		if (names.empty()
+		    || std::find(names.begin(), names.end(), workload.name)
+		           != names.end()) {
+			selected.push_back(std::move(workload));
+		}
+	}
+	std::sort(sizes.begin(), sizes.end());
+
+	std::vector<Result> results;
+	print_header();
+	for (const size_t size : sizes) {
+		for (const Workload& workload : selected) {
+			for (const bool track : {false, true}) {
+				if (track && !workload.sparse) { continue; }
+				results.push_back(run(workload, size, threads, track));
+				print(results.back());
+			}
+		}
+	}
+
+	std::printf("\nscaling at %zux%zu\n", scaling_size, scaling_size);
+	print_header();
+	for (const Workload& workload : selected) {
+		for (size_t count = 1;; count = std::min(count * 2, threads)) {
+			results.push_back(run(workload, scaling_size, count, false));
+			print(results.back());
+			if (count == threads) { break; }
+		}
+	}
+
+	if (!json_path.empty()) { write_json(json_path, results); }
+	if (!csv_path.empty()) { write_csv(csv_path, results); }
+	return 0;
+}
@@ -0,0 +1,60 @@
+// Dense against event driven Wireworld on a circuit shaped like the large
+// Wireworld computers: millions of conductor cells with a few thousand
+// electrons on them. The circuit is 1024 wires of 4096 cells, wrapped into
+// loops by a toroidal boundary, with 4 electrons on each. The size can be
+// given as the first argument.
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include "event_wireworld.hpp"
+#include "wireworld.hpp"
+
+using namespace wireworld;
+
+namespace {
+double seconds_since(const std::chrono::steady_clock::time_point start) {
+	const std::chrono::duration<double> elapsed =
+	    std::chrono::steady_clock::now() - start;
+	return elapsed.count();
+}
+} // namespace
+
+int main(int argc, char** argv) {
+	const size_t size = argc > 1 ? std::stoul(argv[1]) : 4096;
+
+	Wireworld dense(size, size);
+	dense.set_boundary(Boundary::toroidal);
+	for (size_t y = 0; y < size; y += 4) {
+		for (size_t x = 0; x < size; ++x) {
+			dense(x, y) = x % 1024 == 0   ? State::ElectronHead
+			              : x % 1024 == 1 ? State::ElectronTail
+			                              : State::Conductor;
+		}
+	}
+
+	auto           start = std::chrono::steady_clock::now();
+	EventWireworld events(dense);
+	const double   build = seconds_since(start);
+
+	constexpr int dense_generations = 10;
+	start                           = std::chrono::steady_clock::now();
+	dense.step(dense_generations);
+	const double dense_time = seconds_since(start) / dense_generations;
+
+	constexpr int event_generations = 10000;
+	start                           = std::chrono::steady_clock::now();
+	events.step(event_generations);
+	const double event_time = seconds_since(start) / event_generations;
+
+	std::printf("%zux%zu grid, %zu cells, %zu electrons\n",
+	            size,
+	            size,
+	            events.cell_count(),
+	            events.head_count());
+	std::printf("graph built in %.3f s\n", build);
+	std::printf("dense:   %10.3f ms/generation\n", dense_time * 1e3);
+	std::printf("events:  %10.3f ms/generation\n", event_time * 1e3);
+	std::printf("speedup: %10.0fx\n", dense_time / event_time);
+	return 0;
+}
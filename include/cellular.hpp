@@ -2,42 +2,393 @@
 #define CELLULAR_HPP_
 
 #include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
 #include <filesystem>
-#include <fstream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "cellular_checkpoint.hpp"
+#include "cellular_hash.hpp"
+#include "cellular_io.hpp"
+#include "cellular_layout.hpp"
+#include "cellular_simd.hpp"
+#include "cellular_stats.hpp"
+#include "cellular_thread_pool.hpp"
 #include "experimental/mdspan"
 
 namespace stdex = std::experimental;
 namespace cellular {
 
+/// Compile-time indices into a `Neighborhood`. The von Neumann directions
+/// come first, so a von Neumann view is a prefix of a Moore view.
+namespace direction {
+	enum : size_t { n, e, s, w, ne, nw, se, sw };
+	/// The outer ring of the extended von Neumann neighborhood.
+	enum : size_t { n2 = 4, e2, s2, w2 };
+} // namespace direction
+
+template<typename StateType, typename Layout = stdex::layout_right>
+class Automaton;
+
+/// What the cells just past the edges of the grid are.
+enum class Boundary {
+	/// Cells off the edge don't exist, they're left out of neighborhoods and
+	/// read as the default state.
+	dead,
+	/// The grid wraps around, so the left edge neighbors the right one and
+	/// the top edge the bottom one.
+	toroidal,
+	/// The grid is mirrored at its edges, so the cell one past an edge is the
+	/// edge cell itself, the one two past it is the cell next to it, etc.
+	reflective,
+};
+
+/// A stack-resident, fixed-arity view of the cells around a given cell.
+/// Cells that fall off the edge of the grid read as the default state and
+/// are excluded from `size()` and `count()`.
+template<typename StateType, size_t N>
+class Neighborhood {
+	static_assert(N <= 16, "a neighborhood can hold at most 16 cells");
+
+public:
+	static constexpr size_t arity = N;
+
+	constexpr StateType operator[](const size_t dir) const {
+		return m_cells[dir];
+	}
+	template<size_t Dir>
+	constexpr StateType get() const {
+		static_assert(Dir < N, "direction out of range");
+		return m_cells[Dir];
+	}
+	constexpr bool exists(const size_t dir) const {
+		return (m_present >> dir) & 1U;
+	}
+	/// Amount of cells in the neighborhood that are inside the grid.
+	constexpr unsigned int size() const {
+		unsigned int ret = 0;
+		for (size_t i = 0; i < N; ++i) { ret += exists(i); }
+		return ret;
+	}
+	/// Amount of cells in the neighborhood that are in state `state`.
+	constexpr unsigned int count(const StateType state) const {
+		unsigned int ret = 0;
+		for (size_t i = 0; i < N; ++i) {
+			ret += exists(i) && m_cells[i] == state;
+		}
+		return ret;
+	}
+
+private:
+	template<typename, typename>
+	friend class Automaton;
+
+	inline void set(const size_t dir, const StateType state) {
+		m_cells[dir] = state;
+		m_present |= static_cast<std::uint16_t>(1U << dir);
+	}
+
+	std::array<StateType, N> m_cells{};
+	std::uint16_t            m_present = 0;
+};
+
 template<typename StateType>
+using VonNeumannNeighborhood = Neighborhood<StateType, 4>;
+template<typename StateType>
+using MooreNeighborhood = Neighborhood<StateType, 8>;
+template<typename StateType>
+using ExtendedVonNeumannNeighborhood = Neighborhood<StateType, 8>;
+
+namespace detail {
+	/// Where the cell `i` cells from the start of an axis of `size` cells
+	/// comes from under `boundary`, or -1 if it's off the grid and dead.
+	/// Every engine with a `Boundary` maps its edges through this, so they
+	/// agree with each other.
+	inline std::ptrdiff_t halo_source(std::ptrdiff_t       i,
+	                                  const std::ptrdiff_t size,
+	                                  const Boundary       boundary) {
+		if (i >= 0 && i < size) { return i; }
+		switch (boundary) {
+		case Boundary::dead: {
+			return -1;
+		}
+		case Boundary::toroidal: {
+			return (i % size + size) % size;
+		}
+		case Boundary::reflective: {
+			// Mirror, and clamp for axes that are narrower than the halo.
+			if (i < 0) { i = -1 - i; }
+			if (i >= size) { i = 2 * size - 1 - i; }
+			return std::clamp<std::ptrdiff_t>(i, 0, size - 1);
+		}
+		}
+		return -1;
+	}
+
+	/// Cells stored in a vector, with an `mdspan` over it that facilitates
+	/// convenient 2D access. Copies point their `mdspan` at their own vector.
+	///
+	/// The grid is surrounded by a halo of `halo` cells on every side, which
+	/// `fill_halo` fills according to a `Boundary`. Coordinates in the halo
+	/// are negative, or past the width or height, and since the unsigned
+	/// arithmetic wraps around `x - 1` with `x` being 0 works.
+	template<typename StateType, typename Layout = stdex::layout_right>
+	class GridStorage {
+		using Extents =
+		    stdex::extents<stdex::dynamic_extent, stdex::dynamic_extent>;
+		using Grid    = stdex::basic_mdspan<StateType, Extents, Layout>;
+		using Mapping = typename Grid::mapping_type;
+
+	public:
+		inline GridStorage(const size_t width,
+		                   const size_t height,
+		                   const size_t halo) :
+		    GridStorage(halo,
+		                Mapping(Extents(width + 2 * halo,
+		                                height + 2 * halo))) {}
+		/// A grid in the `size` cells at `cells`, laid out like the grid and
+		/// its halo, instead of a buffer of its own. `cells` is kept alive
+		/// for as long as the grid uses it.
+		inline GridStorage(const size_t               width,
+		                   const size_t               height,
+		                   const size_t               halo,
+		                   std::shared_ptr<StateType> cells,
+		                   const size_t               size) :
+		    m_halo(halo),
+		    m_external(std::move(cells)),
+		    m_grid(m_external.get(),
+		           Mapping(Extents(width + 2 * halo, height + 2 * halo))) {
+			if (span_size() > size) {
+				throw std::invalid_argument("the cells don't fill the grid");
+			}
+		}
+		// Copies always get a buffer of their own.
+		inline GridStorage(const GridStorage& other) :
+		    m_halo(other.m_halo),
+		    m_cells(other.data(), other.data() + other.span_size()),
+		    m_grid(m_cells.data(), other.m_grid.mapping()) {}
+		inline GridStorage& operator=(const GridStorage& other) {
+			if (this == &other) { return *this; }
+			m_halo = other.m_halo;
+			m_cells.assign(other.data(), other.data() + other.span_size());
+			m_external.reset();
+			m_grid = Grid(m_cells.data(), other.m_grid.mapping());
+			return *this;
+		}
+		// Moving a vector keeps its buffer, so the `mdspan` stays valid.
+		inline GridStorage(GridStorage&& other) noexcept = default;
+		inline GridStorage& operator=(GridStorage&& other) noexcept = default;
+		/// Exchange buffers with `other` without copying any cells.
+		inline void swap(GridStorage& other) noexcept {
+			std::swap(m_halo, other.m_halo);
+			m_cells.swap(other.m_cells);
+			m_external.swap(other.m_external);
+			std::swap(m_grid, other.m_grid);
+		}
+
+		/// The whole buffer, halo and any padding the layout adds included.
+		inline StateType* data() const { return m_grid.data(); }
+		inline size_t     span_size() const {
+			return static_cast<size_t>(m_grid.mapping().required_span_size());
+		}
+
+		inline StateType& operator()(const size_t x, const size_t y) const {
+			return m_grid(x + m_halo, y + m_halo);
+		}
+		inline size_t width() const { return m_grid.extent(0) - 2 * m_halo; }
+		inline size_t height() const { return m_grid.extent(1) - 2 * m_halo; }
+
+		/// Fill the halo according to `boundary`.
+		inline void fill_halo(const Boundary boundary) {
+			const auto w = static_cast<std::ptrdiff_t>(width());
+			const auto h = static_cast<std::ptrdiff_t>(height());
+			const auto r = static_cast<std::ptrdiff_t>(m_halo);
+			auto cell = [this](const std::ptrdiff_t x, const std::ptrdiff_t y)
+			    -> StateType& {
+				return (*this)(static_cast<size_t>(x), static_cast<size_t>(y));
+			};
+
+			// The lines on the left and right first, then the top and bottom
+			// of every line including those, which fills in the corners.
+			for (std::ptrdiff_t x = -r; x < w + r; ++x) {
+				if (x == 0) { x = w; }
+				const std::ptrdiff_t sx = halo_source(x, w, boundary);
+				for (std::ptrdiff_t y = 0; y < h; ++y) {
+					cell(x, y) = sx < 0 ? StateType() : cell(sx, y);
+				}
+			}
+			for (std::ptrdiff_t x = -r; x < w + r; ++x) {
+				for (std::ptrdiff_t y = -r; y < h + r; ++y) {
+					if (y == 0) { y = h; }
+					const std::ptrdiff_t sy = halo_source(y, h, boundary);
+					cell(x, y) = sy < 0 ? StateType() : cell(x, sy);
+				}
+			}
+		}
+
+	private:
+		inline GridStorage(const size_t halo, const Mapping& mapping) :
+		    m_halo(halo),
+		    m_cells(mapping.required_span_size(), StateType()),
+		    m_grid(m_cells.data(), mapping) {}
+
+		size_t                     m_halo;
+		std::vector<StateType>     m_cells;
+		/// Cells owned by someone else, used instead of `m_cells` if set.
+		std::shared_ptr<StateType> m_external;
+		Grid                       m_grid;
+	};
+} // namespace detail
+
+/// Base class of the automata. `Layout` is the `mdspan` layout the grid is
+/// stored in, `step` walks the grid in the order that it lays cells out in
+/// (see `layout_traits`).
+template<typename StateType, typename Layout>
 class Automaton {
-	using Grid =
-	    stdex::mdspan<StateType, stdex::dynamic_extent, stdex::dynamic_extent>;
+	using Grid = detail::GridStorage<StateType, Layout>;
 
 public:
+	/// Cell returned by the non-const `operator()`. Reading it is the same as
+	/// reading through the const one, only assigning to it counts as a change
+	/// for activity tracking, hash tracking and the population.
+	class CellReference {
+	public:
+		inline           operator StateType() const;
+		inline CellReference& operator=(const StateType state);
+		inline CellReference& operator=(const CellReference& other);
+
+	private:
+		friend class Automaton;
+		inline CellReference(Automaton& automaton,
+		                     const size_t x,
+		                     const size_t y);
+
+		Automaton& m_automaton;
+		size_t     m_x;
+		size_t     m_y;
+	};
+
 	// Automaton of size x*y with all cells initialized to the default state
 	// (first in StateType enum)
 	inline Automaton(const size_t w, const size_t h);
-	inline Automaton(const std::filesystem::path& filename);
+	/// Automaton with the grid in `filename`, see `set_grid_from_file`. A
+	/// constructor can't call the `char_to_state` of the class deriving from
+	/// it, so the file is loaded the first time the grid is used instead,
+	/// which is also when errors loading it are thrown.
+	inline explicit Automaton(const std::filesystem::path& filename);
 	inline Automaton() = delete;
+	inline Automaton(const Automaton& other)            = default;
+	inline Automaton& operator=(const Automaton& other) = default;
+	inline Automaton(Automaton&& other)                 = default;
+	inline Automaton& operator=(Automaton&& other)      = default;
 	inline void             step();
+	/// Advance by `generations` generations. Same result as calling `step`
+	/// that many times, but automata with a `CountRule` run several
+	/// generations per cache-resident tile at once, unless observers or hash
+	/// tracking need every generation.
+	inline void             step(const size_t generations);
 	inline void             print();
-	inline StateType&       operator()(const size_t x, const size_t y);
+	inline CellReference    operator()(const size_t x, const size_t y);
 	inline const StateType& operator()(const size_t x, const size_t y) const;
 	inline size_t           width() const;
 	inline size_t           height() const;
+	/// Load the grid from a file in any of the `io::Format`s. The file is
+	/// memory-mapped and parsed in a single pass straight into the grid.
+	/// Plain text uses `char_to_state`, numbered states in the other formats
+	/// are converted to `StateType` in enum order. Throws
+	/// `std::invalid_argument` for numbered states the `CountRule` doesn't
+	/// have.
 	inline void set_grid_from_file(const std::filesystem::path& filename,
 	                               const char delimiter = '\n');
 	inline void set_grid_from_string(std::string&& str,
 	                                 const char    delimiter = '\n');
+	/// Amount of generations stepped since the grid was created, loaded or
+	/// restored.
+	inline size_t generation() const;
+	/// Write the grid, boundary and generation to `filename` in the binary
+	/// checkpoint format (see `io::CheckpointHeader`). Uncompressed cells are
+	/// written straight out of the grid's buffer.
+	inline void save_checkpoint(
+	    const std::filesystem::path& filename,
+	    const io::Compression        compression = io::Compression::none) const;
+	/// Resume from a checkpoint saved by an automaton with the same state
+	/// type and layout. An uncompressed checkpoint is mapped copy-on-write
+	/// and stepped from in place, so cells are only read from disk as they're
+	/// first needed and the file itself is never modified.
+	inline void restore_checkpoint(const std::filesystem::path& filename);
+	/// Step using a pool of `threads` threads owned by the automaton, or
+	/// serially if `threads` is 1.
+	inline void set_threads(const size_t threads);
+	/// Step using `pool`, which may be shared with other automata. Passing
+	/// `nullptr` makes stepping serial again.
+	inline void set_thread_pool(std::shared_ptr<ThreadPool> pool);
+	/// When enabled, `step` only re-evaluates the tiles of the grid that
+	/// changed in the last generation, or that neighbor one that did. Writes
+	/// through `operator()` count as changes, reads don't.
+	inline void set_activity_tracking(const bool enabled);
+	/// What the cells past the edges of the grid are, `Boundary::dead` by
+	/// default.
+	inline void     set_boundary(const Boundary boundary);
+	inline Boundary boundary() const;
+	/// Call `observer` with the statistics of every generation stepped from
+	/// now on. They're counted while the cells are computed, which slows
+	/// stepping down a little while any observer is registered, and
+	/// `step(generations)` runs one generation at a time. Returns a handle
+	/// for `remove_observer`. Observers are never called if `CELLULAR_STATS`
+	/// is 0.
+	inline size_t add_observer(StatsObserver observer);
+	inline void   remove_observer(const size_t handle);
+	/// Keep the grid's `hash` up to date while stepping, updating it only
+	/// for the cells that change, along with the hashes of the last
+	/// `history` generations. Writes through `operator()` make the next step
+	/// rehash the grid and start the history over.
+	inline void set_hash_tracking(const bool   enabled,
+	                              const size_t history = 64);
+	/// Zobrist hash of the grid, which only depends on its cells. Computed
+	/// from the whole grid unless hash tracking is enabled. States are
+	/// hashed by their bytes, and the all-default grid hashes to 0.
+	inline std::uint64_t hash() const;
+	/// Step until the grid repeats one of its last `max_period` generations,
+	/// or until `max_generations` generations passed. Repeats are found by
+	/// hash, so a hash collision could end it early, with odds of about one
+	/// in 2^64 per generation. Tracks the hash for the duration.
+	inline Stabilization run_until_stable(const size_t max_generations,
+	                                      const size_t max_period = 64);
 	inline virtual StateType cycle_state(
 	    const StateType current_cell) const = 0;
 
 protected:
+	inline VonNeumannNeighborhood<StateType> vn_view_at(const size_t x,
+	                                                    const size_t y) const;
+	inline MooreNeighborhood<StateType> moore_view_at(const size_t x,
+	                                                  const size_t y) const;
+	inline ExtendedVonNeumannNeighborhood<StateType> extended_vn_view_at(
+	    const size_t x,
+	    const size_t y) const;
+	// With a `Boundary` other than `Boundary::dead` every view is complete.
+	/// Amount of von Neumann neighbors of (x, y) that are in state `state`.
+	inline unsigned int count_vn(const size_t    x,
+	                             const size_t    y,
+	                             const StateType state) const;
+	/// Amount of Moore neighbors of (x, y) that are in state `state`.
+	inline unsigned int count_moore(const size_t    x,
+	                                const size_t    y,
+	                                const StateType state) const;
+
+	// Compatibility layer, these build a map out of the corresponding view.
+	// Prefer the `*_view_at` and `count_*` functions in new code.
 	inline const std::unordered_map<const char*, StateType>& vn_neighborhood_at(
 	    const size_t x,
 	    const size_t y);
@@ -45,109 +396,244 @@ protected:
 	moore_neighborhood_at(const size_t x, const size_t y);
 	inline const std::unordered_map<const char*, StateType>&
 	                         extended_vn_neighborhood_at(const size_t x, const size_t y);
-	inline unsigned int      neighbors();
+	/// Opt into the vectorized `step` by describing the rule as a table. The
+	/// table has to agree with `next_state`, and `StateType` has to be a
+	/// single byte. Layouts other than `layout_right` ignore the table.
+	inline void set_count_rule(const CountRule& rule);
+	/// Size of the last map returned by a `*_neighborhood_at` function on
+	/// this thread.
+	inline unsigned int neighbors();
+	/// Must only read the grid, `step` may call it concurrently for
+	/// different cells.
 	inline virtual StateType next_state(const StateType current_cell,
 	                                    const size_t    x,
 	                                    const size_t    y)           = 0;
+	/// Compute the next state of every cell with `x` in [`x_begin`, `x_end`)
+	/// and `y` in [`y_begin`, `y_end`) through `next_state`, counting into
+	/// `tally` unless it's null. Returns whether any of them changed. Only
+	/// called for automata without a `CountRule`, once per rect rather than
+	/// per cell, so `StaticAutomaton` overrides it with a loop that its rule
+	/// inlines into.
+	inline virtual bool evaluate_cells(const size_t       x_begin,
+	                                   const size_t       x_end,
+	                                   const size_t       y_begin,
+	                                   const size_t       y_end,
+	                                   detail::StepTally* tally);
+	/// `evaluate_cells` with `next(current_cell, x, y)` in place of
+	/// `next_state`.
+	template<typename Next>
+	inline bool evaluate_cells_with(const size_t       x_begin,
+	                                const size_t       x_end,
+	                                const size_t       y_begin,
+	                                const size_t       y_end,
+	                                detail::StepTally* tally,
+	                                Next&&             next);
 	inline virtual char      state_to_char(StateType state) const = 0;
 	inline virtual StateType char_to_state(char c) const          = 0;
 	inline virtual ~Automaton()                                   = default;
 
 private:
+	/// How far the grid's halo reaches, the widest neighborhood is the
+	/// extended von Neumann one.
+	static constexpr size_t halo = 2;
+	/// Whether lines of constant x are contiguous, which the vectorized code
+	/// paths rely on.
+	static constexpr bool contiguous_lines =
+	    std::is_same_v<Layout, stdex::layout_right>;
+	/// Side of the square tiles that activity is tracked in.
+	/// Lines are contiguous along y, so tiles are longer that way to keep
+	/// the spans the vectorized step works on long.
+	static constexpr size_t activity_tile_x = 16;
+	static constexpr size_t activity_tile_y = 256;
+
+	/// Side of the square tiles that `step(generations)` works in, and the
+	/// most generations it runs on a tile before writing it back.
+	static constexpr size_t block_tile  = 512;
+	static constexpr size_t block_depth = 16;
+
+	/// Whether the steps have to tally, for the observers or the hash.
+	inline bool tallied() const;
+	/// `step` without tallying.
+	inline void step_generation();
+	/// `step` with the step kernels tallying into `m_tally`.
+	inline void step_tallied();
+	/// `step` with activity tracking.
+	inline void step_active();
+	/// `step(generations)` through the `CountRule` kernel, `block_depth`
+	/// generations at a time.
+	inline void step_blocked(size_t generations);
+	/// Advance the tile with its corner at (`x_begin`, `y_begin`) by `depth`
+	/// generations into `m_next_grid`.
+	inline void step_block(const size_t x_begin,
+	                       const size_t y_begin,
+	                       const size_t depth);
+	/// Compute the next state of every cell with `x` in [`x_begin`, `x_end`)
+	/// and `y` in [`y_begin`, `y_end`). Returns whether any of them changed.
+	inline bool step_rect(const size_t x_begin,
+	                      const size_t x_end,
+	                      const size_t y_begin,
+	                      const size_t y_end);
+	/// `step_rect`, counting into `tally` unless it's null.
+	inline bool evaluate_rect(const size_t       x_begin,
+	                          const size_t       x_end,
+	                          const size_t       y_begin,
+	                          const size_t       y_end,
+	                          detail::StepTally* tally);
+	/// Whether a cell is on the grid or in the halo, for the views. The halo
+	/// only holds real cells for a boundary other than `Boundary::dead`.
+	inline bool exists(const size_t x, const size_t y) const;
+	/// `evaluate_rect` through the vectorized `CountRule` kernel.
+	inline bool evaluate_rect_simd(const size_t       x_begin,
+	                               const size_t       x_end,
+	                               const size_t       y_begin,
+	                               const size_t       y_end,
+	                               detail::StepTally* tally);
+	/// Run `task(i)` for every i in [0, `count`), on the pool if there is
+	/// one.
+	template<typename Function>
+	inline void parallel_for(const size_t count, Function&& task);
+	inline void reset_activity();
+	/// Shared by the `set_grid_from_*` functions.
+	inline void load(const std::string_view text, const char delimiter);
+	/// Load the file the automaton was constructed from, if that's still
+	/// pending. Everything public that reads the grid calls this first.
+	inline void load_pending() const;
+	inline void mark_changed(const size_t x, const size_t y);
+	/// Rehash the grid if it was written to since it was last hashed.
+	inline void          refresh_hash();
+	inline std::uint64_t full_hash() const;
+	static inline std::uint64_t cell_key(const size_t    x,
+	                                     const size_t    y,
+	                                     const StateType state);
+	/// How many generations back the current one repeats, looking at most
+	/// `max_period` back, or 0 if it doesn't.
+	inline size_t repeat_period(const size_t max_period) const;
+	/// Scratch map for the `*_neighborhood_at` functions, one per thread so
+	/// that `next_state` stays thread-safe.
+	static inline std::unordered_map<const char*, StateType>&
+	scratch_neighborhood();
+
 	/// Width starting from 0, so a 5x5 automaton would have a `m_width`
 	/// of 4.
 	size_t m_width;
 	/// Height starting from 0, so a 5x5 automaton would have a `m_height`
 	/// of 4.
 	size_t m_height;
-	/// The underlying vector where the current grid is stored.
-	std::vector<StateType> m_grid_vec;
-	/// The underlying vector where the next iteration of the grid is
-	/// stored.
-	std::vector<StateType> m_next_grid_vec;
-	/// The `mdspan` that facilitates convenient 2D access to `m_grid_vec`.
+	/// The file the grid still has to be loaded from, see `load_pending`.
+	std::optional<std::filesystem::path> m_pending_file;
+	/// The current grid.
 	Grid m_grid;
-	/// The `mdspan` that facilitates convenient 2D access to
-	/// `m_next_grid_vec`.
+	/// Where the next iteration of the grid is computed, swapped with
+	/// `m_grid` after every step.
 	Grid m_next_grid;
-	/// The map that stores the result of the `*_neighborhood_at` functions.
-	std::unordered_map<const char*, StateType> m_neighborhood;
+	/// The pool `step` splits the grid over, stepping is serial without one.
+	std::shared_ptr<ThreadPool> m_pool;
+	/// The rule as a table, if the automaton opted into the vectorized step.
+	std::optional<CountRule> m_count_rule;
+	/// A line of cells that are never counted, read in place of the lines off
+	/// the grid's edges by the vectorized step.
+	std::vector<std::uint8_t> m_uncounted_line;
+	bool                      m_track_activity = false;
+	Boundary                  m_boundary       = Boundary::dead;
+	size_t                    m_generation     = 0;
+	/// Amount of activity tiles along each axis.
+	size_t m_tiles_x = 0;
+	size_t m_tiles_y = 0;
+	/// Whether each tile changed in the last generation or was written to
+	/// since, indexed by `tile_x * m_tiles_y + tile_y`.
+	std::vector<bool> m_tile_changed;
+	/// The tiles set in `m_tile_changed`.
+	std::vector<size_t> m_changed_tiles;
+	/// The tiles the current step evaluates, and whether each changed.
+	std::vector<size_t> m_scheduled_tiles;
+	std::vector<char>   m_scheduled_changed;
+	/// The last step each tile was scheduled in, so it's scheduled once.
+	std::vector<std::uint32_t> m_tile_epoch;
+	std::uint32_t              m_epoch = 0;
+	/// Where the step kernels tally, only set during `step_tallied`.
+	detail::GenerationTally* m_tally = nullptr;
+	/// The hash, kept up to date by the steps while tracking it unless cells
+	/// were written to since.
+	bool          m_track_hash = false;
+	std::uint64_t m_hash       = 0;
+	bool          m_hash_stale = true;
+	/// The hashes of the last `m_hash_history` generations and the current
+	/// one, oldest first.
+	std::deque<std::uint64_t> m_hashes;
+	size_t                    m_hash_history = 0;
+#if CELLULAR_STATS
+	/// Registered observers and their handles, in registration order.
+	std::vector<std::pair<size_t, StatsObserver>> m_observers;
+	size_t                                        m_next_observer = 0;
+	/// Amount of cells in each state, kept up to date by the observed steps
+	/// unless cells were written to since.
+	std::array<size_t, 256> m_population{};
+	bool                    m_population_stale = true;
+#endif
 };
 
-template<typename StateType>
-inline Automaton<StateType>::Automaton(const size_t width,
-                                       const size_t height) :
+template<typename StateType, typename Layout>
+inline Automaton<StateType, Layout>::Automaton(const size_t width,
+                                               const size_t height) :
     m_width(width - 1),
     m_height(height - 1),
-    m_grid_vec(width * height, StateType()),
-    m_next_grid_vec(m_grid_vec),
-    m_grid(m_grid_vec.data(), width, height),
-    m_next_grid(m_next_grid_vec.data(), width, height) {
-	//   *
-	//  ***
-	// ** **
-	//  ***
-	//   *
-	m_neighborhood.reserve(12);
-}
+    m_grid(width, height, halo),
+    m_next_grid(m_grid) {}
 
-template<typename StateType>
-inline Automaton<StateType>::Automaton(const std::filesystem::path& filename) {
-	set_grid_from_file(filename);
-	m_neighborhood.reserve(12);
+template<typename StateType, typename Layout>
+inline Automaton<StateType, Layout>::Automaton(
+    const std::filesystem::path& filename) :
+    Automaton(1, 1) {
+	m_pending_file = filename;
 }
 
 //   *
 //  * *
 //   *
-template<typename StateType>
-inline const std::unordered_map<const char*, StateType>&
-Automaton<StateType>::vn_neighborhood_at(const size_t x, const size_t y) {
-	m_neighborhood.clear();
-	bool x_over_zero   = x > 0;
-	bool x_under_limit = x < m_width;
-	bool y_over_zero   = y > 0;
-	bool y_under_limit = y < m_height;
+template<typename StateType, typename Layout>
+inline VonNeumannNeighborhood<StateType>
+Automaton<StateType, Layout>::vn_view_at(const size_t x, const size_t y) const {
+	using namespace direction;
+	VonNeumannNeighborhood<StateType> ret;
 
-	if (x_over_zero) { m_neighborhood.emplace("w", m_grid(x - 1, y)); }
-	if (x_under_limit) { m_neighborhood.emplace("e", m_grid(x + 1, y)); }
-	if (y_over_zero) { m_neighborhood.emplace("n", m_grid(x, y - 1)); }
-	if (y_under_limit) { m_neighborhood.emplace("s", m_grid(x, y + 1)); }
+	if (exists(x, y - 1)) { ret.set(n, m_grid(x, y - 1)); }
+	if (exists(x + 1, y)) { ret.set(e, m_grid(x + 1, y)); }
+	if (exists(x, y + 1)) { ret.set(s, m_grid(x, y + 1)); }
+	if (exists(x - 1, y)) { ret.set(w, m_grid(x - 1, y)); }
 
-	return m_neighborhood;
+	return ret;
 }
 
 //  ***
 //  * *
 //  ***
-template<typename StateType>
-inline const std::unordered_map<const char*, StateType>&
-Automaton<StateType>::moore_neighborhood_at(const size_t x, const size_t y) {
-	m_neighborhood.clear();
-	bool x_over_zero   = x > 0;
-	bool x_under_limit = x < m_width;
-	bool y_over_zero   = y > 0;
-	bool y_under_limit = y < m_height;
-
-	if (x_over_zero) { m_neighborhood.emplace("w", m_grid(x - 1, y)); }
-	if (x_under_limit) { m_neighborhood.emplace("e", m_grid(x + 1, y)); }
-	if (y_over_zero) { m_neighborhood.emplace("n", m_grid(x, y - 1)); }
-	if (y_under_limit) { m_neighborhood.emplace("s", m_grid(x, y + 1)); }
+template<typename StateType, typename Layout>
+inline MooreNeighborhood<StateType>
+Automaton<StateType, Layout>::moore_view_at(const size_t x,
+                                            const size_t y) const {
+	using namespace direction;
+	MooreNeighborhood<StateType> ret;
+	const bool complete      = m_boundary != Boundary::dead;
+	const bool x_over_zero   = complete || x > 0;
+	const bool x_under_limit = complete || x < m_width;
+	const bool y_over_zero   = complete || y > 0;
+	const bool y_under_limit = complete || y < m_height;
+
+	if (y_over_zero) { ret.set(n, m_grid(x, y - 1)); }
+	if (x_under_limit) { ret.set(e, m_grid(x + 1, y)); }
+	if (y_under_limit) { ret.set(s, m_grid(x, y + 1)); }
+	if (x_over_zero) { ret.set(w, m_grid(x - 1, y)); }
 
 	if (y_over_zero) {
-		if (x_under_limit) {
-			m_neighborhood.emplace("ne", m_grid(x + 1, y - 1));
-		}
-		if (x_over_zero) { m_neighborhood.emplace("nw", m_grid(x - 1, y - 1)); }
+		if (x_under_limit) { ret.set(ne, m_grid(x + 1, y - 1)); }
+		if (x_over_zero) { ret.set(nw, m_grid(x - 1, y - 1)); }
 	}
 	if (y_under_limit) {
-		if (x_under_limit) {
-			m_neighborhood.emplace("se", m_grid(x + 1, y + 1));
-		}
-		if (x_over_zero) { m_neighborhood.emplace("sw", m_grid(x - 1, y + 1)); }
+		if (x_under_limit) { ret.set(se, m_grid(x + 1, y + 1)); }
+		if (x_over_zero) { ret.set(sw, m_grid(x - 1, y + 1)); }
 	}
 
-	return m_neighborhood;
+	return ret;
 }
 
 //   *
@@ -155,101 +641,982 @@ Automaton<StateType>::moore_neighborhood_at(const size_t x, const size_t y) {
 // ** **
 //   *
 //   *
-template<typename StateType>
+template<typename StateType, typename Layout>
+inline ExtendedVonNeumannNeighborhood<StateType>
+Automaton<StateType, Layout>::extended_vn_view_at(const size_t x,
+                                                  const size_t y) const {
+	using namespace direction;
+	ExtendedVonNeumannNeighborhood<StateType> ret;
+	const auto                                inner = vn_view_at(x, y);
+	for (size_t dir = n; dir <= w; ++dir) {
+		if (inner.exists(dir)) { ret.set(dir, inner[dir]); }
+	}
+
+	if (exists(x, y - 2)) { ret.set(n2, m_grid(x, y - 2)); }
+	if (exists(x + 2, y)) { ret.set(e2, m_grid(x + 2, y)); }
+	if (exists(x, y + 2)) { ret.set(s2, m_grid(x, y + 2)); }
+	if (exists(x - 2, y)) { ret.set(w2, m_grid(x - 2, y)); }
+
+	return ret;
+}
+
+template<typename T, typename L>
+inline bool Automaton<T, L>::exists(const size_t x, const size_t y) const {
+	// Coordinates left of or above the grid wrapped around, so they're
+	// past the width or height too.
+	return m_boundary != Boundary::dead || (x <= m_width && y <= m_height);
+}
+
+template<typename T, typename L>
+inline unsigned int Automaton<T, L>::count_vn(const size_t x,
+                                              const size_t y,
+                                              const T      state) const {
+	// The halo holds the default state for `Boundary::dead`, so it can be
+	// read like any other cell unless that's the state being counted.
+	if (m_boundary != Boundary::dead || state != T()
+	    || (x > 0 && x < m_width && y > 0 && y < m_height)) {
+		return (m_grid(x, y - 1) == state) + (m_grid(x + 1, y) == state)
+		       + (m_grid(x, y + 1) == state) + (m_grid(x - 1, y) == state);
+	}
+	return vn_view_at(x, y).count(state);
+}
+
+template<typename T, typename L>
+inline unsigned int Automaton<T, L>::count_moore(const size_t x,
+                                                 const size_t y,
+                                                 const T      state) const {
+	if (m_boundary != Boundary::dead || state != T()
+	    || (x > 0 && x < m_width && y > 0 && y < m_height)) {
+		return (m_grid(x - 1, y - 1) == state) + (m_grid(x, y - 1) == state)
+		       + (m_grid(x + 1, y - 1) == state) + (m_grid(x - 1, y) == state)
+		       + (m_grid(x + 1, y) == state) + (m_grid(x - 1, y + 1) == state)
+		       + (m_grid(x, y + 1) == state) + (m_grid(x + 1, y + 1) == state);
+	}
+	return moore_view_at(x, y).count(state);
+}
+
+namespace detail {
+	/// Names used by the `*_neighborhood_at` compatibility functions, indexed
+	/// by direction.
+	constexpr std::array<const char*, 8> moore_names{
+	    "n", "e", "s", "w", "ne", "nw", "se", "sw"};
+	constexpr std::array<const char*, 8> extended_vn_names{
+	    "n", "e", "s", "w", "n2", "e2", "s2", "w2"};
+} // namespace detail
+
+template<typename StateType, typename Layout>
+inline const std::unordered_map<const char*, StateType>&
+Automaton<StateType, Layout>::vn_neighborhood_at(const size_t x,
+                                                 const size_t y) {
+	auto& neighborhood = scratch_neighborhood();
+	neighborhood.clear();
+	const auto view = vn_view_at(x, y);
+	for (size_t dir = 0; dir < view.arity; ++dir) {
+		if (view.exists(dir)) {
+			neighborhood.emplace(detail::moore_names[dir], view[dir]);
+		}
+	}
+
+	return neighborhood;
+}
+
+template<typename StateType, typename Layout>
+inline const std::unordered_map<const char*, StateType>&
+Automaton<StateType, Layout>::moore_neighborhood_at(const size_t x,
+                                                    const size_t y) {
+	auto& neighborhood = scratch_neighborhood();
+	neighborhood.clear();
+	const auto view = moore_view_at(x, y);
+	for (size_t dir = 0; dir < view.arity; ++dir) {
+		if (view.exists(dir)) {
+			neighborhood.emplace(detail::moore_names[dir], view[dir]);
+		}
+	}
+
+	return neighborhood;
+}
+
+template<typename StateType, typename Layout>
 inline const std::unordered_map<const char*, StateType>&
-Automaton<StateType>::extended_vn_neighborhood_at(const size_t x,
-                                                  const size_t y) {
-	vn_neighborhood_at(x, y);
-	bool x_over_one        = x > 1;
-	bool x_one_under_limit = x < m_width - 1;
-	bool y_over_one        = y > 1;
-	bool y_one_under_limit = y < m_height - 1;
+Automaton<StateType, Layout>::extended_vn_neighborhood_at(const size_t x,
+                                                          const size_t y) {
+	auto& neighborhood = scratch_neighborhood();
+	neighborhood.clear();
+	const auto view = extended_vn_view_at(x, y);
+	for (size_t dir = 0; dir < view.arity; ++dir) {
+		if (view.exists(dir)) {
+			neighborhood.emplace(detail::extended_vn_names[dir], view[dir]);
+		}
+	}
+
+	return neighborhood;
+}
+
+template<typename T, typename L>
+inline std::unordered_map<const char*, T>&
+Automaton<T, L>::scratch_neighborhood() {
+	//   *
+	//  ***
+	// ** **
+	//  ***
+	//   *
+	thread_local std::unordered_map<const char*, T> neighborhood(12);
+	return neighborhood;
+}
 
-	if (x_over_one) { m_neighborhood.emplace("w2", m_grid(x - 1, y)); }
-	if (x_one_under_limit) { m_neighborhood.emplace("e2", m_grid(x + 1, y)); }
-	if (y_over_one) { m_neighborhood.emplace("n2", m_grid(x, y - 1)); }
-	if (y_one_under_limit) { m_neighborhood.emplace("s2", m_grid(x, y + 1)); }
+template<typename T, typename L>
+inline unsigned int Automaton<T, L>::neighbors() {
+	return scratch_neighborhood().size();
+}
 
-	return m_neighborhood;
+template<typename T, typename L>
+inline void Automaton<T, L>::step() {
+	load_pending();
+	if (tallied()) {
+		step_tallied();
+		return;
+	}
+	step_generation();
 }
 
-template<typename T>
-inline unsigned int Automaton<T>::neighbors() {
-	return m_neighborhood.size();
+template<typename T, typename L>
+inline bool Automaton<T, L>::tallied() const {
+#if CELLULAR_STATS
+	if (!m_observers.empty()) { return true; }
+#endif
+	return m_track_hash;
 }
 
-template<typename T>
-inline void Automaton<T>::step() {
-	for (size_t i = 0; i <= m_width; ++i) {
-		for (size_t j = 0; j <= m_height; ++j) {
-			T& current_cell   = m_grid(j, i);
-			m_next_grid(j, i) = next_state(current_cell, j, i);
+template<typename T, typename L>
+inline void Automaton<T, L>::step_tallied() {
+#if CELLULAR_STATS
+	const bool observed = !m_observers.empty();
+	if constexpr (sizeof(T) == 1) {
+		// Only after cells were written to, the steps keep it up to date.
+		if (observed && m_population_stale) {
+			m_population.fill(0);
+			for (size_t x = 0; x <= m_width; ++x) {
+				for (size_t y = 0; y <= m_height; ++y) {
+					++m_population[static_cast<std::uint8_t>(m_grid(x, y))];
+				}
+			}
+			m_population_stale = false;
 		}
 	}
-	m_grid_vec = m_next_grid_vec;
+#endif
+	if (m_track_hash) { refresh_hash(); }
+
+	detail::GenerationTally tally;
+	m_tally          = &tally;
+	const auto start = std::chrono::steady_clock::now();
+	try {
+		step_generation();
+	} catch (...) {
+		m_tally = nullptr;
+		throw;
+	}
+	[[maybe_unused]] const std::chrono::duration<double> elapsed =
+	    std::chrono::steady_clock::now() - start;
+	m_tally = nullptr;
+
+	if (m_track_hash) {
+		m_hash ^= tally.total.hash;
+		m_hashes.push_back(m_hash);
+		if (m_hashes.size() > m_hash_history + 1) { m_hashes.pop_front(); }
+	}
+
+#if CELLULAR_STATS
+	if (!observed) { return; }
+	GenerationStats stats;
+	stats.generation = m_generation;
+	stats.seconds    = elapsed.count();
+	stats.evaluated  = tally.total.evaluated;
+	stats.changed    = tally.total.changed;
+	if constexpr (sizeof(T) == 1) {
+		size_t states = 0;
+		for (size_t state = 0; state < m_population.size(); ++state) {
+			m_population[state] += tally.total.population[state];
+			if (m_population[state] != 0) { states = state + 1; }
+		}
+		stats.population.assign(m_population.begin(),
+		                        m_population.begin() + states);
+	}
+	// Copied, so that observers can remove themselves.
+	const auto observers = m_observers;
+	for (const auto& [handle, observer] : observers) { observer(stats); }
+#endif
 }
 
-template<typename T>
-inline T& Automaton<T>::operator()(const size_t x, const size_t y) {
-	return m_grid(x, y);
+template<typename T, typename L>
+inline void Automaton<T, L>::step_generation() {
+	// Cells near the edges may have been written to since the last step.
+	m_grid.fill_halo(m_boundary);
+	if (m_count_rule) {
+		const auto uncounted =
+		    static_cast<std::uint8_t>(m_count_rule->counted + 1);
+		m_uncounted_line.assign(m_height + 1, uncounted);
+	}
+	++m_generation;
+	if (m_track_activity) {
+		step_active();
+		return;
+	}
+
+	const size_t width = m_width + 1;
+	if constexpr (layout_traits<L>::block != 0) {
+		// Block by block, in the order the layout stores the blocks in.
+		// They're aligned to the corner of the halo rather than the grid.
+		constexpr size_t block  = layout_traits<L>::block;
+		const size_t     height = m_height + 1;
+		const size_t     blocks_y = (height + 2 * halo + block - 1) / block;
+		const size_t     blocks_x = (width + 2 * halo + block - 1) / block;
+		parallel_for(blocks_x * blocks_y, [&](const size_t i) {
+			auto range = [](const size_t index, const size_t size) {
+				return std::pair{
+				    std::max(index * block, halo) - halo,
+				    std::min(index * block + block, size + halo) - halo};
+			};
+			const auto [x_begin, x_end] = range(i / blocks_y, width);
+			const auto [y_begin, y_end] = range(i % blocks_y, height);
+			if (x_begin < x_end && y_begin < y_end) {
+				step_rect(x_begin, x_end, y_begin, y_end);
+			}
+		});
+	} else if (m_pool == nullptr || m_pool->size() == 1) {
+		step_rect(0, width, 0, m_height + 1);
+	} else {
+		// A few bands per thread so that uneven bands balance out. Every
+		// cell only depends on the current grid, so the result doesn't depend
+		// on how the bands are scheduled.
+		const size_t bands      = std::min(width, m_pool->size() * 4);
+		const size_t band_width = (width + bands - 1) / bands;
+		m_pool->parallel_for(bands, [&](const size_t band) {
+			const size_t x_begin = band * band_width;
+			step_rect(x_begin,
+			          std::min(width, x_begin + band_width),
+			          0,
+			          m_height + 1);
+		});
+	}
+	m_grid.swap(m_next_grid);
 }
 
-template<typename T>
-inline const T& Automaton<T>::operator()(const size_t x, const size_t y) const {
+template<typename T, typename L>
+inline void Automaton<T, L>::step(const size_t generations) {
+	load_pending();
+	if constexpr (sizeof(T) == 1 && contiguous_lines) {
+		// The halo would have to be exchanged between tiles every generation
+		// for the other boundaries.
+		if (m_count_rule && !m_track_activity
+		    && m_boundary == Boundary::dead && !tallied()) {
+			step_blocked(generations);
+			return;
+		}
+	}
+	for (size_t i = 0; i < generations; ++i) { step(); }
+}
+
+template<typename T, typename L>
+inline void Automaton<T, L>::step_active() {
+	// Schedule every tile that changed and their neighbors, each once.
+	if (++m_epoch == 0) {
+		std::fill(m_tile_epoch.begin(), m_tile_epoch.end(), 0);
+		m_epoch = 1;
+	}
+	m_scheduled_tiles.clear();
+	// On a torus the tiles at opposite edges neighbor each other, otherwise
+	// tiles past the edges are skipped.
+	const bool wrap     = m_boundary == Boundary::toroidal;
+	auto       neighbor = [wrap](const size_t tile,
+                           const int    offset,
+                           const size_t tiles) -> size_t {
+		if (wrap) { return (tile + tiles + offset) % tiles; }
+		return tile + offset;
+	};
+	for (const size_t tile : m_changed_tiles) {
+		m_tile_changed[tile] = false;
+		const size_t tx      = tile / m_tiles_y;
+		const size_t ty      = tile % m_tiles_y;
+		for (int dx = -1; dx <= 1; ++dx) {
+			const size_t nx = neighbor(tx, dx, m_tiles_x);
+			for (int dy = -1; dy <= 1; ++dy) {
+				const size_t ny = neighbor(ty, dy, m_tiles_y);
+				const size_t id = nx * m_tiles_y + ny;
+				if (nx < m_tiles_x && ny < m_tiles_y
+				    && m_tile_epoch[id] != m_epoch) {
+					m_tile_epoch[id] = m_epoch;
+					m_scheduled_tiles.push_back(id);
+				}
+			}
+		}
+	}
+	m_changed_tiles.clear();
+	// In storage order, so that neighboring tiles share cache lines.
+	std::sort(m_scheduled_tiles.begin(), m_scheduled_tiles.end());
+
+	// Both grids agree everywhere outside of the changed tiles: scheduled
+	// tiles that don't change are rewritten with the same cells, and the
+	// ones that do are scheduled again next step. So only the scheduled
+	// tiles need computing before the grids are swapped.
+	auto tile_rect = [this](const size_t tile) {
+		const size_t x = tile / m_tiles_y * activity_tile_x;
+		const size_t y = tile % m_tiles_y * activity_tile_y;
+		return std::array<size_t, 4>{
+		    x,
+		    std::min(m_width + 1, x + activity_tile_x),
+		    y,
+		    std::min(m_height + 1, y + activity_tile_y)};
+	};
+	m_scheduled_changed.assign(m_scheduled_tiles.size(), false);
+	parallel_for(m_scheduled_tiles.size(), [&](const size_t i) {
+		const auto [x_begin, x_end, y_begin, y_end] =
+		    tile_rect(m_scheduled_tiles[i]);
+		m_scheduled_changed[i] = step_rect(x_begin, x_end, y_begin, y_end);
+	});
+	m_grid.swap(m_next_grid);
+
+	for (size_t i = 0; i < m_scheduled_tiles.size(); ++i) {
+		if (m_scheduled_changed[i]) {
+			m_tile_changed[m_scheduled_tiles[i]] = true;
+			m_changed_tiles.push_back(m_scheduled_tiles[i]);
+		}
+	}
+}
+
+template<typename T, typename L>
+inline void Automaton<T, L>::step_blocked(size_t generations) {
+	const auto uncounted = static_cast<std::uint8_t>(m_count_rule->counted + 1);
+	m_uncounted_line.assign(m_height + 1, uncounted);
+	const size_t tiles_x = (m_width + block_tile) / block_tile;
+	const size_t tiles_y = (m_height + block_tile) / block_tile;
+	while (generations > 0) {
+		const size_t depth = std::min(generations, block_depth);
+		// Tiles only read `m_grid` and only write their own part of
+		// `m_next_grid`.
+		parallel_for(tiles_x * tiles_y, [&](const size_t tile) {
+			step_block(tile / tiles_y * block_tile,
+			           tile % tiles_y * block_tile,
+			           depth);
+		});
+		m_grid.swap(m_next_grid);
+		m_generation += depth;
+		generations -= depth;
+	}
+}
+
+template<typename T, typename L>
+inline void Automaton<T, L>::step_block(const size_t x_begin,
+                                        const size_t y_begin,
+                                        const size_t depth) {
+	const size_t x_end = std::min(m_width + 1, x_begin + block_tile);
+	const size_t y_end = std::min(m_height + 1, y_begin + block_tile);
+	// The tile plus a halo `depth` cells wide on the sides that aren't at the
+	// edge of the grid. The halo's outer cells are never computed, so cells
+	// in it go wrong one cell further in every generation, but never reach
+	// the tile itself.
+	const size_t sx_begin = x_begin > depth ? x_begin - depth : 0;
+	const size_t sy_begin = y_begin > depth ? y_begin - depth : 0;
+	const size_t sx_end   = std::min(m_width + 1, x_end + depth);
+	const size_t sy_end   = std::min(m_height + 1, y_end + depth);
+	const size_t lines    = sx_end - sx_begin;
+	const size_t length   = sy_end - sy_begin;
+
+	thread_local std::vector<std::uint8_t> front;
+	thread_local std::vector<std::uint8_t> back;
+	front.resize(lines * length);
+	back.resize(lines * length);
+	for (size_t x = 0; x < lines; ++x) {
+		const auto* line =
+		    reinterpret_cast<const std::uint8_t*>(&m_grid(sx_begin + x, 0));
+		std::copy(line + sy_begin, line + sy_end, &front[x * length]);
+	}
+
+	for (size_t generation = 0; generation < depth; ++generation) {
+		// Skip the part of the halo that's already gone wrong, which means
+		// only the sides at the edge of the grid ever read past the halo.
+		const size_t skip_x = sx_begin > 0 ? generation + 1 : 0;
+		const size_t skip_y = sy_begin > 0 ? generation + 1 : 0;
+		const size_t end_x  = lines - (sx_end <= m_width ? generation + 1 : 0);
+		const size_t end_y = length - (sy_end <= m_height ? generation + 1 : 0);
+		for (size_t x = skip_x; x < end_x; ++x) {
+			simd::step_span(*m_count_rule,
+			                x > 0 ? &front[(x - 1) * length]
+			                      : m_uncounted_line.data(),
+			                &front[x * length],
+			                x + 1 < lines ? &front[(x + 1) * length]
+			                              : m_uncounted_line.data(),
+			                &back[x * length],
+			                skip_y,
+			                end_y,
+			                length);
+		}
+		front.swap(back);
+	}
+
+	for (size_t x = x_begin; x < x_end; ++x) {
+		const std::uint8_t* line = &front[(x - sx_begin) * length];
+		std::copy(line + (y_begin - sy_begin),
+		          line + (y_end - sy_begin),
+		          reinterpret_cast<std::uint8_t*>(&m_next_grid(x, y_begin)));
+	}
+}
+
+template<typename T, typename L>
+inline bool Automaton<T, L>::step_rect(const size_t x_begin,
+                                       const size_t x_end,
+                                       const size_t y_begin,
+                                       const size_t y_end) {
+	if (m_tally != nullptr) {
+		// Tallied separately and merged once, so that concurrent rects
+		// don't contend.
+		detail::StepTally tally;
+		tally.evaluated = (x_end - x_begin) * (y_end - y_begin);
+		const bool changed =
+		    evaluate_rect(x_begin, x_end, y_begin, y_end, &tally);
+		m_tally->merge(tally);
+		return changed;
+	}
+	return evaluate_rect(x_begin, x_end, y_begin, y_end, nullptr);
+}
+
+template<typename T, typename L>
+inline bool Automaton<T, L>::evaluate_rect(const size_t       x_begin,
+                                           const size_t       x_end,
+                                           const size_t       y_begin,
+                                           const size_t       y_end,
+                                           detail::StepTally* tally) {
+	if constexpr (sizeof(T) == 1 && contiguous_lines) {
+		if (m_count_rule) {
+			return evaluate_rect_simd(x_begin, x_end, y_begin, y_end, tally);
+		}
+	}
+	return evaluate_cells(x_begin, x_end, y_begin, y_end, tally);
+}
+
+template<typename T, typename L>
+inline bool Automaton<T, L>::evaluate_cells(const size_t       x_begin,
+                                            const size_t       x_end,
+                                            const size_t       y_begin,
+                                            const size_t       y_end,
+                                            detail::StepTally* tally) {
+	return evaluate_cells_with(
+	    x_begin,
+	    x_end,
+	    y_begin,
+	    y_end,
+	    tally,
+	    [this](const T current_cell, const size_t x, const size_t y) {
+		    return next_state(current_cell, x, y);
+	    });
+}
+
+template<typename T, typename L>
+template<typename Next>
+inline bool Automaton<T, L>::evaluate_cells_with(const size_t       x_begin,
+                                                 const size_t       x_end,
+                                                 const size_t       y_begin,
+                                                 const size_t       y_end,
+                                                 detail::StepTally* tally,
+                                                 Next&&             next) {
+	bool changed = false;
+	for (size_t x = x_begin; x < x_end; ++x) {
+		for (size_t y = y_begin; y < y_end; ++y) {
+			const T current_cell = m_grid(x, y);
+			const T next_cell    = next(current_cell, x, y);
+			m_next_grid(x, y)    = next_cell;
+			changed |= next_cell != current_cell;
+			if (tally == nullptr || next_cell == current_cell) { continue; }
+#if CELLULAR_STATS
+			tally->count_change(current_cell, next_cell);
+#endif
+			if (m_track_hash) {
+				tally->hash ^=
+				    cell_key(x, y, current_cell) ^ cell_key(x, y, next_cell);
+			}
+		}
+	}
+	return changed;
+}
+
+template<typename T, typename L>
+inline bool Automaton<T, L>::evaluate_rect_simd(
+    const size_t       x_begin,
+    const size_t       x_end,
+    const size_t       y_begin,
+    const size_t       y_end,
+    detail::StepTally* tally) {
+	// Every line of constant x is contiguous.
+	auto line = [this](const size_t x) {
+		return reinterpret_cast<const std::uint8_t*>(&m_grid(x, 0));
+	};
+	// The halo can stand in for the cells past the edges, unless the default
+	// state it holds for `Boundary::dead` is the counted one.
+	const bool padded =
+	    m_boundary != Boundary::dead || m_count_rule->counted != 0;
+	bool changed = false;
+	for (size_t x = x_begin; x < x_end; ++x) {
+		auto* out = reinterpret_cast<std::uint8_t*>(&m_next_grid(x, 0));
+		if (padded) {
+			simd::step_span_unchecked(*m_count_rule,
+			                          line(x - 1),
+			                          line(x),
+			                          line(x + 1),
+			                          out,
+			                          y_begin,
+			                          y_end);
+		} else {
+			simd::step_span(*m_count_rule,
+			                x > 0 ? line(x - 1) : m_uncounted_line.data(),
+			                line(x),
+			                x < m_width ? line(x + 1) : m_uncounted_line.data(),
+			                out,
+			                y_begin,
+			                y_end,
+			                m_height + 1);
+		}
+		if (tally == nullptr) {
+			changed = changed
+			          || !std::equal(
+			              out + y_begin, out + y_end, line(x) + y_begin);
+			continue;
+		}
+		// While the line is still in the cache, in passes that vectorize
+		// rather than a branch per cell.
+		const size_t before  = tally->changed;
+		bool         counted = false;
+#if CELLULAR_STATS
+		if (!m_observers.empty()) {
+			simd::tally_span(line(x),
+			                 out,
+			                 y_begin,
+			                 y_end,
+			                 m_count_rule->states,
+			                 tally->changed,
+			                 tally->population.data());
+			counted = true;
+		}
+#endif
+		if (m_track_hash) {
+			const std::uint8_t* in      = line(x);
+			size_t              changes = 0;
+			std::uint64_t       hash    = 0;
+			simd::for_each_change(in, out, y_begin, y_end, [&](const size_t y) {
+				++changes;
+				hash ^= detail::zobrist_key(x, y, in[y])
+				        ^ detail::zobrist_key(x, y, out[y]);
+			});
+			tally->hash ^= hash;
+			if (!counted) { tally->changed += changes; }
+		}
+		changed = changed || tally->changed != before;
+	}
+	return changed;
+}
+
+template<typename T, typename L>
+template<typename Function>
+inline void Automaton<T, L>::parallel_for(const size_t count, Function&& task) {
+	if (m_pool == nullptr || m_pool->size() == 1) {
+		for (size_t i = 0; i < count; ++i) { task(i); }
+	} else {
+		m_pool->parallel_for(count, task);
+	}
+}
+
+template<typename T, typename L>
+inline void Automaton<T, L>::set_activity_tracking(const bool enabled) {
+	m_track_activity = enabled;
+	if (enabled) { reset_activity(); }
+}
+
+template<typename T, typename L>
+inline void Automaton<T, L>::reset_activity() {
+	// Everything counts as changed, so the first step evaluates every tile.
+	m_tiles_x = (m_width + activity_tile_x) / activity_tile_x;
+	m_tiles_y = (m_height + activity_tile_y) / activity_tile_y;
+	m_tile_changed.assign(m_tiles_x * m_tiles_y, true);
+	m_tile_epoch.assign(m_tiles_x * m_tiles_y, 0);
+	m_changed_tiles.resize(m_tiles_x * m_tiles_y);
+	for (size_t i = 0; i < m_changed_tiles.size(); ++i) {
+		m_changed_tiles[i] = i;
+	}
+}
+
+template<typename T, typename L>
+inline void Automaton<T, L>::mark_changed(const size_t x, const size_t y) {
+	const size_t tile =
+	    x / activity_tile_x * m_tiles_y + y / activity_tile_y;
+	if (!m_tile_changed[tile]) {
+		m_tile_changed[tile] = true;
+		m_changed_tiles.push_back(tile);
+	}
+}
+
+template<typename T, typename L>
+inline void Automaton<T, L>::set_boundary(const Boundary boundary) {
+	m_boundary = boundary;
+	// The history came from different rules.
+	m_hash_stale = true;
+	// Tiles at rest under the old boundary may not be under the new one.
+	if (m_track_activity) { reset_activity(); }
+}
+
+template<typename T, typename L>
+inline Boundary Automaton<T, L>::boundary() const {
+	return m_boundary;
+}
+
+template<typename T, typename L>
+inline size_t Automaton<T, L>::add_observer(StatsObserver observer) {
+#if CELLULAR_STATS
+	m_observers.emplace_back(m_next_observer, std::move(observer));
+	return m_next_observer++;
+#else
+	static_cast<void>(observer);
+	return 0;
+#endif
+}
+
+template<typename T, typename L>
+inline void Automaton<T, L>::remove_observer(const size_t handle) {
+#if CELLULAR_STATS
+	std::erase_if(m_observers, [handle](const auto& registered) {
+		return registered.first == handle;
+	});
+#else
+	static_cast<void>(handle);
+#endif
+}
+
+template<typename T, typename L>
+inline void Automaton<T, L>::set_hash_tracking(const bool   enabled,
+                                               const size_t history) {
+	if (enabled && !m_track_hash) { m_hash_stale = true; }
+	m_track_hash   = enabled;
+	m_hash_history = history;
+	if (!enabled) { m_hashes.clear(); }
+	while (m_hashes.size() > m_hash_history + 1) { m_hashes.pop_front(); }
+}
+
+template<typename T, typename L>
+inline std::uint64_t Automaton<T, L>::hash() const {
+	load_pending();
+	return m_track_hash && !m_hash_stale ? m_hash : full_hash();
+}
+
+template<typename T, typename L>
+inline Stabilization Automaton<T, L>::run_until_stable(
+    const size_t max_generations,
+    const size_t max_period) {
+	load_pending();
+	const bool   tracked = m_track_hash;
+	const size_t history = m_hash_history;
+	set_hash_tracking(true, std::max(history, max_period));
+	refresh_hash();
+
+	// Checked for real, since other grids could hash to 0 too.
+	auto extinct = [this] {
+		for (size_t x = 0; x <= m_width; ++x) {
+			for (size_t y = 0; y <= m_height; ++y) {
+				if (m_grid(x, y) != T()) { return false; }
+			}
+		}
+		return true;
+	};
+	Stabilization ret;
+	try {
+		for (size_t generation = 0;; ++generation) {
+			// The first repeat is of the cycle's first generation, since an
+			// earlier one would have repeated sooner.
+			if (const size_t period = repeat_period(max_period); period != 0) {
+				ret.period     = period;
+				ret.generation = m_generation - period;
+				if (period > 1) {
+					ret.kind = Stabilization::Kind::oscillating;
+				} else if (m_hash == 0 && extinct()) {
+					ret.kind = Stabilization::Kind::extinct;
+				} else {
+					ret.kind = Stabilization::Kind::still;
+				}
+				break;
+			}
+			if (generation == max_generations) {
+				ret.generation = m_generation;
+				break;
+			}
+			step();
+		}
+	} catch (...) {
+		set_hash_tracking(tracked, history);
+		throw;
+	}
+	set_hash_tracking(tracked, history);
+	return ret;
+}
+
+template<typename T, typename L>
+inline void Automaton<T, L>::refresh_hash() {
+	if (!m_hash_stale) { return; }
+	m_hash       = full_hash();
+	m_hash_stale = false;
+	m_hashes.assign(1, m_hash);
+}
+
+template<typename T, typename L>
+inline std::uint64_t Automaton<T, L>::full_hash() const {
+	std::uint64_t ret = 0;
+	for (size_t x = 0; x <= m_width; ++x) {
+		for (size_t y = 0; y <= m_height; ++y) {
+			ret ^= cell_key(x, y, m_grid(x, y));
+		}
+	}
+	return ret;
+}
+
+template<typename T, typename L>
+inline std::uint64_t Automaton<T, L>::cell_key(const size_t x,
+                                               const size_t y,
+                                               const T      state) {
+	// Folded into 64 bits for states that are bigger than that.
+	std::uint64_t bits  = 0;
+	const auto*   bytes = reinterpret_cast<const unsigned char*>(&state);
+	for (size_t i = 0; i < sizeof(T); ++i) {
+		bits ^= static_cast<std::uint64_t>(bytes[i]) << (i % 8 * 8);
+	}
+	return detail::zobrist_key(x, y, bits);
+}
+
+template<typename T, typename L>
+inline size_t Automaton<T, L>::repeat_period(const size_t max_period) const {
+	const size_t newest = m_hashes.size() - 1;
+	for (size_t period = 1; period <= std::min(newest, max_period); ++period) {
+		if (m_hashes[newest - period] == m_hashes.back()) { return period; }
+	}
+	return 0;
+}
+
+template<typename T, typename L>
+inline void Automaton<T, L>::set_count_rule(const CountRule& rule) {
+	m_count_rule = rule;
+	m_hash_stale = true;
+	if (m_track_activity) { reset_activity(); }
+}
+
+template<typename T, typename L>
+inline void Automaton<T, L>::set_threads(const size_t threads) {
+	set_thread_pool(threads > 1 ? std::make_shared<ThreadPool>(threads)
+	                            : nullptr);
+}
+
+template<typename T, typename L>
+inline void Automaton<T, L>::set_thread_pool(std::shared_ptr<ThreadPool> pool) {
+	m_pool = std::move(pool);
+}
+
+template<typename T, typename L>
+inline typename Automaton<T, L>::CellReference
+Automaton<T, L>::operator()(const size_t x, const size_t y) {
+	load_pending();
+	return CellReference(*this, x, y);
+}
+
+template<typename T, typename L>
+inline Automaton<T, L>::CellReference::CellReference(Automaton&   automaton,
+                                                     const size_t x,
+                                                     const size_t y) :
+    m_automaton(automaton),
+    m_x(x),
+    m_y(y) {}
+
+template<typename T, typename L>
+inline Automaton<T, L>::CellReference::operator T() const {
+	return m_automaton.m_grid(m_x, m_y);
+}
+
+template<typename T, typename L>
+inline typename Automaton<T, L>::CellReference&
+Automaton<T, L>::CellReference::operator=(const T state) {
+	if (m_automaton.m_track_activity) { m_automaton.mark_changed(m_x, m_y); }
+	m_automaton.m_hash_stale = true;
+#if CELLULAR_STATS
+	m_automaton.m_population_stale = true;
+#endif
+	m_automaton.m_grid(m_x, m_y) = state;
+	return *this;
+}
+
+template<typename T, typename L>
+inline typename Automaton<T, L>::CellReference&
+Automaton<T, L>::CellReference::operator=(const CellReference& other) {
+	return *this = static_cast<T>(other);
+}
+
+template<typename T, typename L>
+inline const T& Automaton<T, L>::operator()(const size_t x,
+                                            const size_t y) const {
+	load_pending();
 	return m_grid(x, y);
 }
 
-template<typename T>
-inline size_t Automaton<T>::width() const {
+template<typename T, typename L>
+inline size_t Automaton<T, L>::width() const {
+	load_pending();
 	return m_width + 1;
 }
-template<typename T>
-inline size_t Automaton<T>::height() const {
+template<typename T, typename L>
+inline size_t Automaton<T, L>::height() const {
+	load_pending();
 	return m_height + 1;
 }
 
-template<typename T>
-inline void Automaton<T>::set_grid_from_file(
+template<typename T, typename L>
+inline void Automaton<T, L>::set_grid_from_file(
     const std::filesystem::path& filename,
     const char                   delimiter) {
-	std::ifstream filein(filename);
-
-	// Construct string with file contents
-	// TODO: validate file contents, existence, etc.
-	std::string grid_string{std::istreambuf_iterator<char>(filein),
-	                        std::istreambuf_iterator<char>()};
-	set_grid_from_string(std::move(grid_string), delimiter);
-}
-
-template<typename T>
-inline void Automaton<T>::set_grid_from_string(std::string&& str,
-                                               const char    delimiter) {
-	// TODO: validate string non-emptiness, conformance to shape, etc.
-	std::vector<char> chars(str.begin(), str.end());
-
-	// This is an iterator
-	auto first_occurance = std::find(chars.begin(), chars.end(), delimiter);
-	// Calculate width from first occurance of delimiter...
-	m_width = first_occurance - chars.begin() - 1;
-	// ...and height from number of occurances of delimiter (e.g.
-	// newline, so amount of lines).
-	m_height = std::count(chars.begin(), chars.end(), delimiter) - 1;
-
-	// Remove delimiters
-	chars.erase(std::remove(chars.begin(), chars.end(), delimiter),
-	            chars.end());
-
-	std::vector<T> grid_vec;
-	grid_vec.reserve(chars.size());
-	for (char c : chars) {
-		T state = char_to_state(c);
-		grid_vec.push_back(state);
-	}
-
-	m_grid_vec      = std::move(grid_vec);
-	m_next_grid_vec = m_grid_vec;
-	m_grid          = Grid(m_grid_vec.data(), m_width + 1, m_height + 1);
-	m_next_grid     = Grid(m_next_grid_vec.data(), m_width + 1, m_height + 1);
+	const io::MappedFile file(filename);
+	load(file.view(), delimiter);
+}
+
+template<typename T, typename L>
+inline void Automaton<T, L>::load_pending() const {
+	if (!m_pending_file) { return; }
+	// Loading only completes the construction, so it's done even on an
+	// automaton that's otherwise only read.
+	auto& self = const_cast<Automaton&>(*this);
+	const std::filesystem::path filename = std::move(*self.m_pending_file);
+	self.m_pending_file.reset();
+	self.set_grid_from_file(filename);
+}
+
+template<typename T, typename L>
+inline void Automaton<T, L>::set_grid_from_string(std::string&& str,
+                                                  const char    delimiter) {
+	load(str, delimiter);
+}
+
+template<typename T, typename L>
+inline void Automaton<T, L>::load(const std::string_view text,
+                                  const char             delimiter) {
+	// Cells go straight into the new grid, which only replaces the current
+	// one once all of `text` parsed.
+	std::optional<Grid> grid;
+	io::parse(
+	    text,
+	    delimiter,
+	    [&](const size_t width, const size_t height) {
+		    grid.emplace(width, height, halo);
+	    },
+	    [&](const size_t x, const size_t y, const char c) {
+		    (*grid)(x, y) = char_to_state(c);
+	    },
+	    [&](const size_t x, const size_t y, const unsigned int state) {
+		    // The count rule's table is indexed by state.
+		    if (m_count_rule && state >= m_count_rule->states) {
+			    throw std::invalid_argument(
+			        "state " + std::to_string(state) + " is past the "
+			        + std::to_string(m_count_rule->states) + " states");
+		    }
+		    (*grid)(x, y) = static_cast<T>(state);
+	    });
+
+	m_pending_file.reset();
+	m_width      = grid->width() - 1;
+	m_height     = grid->height() - 1;
+	m_grid       = std::move(*grid);
+	m_next_grid  = m_grid;
+	m_generation = 0;
+	if (m_track_activity) { reset_activity(); }
+	m_hash_stale = true;
+#if CELLULAR_STATS
+	m_population_stale = true;
+#endif
+}
+
+template<typename T, typename L>
+inline size_t Automaton<T, L>::generation() const {
+	return m_generation;
+}
+
+template<typename T, typename L>
+inline void Automaton<T, L>::save_checkpoint(
+    const std::filesystem::path& filename,
+    const io::Compression        compression) const {
+	static_assert(std::is_trivially_copyable_v<T>,
+	              "checkpoints store the cells' bytes");
+	load_pending();
+	io::CheckpointHeader header;
+	header.state_size   = sizeof(T);
+	header.layout       = layout_traits<L>::kind;
+	header.layout_block = layout_traits<L>::block;
+	header.compression  = compression;
+	header.boundary     = static_cast<std::uint32_t>(m_boundary);
+	header.width        = m_width + 1;
+	header.height       = m_height + 1;
+	header.halo         = halo;
+	header.generation   = m_generation;
+	header.cells        = m_grid.span_size();
+	io::write_checkpoint(filename,
+	                     header,
+	                     reinterpret_cast<const char*>(m_grid.data()),
+	                     m_grid.span_size() * sizeof(T));
+}
+
+template<typename T, typename L>
+inline void Automaton<T, L>::restore_checkpoint(
+    const std::filesystem::path& filename) {
+	static_assert(std::is_trivially_copyable_v<T>,
+	              "checkpoints store the cells' bytes");
+	auto file = std::make_shared<io::MappedFile>(
+	    filename, io::MappedFile::Mode::copy_on_write);
+	const io::CheckpointHeader header =
+	    io::read_checkpoint_header(file->view());
+	if (header.state_size != sizeof(T)
+	    || header.layout != layout_traits<L>::kind
+	    || header.layout_block != layout_traits<L>::block
+	    || header.halo != halo
+	    || header.boundary > static_cast<std::uint32_t>(Boundary::reflective)) {
+		throw std::invalid_argument(
+		    "checkpoint was saved by a different kind of automaton");
+	}
+	const size_t width  = header.width;
+	const size_t height = header.height;
+	char* const  cells  = file->data() + sizeof(header);
+
+	std::optional<Grid> grid;
+	if (header.compression == io::Compression::none
+	    && reinterpret_cast<std::uintptr_t>(cells) % alignof(T) == 0) {
+		// Points into the mapping, which the grid keeps alive.
+		grid.emplace(width,
+		             height,
+		             halo,
+		             std::shared_ptr<T>(file, reinterpret_cast<T*>(cells)),
+		             header.payload_size / sizeof(T));
+	} else {
+		grid.emplace(width, height, halo);
+		const std::string_view payload(cells, header.payload_size);
+		const size_t           size = grid->span_size() * sizeof(T);
+		auto* const            out  = reinterpret_cast<char*>(grid->data());
+		if (header.compression == io::Compression::rle) {
+			io::decompress_rle(payload, out, size);
+		} else if (payload.size() >= size) {
+			std::memcpy(out, payload.data(), size);
+		} else {
+			throw std::invalid_argument("the cells don't fill the grid");
+		}
+	}
+
+	m_pending_file.reset();
+	m_width      = width - 1;
+	m_height     = height - 1;
+	m_grid       = std::move(*grid);
+	m_next_grid  = Grid(width, height, halo);
+	m_boundary   = static_cast<Boundary>(header.boundary);
+	m_generation = header.generation;
+	if (m_track_activity) { reset_activity(); }
+	m_hash_stale = true;
+#if CELLULAR_STATS
+	m_population_stale = true;
+#endif
 }
 
 } // namespace cellular
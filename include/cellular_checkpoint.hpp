@@ -0,0 +1,227 @@
+#ifndef CELLULAR_CHECKPOINT_HPP_
+#define CELLULAR_CHECKPOINT_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace cellular::io {
+
+/// How the cells in a checkpoint are stored.
+enum class Compression : std::uint32_t {
+	/// The grid's buffer as is, which restoring can map and use in place.
+	none,
+	/// Byte-wise run length encoding, which takes mostly empty grids down
+	/// to a fraction of their size. Restoring decodes it into a new buffer.
+	rle,
+};
+
+constexpr std::uint32_t checkpoint_version = 1;
+
+/// The start of a checkpoint file, followed by `payload_size` bytes of
+/// cells. The cells are the grid's whole buffer including its halo, in the
+/// order its layout stores them in, so they're only meaningful to an
+/// automaton with the same state type and layout. All fields are in the
+/// writer's byte order, which `byte_order` records.
+struct CheckpointHeader {
+	char          magic[8]   = {'C', 'E', 'L', 'L', 'C', 'K', 'P', 'T'};
+	std::uint32_t version    = checkpoint_version;
+	std::uint32_t byte_order = 0x01020304;
+	/// `sizeof` the state type.
+	std::uint32_t state_size = 0;
+	/// `layout_traits<Layout>::kind` and `block`.
+	std::uint32_t layout       = 0;
+	std::uint32_t layout_block = 0;
+	Compression   compression  = Compression::none;
+	/// The `Boundary`.
+	std::uint32_t boundary    = 0;
+	std::uint32_t reserved[3] = {};
+	std::uint64_t width       = 0;
+	std::uint64_t height      = 0;
+	std::uint64_t halo        = 0;
+	std::uint64_t generation  = 0;
+	/// Amount of cells in the buffer, including the halo and any padding
+	/// that the layout adds.
+	std::uint64_t cells        = 0;
+	std::uint64_t payload_size = 0;
+};
+// Keeps the cells behind it aligned for any state type.
+static_assert(sizeof(CheckpointHeader) == 96);
+
+/// Validate and return the header at the start of `file`. Throws
+/// `std::invalid_argument` if `file` isn't a checkpoint this version can
+/// read, or is shorter than its header says.
+inline CheckpointHeader read_checkpoint_header(std::string_view file);
+
+/// Write `header` and the `size` bytes at `cells` to `filename`, compressed
+/// with `header.compression`. Uncompressed cells are written straight from
+/// `cells`, compressed ones a chunk at a time, so only a chunk's worth of
+/// compressed data is ever in memory. The file is written under a temporary
+/// name and renamed over `filename` once complete, so that a failed write
+/// leaves an earlier checkpoint intact.
+inline void write_checkpoint(const std::filesystem::path& filename,
+                             CheckpointHeader             header,
+                             const char*                  cells,
+                             size_t                       size);
+
+/// Decode `payload` compressed with `Compression::rle` into the `size`
+/// bytes at `out`. Throws `std::invalid_argument` if it doesn't decode to
+/// exactly `size` bytes.
+inline void decompress_rle(std::string_view payload, char* out, size_t size);
+
+namespace detail {
+	/// How much of the grid is compressed at a time.
+	constexpr size_t checkpoint_chunk = size_t{1} << 20;
+	/// Runs shorter than this are stored as literals.
+	constexpr size_t min_run      = 3;
+	constexpr size_t max_run      = min_run + 127;
+	constexpr size_t max_literals = 128;
+
+	/// Append `size` bytes at `in`, encoded as control bytes followed by
+	/// their data, to `out`. A control byte below 128 is followed by that
+	/// many plus one literal bytes, one of 128 or above by a byte that's
+	/// repeated `control - 128 + min_run` times.
+	inline void compress_rle(const char* const  in,
+	                         const size_t       size,
+	                         std::vector<char>& out) {
+		// Bytes before `literals` are encoded already.
+		size_t literals = 0;
+		auto   flush    = [&](const size_t end) {
+			while (literals < end) {
+				const size_t count = std::min(end - literals, max_literals);
+				out.push_back(static_cast<char>(count - 1));
+				out.insert(out.end(), in + literals, in + literals + count);
+				literals += count;
+			}
+		};
+		for (size_t i = 0; i < size;) {
+			size_t run = 1;
+			while (i + run < size && run < max_run && in[i + run] == in[i]) {
+				++run;
+			}
+			if (run >= min_run) {
+				flush(i);
+				out.push_back(static_cast<char>(run - min_run + 128));
+				out.push_back(in[i]);
+				literals = i + run;
+			}
+			i += run;
+		}
+		flush(size);
+	}
+} // namespace detail
+
+inline CheckpointHeader read_checkpoint_header(const std::string_view file) {
+	const CheckpointHeader expected;
+	CheckpointHeader       header;
+	if (file.size() < sizeof(header)) {
+		throw std::invalid_argument("not a checkpoint");
+	}
+	std::memcpy(&header, file.data(), sizeof(header));
+	if (std::memcmp(header.magic, expected.magic, sizeof(header.magic))
+	    != 0) {
+		throw std::invalid_argument("not a checkpoint");
+	}
+	if (header.version != checkpoint_version) {
+		throw std::invalid_argument("unsupported checkpoint version "
+		                            + std::to_string(header.version));
+	}
+	if (header.byte_order != expected.byte_order) {
+		throw std::invalid_argument(
+		    "checkpoint was written with a different byte order");
+	}
+	if (header.compression != Compression::none
+	    && header.compression != Compression::rle) {
+		throw std::invalid_argument("unknown checkpoint compression");
+	}
+	if (header.width == 0 || header.height == 0) {
+		throw std::invalid_argument("the grid is empty");
+	}
+	if (header.payload_size > file.size() - sizeof(header)) {
+		throw std::invalid_argument("checkpoint is truncated");
+	}
+	return header;
+}
+
+inline void write_checkpoint(const std::filesystem::path& filename,
+                             CheckpointHeader             header,
+                             const char* const            cells,
+                             const size_t                 size) {
+	std::filesystem::path temporary = filename;
+	temporary += ".tmp";
+	{
+		std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+		if (!out) {
+			throw std::system_error(std::make_error_code(std::errc::io_error),
+			                        "can't create " + temporary.string());
+		}
+		// The payload's size is only known at the end when compressing, so
+		// the header is written again then.
+		header.payload_size = 0;
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		if (header.compression == Compression::none) {
+			out.write(cells, static_cast<std::streamsize>(size));
+			header.payload_size = size;
+		} else {
+			std::vector<char> buffer;
+			for (size_t offset = 0; offset < size && out;
+			     offset += detail::checkpoint_chunk) {
+				buffer.clear();
+				detail::compress_rle(
+				    cells + offset,
+				    std::min(detail::checkpoint_chunk, size - offset),
+				    buffer);
+				out.write(buffer.data(),
+				          static_cast<std::streamsize>(buffer.size()));
+				header.payload_size += buffer.size();
+			}
+		}
+		out.seekp(0);
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		out.close();
+		if (!out) {
+			std::filesystem::remove(temporary);
+			throw std::system_error(std::make_error_code(std::errc::io_error),
+			                        "can't write " + temporary.string());
+		}
+	}
+	std::filesystem::rename(temporary, filename);
+}
+
+inline void decompress_rle(const std::string_view payload,
+                           char* const            out,
+                           const size_t           size) {
+	size_t in      = 0;
+	size_t written = 0;
+	while (in < payload.size()) {
+		const auto control = static_cast<unsigned char>(payload[in++]);
+		if (control < 128) {
+			const size_t count = size_t{control} + 1;
+			if (count > payload.size() - in || count > size - written) {
+				throw std::invalid_argument("corrupt checkpoint");
+			}
+			std::memcpy(out + written, payload.data() + in, count);
+			in += count;
+			written += count;
+		} else {
+			const size_t count = size_t{control} - 128 + detail::min_run;
+			if (in == payload.size() || count > size - written) {
+				throw std::invalid_argument("corrupt checkpoint");
+			}
+			std::memset(out + written, payload[in++], count);
+			written += count;
+		}
+	}
+	if (written != size) { throw std::invalid_argument("corrupt checkpoint"); }
+}
+
+} // namespace cellular::io
+
+#endif // CELLULAR_CHECKPOINT_HPP_
@@ -0,0 +1,747 @@
+#ifndef CELLULAR_DOMAIN_HPP_
+#define CELLULAR_DOMAIN_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "cellular.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#define CELLULAR_HAS_SHARED_MEMORY 1
+#endif
+
+namespace cellular {
+
+/// Which side of a slab an edge is on.
+enum class Side { left, right };
+
+/// What the coordinator of a `Domain` asks its workers to do.
+struct Command {
+	enum class Op : std::uint32_t {
+		/// Worker `worker` takes its slab from the staging buffer.
+		load,
+		/// Worker `worker` puts its slab into the staging buffer.
+		store,
+		/// Every worker steps `generations` generations.
+		step,
+		/// Every worker exits.
+		quit,
+	};
+
+	Op            op;
+	std::uint32_t worker      = 0;
+	std::uint64_t generations = 0;
+};
+
+/// How the processes of a `Domain` talk to each other: a coordinator that
+/// hands out commands, and workers that carry them out and exchange the
+/// edges of their slabs every generation. Edges are put for a generation,
+/// and can be got by the neighbors once every worker passed the barrier
+/// for that generation.
+///
+/// Every buffer is a fixed size given when the transport is made, so a
+/// socket or MPI backend only has to move bytes around.
+class Transport {
+public:
+	virtual ~Transport() = default;
+	virtual size_t workers() const = 0;
+	/// Start the workers, each of which runs `work(worker)`. Only returns in
+	/// the coordinator.
+	virtual void launch(const std::function<void(size_t)>& work) = 0;
+
+	/// Give every worker `command` and wait until they're all done with it.
+	/// Throws `std::runtime_error` if a worker failed or died.
+	virtual void run(const Command& command) = 0;
+	/// Where slabs are moved through by `Command::Op::load` and `store`.
+	virtual std::byte* staging() = 0;
+
+	/// Wait for the next command.
+	virtual Command receive(const size_t worker) = 0;
+	/// Report the command as done, or as failed with `error`.
+	virtual void complete(const size_t worker, const char* error = nullptr) = 0;
+	virtual void put_edge(const size_t     worker,
+	                      const Side       side,
+	                      const size_t     generation,
+	                      const std::byte* edge)                            = 0;
+	/// Wait until every worker put its edges for `generation`. Throws
+	/// `std::runtime_error` if stepping was aborted.
+	virtual void barrier(const size_t worker, const size_t generation) = 0;
+	virtual void get_edge(const size_t from,
+	                      const Side   side,
+	                      const size_t generation,
+	                      std::byte*   edge)                                = 0;
+};
+
+#ifdef CELLULAR_HAS_SHARED_MEMORY
+/// `Transport` between local worker processes forked off the coordinator,
+/// through a POSIX shared memory segment. Commands, the barrier and error
+/// reports are atomics in the segment, which waiters poll with a backoff.
+/// Edges are double buffered by generation, since no worker can get more
+/// than one generation ahead of the others.
+class SharedMemoryTransport : public Transport {
+public:
+	/// Room for `workers` workers with edges of `edge_bytes` bytes and a
+	/// staging buffer of `staging_bytes` bytes.
+	inline SharedMemoryTransport(const size_t workers,
+	                             const size_t edge_bytes,
+	                             const size_t staging_bytes);
+	inline ~SharedMemoryTransport() override;
+	SharedMemoryTransport(const SharedMemoryTransport&) = delete;
+	SharedMemoryTransport& operator=(const SharedMemoryTransport&) = delete;
+
+	inline size_t workers() const override;
+	inline void   launch(const std::function<void(size_t)>& work) override;
+	inline void   run(const Command& command) override;
+	inline std::byte* staging() override;
+	inline Command    receive(const size_t worker) override;
+	inline void       complete(const size_t worker,
+	                           const char*  error = nullptr) override;
+	inline void       put_edge(const size_t     worker,
+	                           const Side       side,
+	                           const size_t     generation,
+	                           const std::byte* edge) override;
+	inline void barrier(const size_t worker, const size_t generation) override;
+	inline void get_edge(const size_t from,
+	                     const Side   side,
+	                     const size_t generation,
+	                     std::byte*   edge) override;
+
+private:
+	/// The start of the segment.
+	struct Control {
+		/// Bumped for every command, after `command` is written.
+		std::atomic<std::uint64_t> sequence;
+		Command                    command;
+		/// Workers done with the current command, and whether any failed.
+		std::atomic<std::uint32_t> done;
+		std::atomic<std::uint32_t> failed;
+		char                       error[256];
+		/// Workers at the barrier, and how many times it was passed.
+		std::atomic<std::uint32_t> arrived;
+		std::atomic<std::uint64_t> passed;
+		/// Set when a worker fails, so the others stop waiting for it.
+		std::atomic<std::uint32_t> aborted;
+	};
+	static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+	              "shared memory needs address-free atomics");
+
+	/// Wait until `ready()`, spinning at first and then sleeping for longer
+	/// and longer, up to a millisecond. `check()` is called now and then and
+	/// may throw to give up.
+	template<typename Ready, typename Check>
+	static inline void wait_until(Ready&& ready, Check&& check);
+	inline std::byte* edge(const size_t worker,
+	                       const Side   side,
+	                       const size_t generation);
+	/// Throw if a worker exited.
+	inline void check_workers();
+	inline void stop_workers();
+
+	size_t           m_workers;
+	size_t           m_edge_bytes;
+	size_t           m_staging_bytes;
+	std::string      m_name;
+	size_t           m_size    = 0;
+	std::byte*       m_segment = nullptr;
+	Control*         m_control = nullptr;
+	std::vector<int> m_pids;
+	/// The last command a worker received, in the worker's process.
+	std::uint64_t m_seen = 0;
+	/// The coordinator's process, which workers stop waiting for if it
+	/// exits.
+	int m_parent = 0;
+};
+#endif
+
+/// An `Automaton` split into vertical slabs that are each stepped by a
+/// worker process, for grids that are too big for one process. Each worker
+/// owns a range of columns, plus copies of the two columns next to it on
+/// each side that it gets from its neighbors every generation. The workers
+/// step in lockstep and the result is the same as stepping the whole grid.
+///
+/// The coordinator only ever holds one slab at a time, in the transport's
+/// staging buffer: `scatter` and `gather` move cells in and out of
+/// anything that can be indexed with `(x, y)`.
+template<typename AutomatonType>
+class Domain {
+public:
+	using State = std::remove_cvref_t<
+	    decltype(std::declval<const AutomatonType&>()(0, 0))>;
+	/// Makes the automaton for a slab, which may also set it up further,
+	/// with `set_threads` for example. Called in the worker.
+	using Factory = std::function<AutomatonType(size_t width, size_t height)>;
+
+	/// Split a `width` by `height` grid over `workers` local processes
+	/// connected by a `SharedMemoryTransport`.
+	inline Domain(const size_t   width,
+	              const size_t   height,
+	              const size_t   workers,
+	              const Boundary boundary = Boundary::dead,
+	              Factory        factory  = default_factory);
+	/// Split it over the workers of `transport`, which must have been made
+	/// with `edge_bytes(height)` and `staging_bytes(width, height, workers)`.
+	inline Domain(const size_t               width,
+	              const size_t               height,
+	              std::unique_ptr<Transport> transport,
+	              const Boundary             boundary = Boundary::dead,
+	              Factory                    factory  = default_factory);
+	inline ~Domain();
+	Domain(const Domain&) = delete;
+	Domain& operator=(const Domain&) = delete;
+
+	/// Copy every cell of `grid`, read as `grid(x, y)`, to the workers.
+	template<typename Grid>
+	inline void scatter(const Grid& grid);
+	/// Copy every cell from the workers into `grid(x, y)`.
+	template<typename Grid>
+	inline void gather(Grid& grid);
+	inline void step(const size_t generations = 1);
+
+	inline size_t width() const;
+	inline size_t height() const;
+	inline size_t workers() const;
+	inline size_t generation() const;
+
+	static inline size_t edge_bytes(const size_t height);
+	static inline size_t staging_bytes(const size_t width,
+	                                   const size_t height,
+	                                   const size_t workers);
+	static inline AutomatonType default_factory(const size_t width,
+	                                            const size_t height);
+
+private:
+	/// Columns copied from each neighbor.
+	static constexpr size_t ghost = 2;
+
+	inline size_t slab_begin(const size_t worker) const;
+	/// Whether a worker has a neighbor on `side`, on a torus they all do.
+	inline bool has_neighbor(const size_t worker, const Side side) const;
+	/// The worker's main loop.
+	inline void work(const size_t worker);
+	inline void execute(AutomatonType& automaton,
+	                    const size_t   worker,
+	                    const Command& command);
+	/// Put the worker's edges, then fill its ghost columns with its
+	/// neighbors'.
+	inline void exchange(AutomatonType& automaton, const size_t worker);
+
+	size_t                     m_width;
+	size_t                     m_height;
+	Boundary                   m_boundary;
+	Factory                    m_factory;
+	std::unique_ptr<Transport> m_transport;
+	size_t                     m_generation = 0;
+
+	static_assert(std::is_trivially_copyable_v<State>,
+	              "cells are copied between processes as bytes");
+};
+
+#ifdef CELLULAR_HAS_SHARED_MEMORY
+inline SharedMemoryTransport::SharedMemoryTransport(
+    const size_t workers,
+    const size_t edge_bytes,
+    const size_t staging_bytes) :
+    m_workers(workers),
+    m_edge_bytes(edge_bytes),
+    m_staging_bytes(staging_bytes),
+    m_parent(::getpid()) {
+	if (workers == 0) { throw std::invalid_argument("no workers"); }
+	// Two generations of two edges for every worker.
+	m_size = sizeof(Control) + 4 * workers * edge_bytes + staging_bytes;
+
+	static std::atomic<unsigned int> segments{0};
+	m_name = "/cellular-" + std::to_string(::getpid()) + '-'
+	         + std::to_string(segments++);
+	const int fd = ::shm_open(m_name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+	if (fd < 0) {
+		throw std::system_error(errno,
+		                        std::generic_category(),
+		                        "can't create shared memory " + m_name);
+	}
+	void* data = MAP_FAILED;
+	if (::ftruncate(fd, static_cast<off_t>(m_size)) == 0) {
+		data = ::mmap(nullptr,
+		              m_size,
+		              PROT_READ | PROT_WRITE,
+		              MAP_SHARED,
+		              fd,
+		              0);
+	}
+	const int error = errno;
+	::close(fd);
+	if (data == MAP_FAILED) {
+		::shm_unlink(m_name.c_str());
+		throw std::system_error(error,
+		                        std::generic_category(),
+		                        "can't map shared memory " + m_name);
+	}
+	m_segment = static_cast<std::byte*>(data);
+	m_control = new (m_segment) Control{};
+}
+
+inline SharedMemoryTransport::~SharedMemoryTransport() {
+	// Workers are forked with the segment mapped, only the coordinator
+	// cleans up.
+	if (::getpid() != m_parent) { return; }
+	stop_workers();
+	m_control->~Control();
+	::munmap(m_segment, m_size);
+	::shm_unlink(m_name.c_str());
+}
+
+inline size_t SharedMemoryTransport::workers() const {
+	return m_workers;
+}
+
+inline void
+SharedMemoryTransport::launch(const std::function<void(size_t)>& work) {
+	for (size_t worker = 0; worker < m_workers; ++worker) {
+		const pid_t pid = ::fork();
+		if (pid < 0) {
+			const int error = errno;
+			stop_workers();
+			throw std::system_error(error,
+			                        std::generic_category(),
+			                        "can't start worker");
+		}
+		if (pid == 0) {
+			// `_exit` skips the destructors and `atexit` handlers of the
+			// coordinator's copy of everything.
+			try {
+				work(worker);
+			} catch (...) {
+				::_exit(1);
+			}
+			::_exit(0);
+		}
+		m_pids.push_back(pid);
+	}
+}
+
+inline void SharedMemoryTransport::run(const Command& command) {
+	// Every worker is idle, and a failed step may have left some of them at
+	// the barrier.
+	m_control->done.store(0, std::memory_order_relaxed);
+	m_control->failed.store(0, std::memory_order_relaxed);
+	m_control->aborted.store(0, std::memory_order_relaxed);
+	m_control->arrived.store(0, std::memory_order_relaxed);
+	m_control->command = command;
+	m_control->sequence.fetch_add(1, std::memory_order_release);
+	wait_until(
+	    [this] {
+		    return m_control->done.load(std::memory_order_acquire)
+		           == m_workers;
+	    },
+	    [this] { check_workers(); });
+	if (m_control->failed.load(std::memory_order_acquire) != 0) {
+		throw std::runtime_error(std::string("worker failed: ")
+		                         + m_control->error);
+	}
+}
+
+inline std::byte* SharedMemoryTransport::staging() {
+	return m_segment + sizeof(Control) + 4 * m_workers * m_edge_bytes;
+}
+
+inline Command SharedMemoryTransport::receive(size_t) {
+	wait_until(
+	    [this] {
+		    return m_control->sequence.load(std::memory_order_acquire)
+		           != m_seen;
+	    },
+	    [this] {
+		    if (::getppid() != m_parent) { ::_exit(1); }
+	    });
+	m_seen = m_control->sequence.load(std::memory_order_acquire);
+	return m_control->command;
+}
+
+inline void SharedMemoryTransport::complete(size_t, const char* error) {
+	if (error != nullptr
+	    && m_control->failed.exchange(1, std::memory_order_acq_rel) == 0) {
+		std::strncpy(m_control->error, error, sizeof(m_control->error) - 1);
+		m_control->error[sizeof(m_control->error) - 1] = '\0';
+	}
+	if (error != nullptr) {
+		m_control->aborted.store(1, std::memory_order_release);
+	}
+	m_control->done.fetch_add(1, std::memory_order_acq_rel);
+}
+
+inline std::byte* SharedMemoryTransport::edge(const size_t worker,
+                                              const Side   side,
+                                              const size_t generation) {
+	const size_t slot = ((generation % 2) * m_workers + worker) * 2
+	                    + (side == Side::left ? 0 : 1);
+	return m_segment + sizeof(Control) + slot * m_edge_bytes;
+}
+
+inline void SharedMemoryTransport::put_edge(const size_t     worker,
+                                            const Side       side,
+                                            const size_t     generation,
+                                            const std::byte* data) {
+	std::memcpy(edge(worker, side, generation), data, m_edge_bytes);
+}
+
+inline void SharedMemoryTransport::barrier(size_t, size_t) {
+	// The count of passes is read before arriving, the last worker to
+	// arrive resets the count and lets the others through.
+	const std::uint64_t passed =
+	    m_control->passed.load(std::memory_order_acquire);
+	if (m_control->arrived.fetch_add(1, std::memory_order_acq_rel) + 1
+	    == m_workers) {
+		m_control->arrived.store(0, std::memory_order_relaxed);
+		m_control->passed.fetch_add(1, std::memory_order_release);
+		return;
+	}
+	wait_until(
+	    [&] {
+		    return m_control->passed.load(std::memory_order_acquire)
+		           != passed;
+	    },
+	    [this] {
+		    if (m_control->aborted.load(std::memory_order_acquire) != 0) {
+			    throw std::runtime_error("stepping was aborted");
+		    }
+	    });
+}
+
+inline void SharedMemoryTransport::get_edge(const size_t from,
+                                            const Side   side,
+                                            const size_t generation,
+                                            std::byte*   data) {
+	std::memcpy(data, edge(from, side, generation), m_edge_bytes);
+}
+
+template<typename Ready, typename Check>
+inline void SharedMemoryTransport::wait_until(Ready&& ready, Check&& check) {
+	long sleep_ns = 1000;
+	for (unsigned int round = 0; !ready(); ++round) {
+		if (round < 64) { continue; }
+		if (round < 256) {
+			::sched_yield();
+			continue;
+		}
+		check();
+		const timespec duration{0, sleep_ns};
+		::nanosleep(&duration, nullptr);
+		sleep_ns = std::min(sleep_ns * 2, 1000000L);
+	}
+}
+
+inline void SharedMemoryTransport::check_workers() {
+	for (size_t i = 0; i < m_pids.size(); ++i) {
+		const int pid = m_pids[i];
+		if (::waitpid(pid, nullptr, WNOHANG) == pid) {
+			// The rest may be waiting at the barrier for it.
+			m_pids.erase(m_pids.begin() + static_cast<std::ptrdiff_t>(i));
+			stop_workers();
+			throw std::runtime_error("worker " + std::to_string(i)
+			                         + " exited");
+		}
+	}
+}
+
+inline void SharedMemoryTransport::stop_workers() {
+	for (const int pid : m_pids) { ::kill(pid, SIGKILL); }
+	for (const int pid : m_pids) { ::waitpid(pid, nullptr, 0); }
+	m_pids.clear();
+}
+#endif
+
+template<typename A>
+inline Domain<A>::Domain(const size_t   width,
+                         const size_t   height,
+                         const size_t   workers,
+                         const Boundary boundary,
+                         Factory        factory) :
+#ifdef CELLULAR_HAS_SHARED_MEMORY
+    Domain(width,
+           height,
+           std::make_unique<SharedMemoryTransport>(
+               workers,
+               edge_bytes(height),
+               staging_bytes(width, height, workers)),
+           boundary,
+           std::move(factory)) {
+}
+#else
+    m_width(width),
+    m_height(height),
+    m_boundary(boundary) {
+	throw std::runtime_error("no shared memory transport on this platform");
+}
+#endif
+
+template<typename A>
+inline Domain<A>::Domain(const size_t               width,
+                         const size_t               height,
+                         std::unique_ptr<Transport> transport,
+                         const Boundary             boundary,
+                         Factory                    factory) :
+    m_width(width),
+    m_height(height),
+    m_boundary(boundary),
+    m_factory(std::move(factory)),
+    m_transport(std::move(transport)) {
+	// A worker's edges are its outermost columns, so every slab needs
+	// enough of them.
+	if (width < ghost * m_transport->workers() || height == 0) {
+		throw std::invalid_argument("grid too small for "
+		                            + std::to_string(m_transport->workers())
+		                            + " workers");
+	}
+	m_transport->launch([this](const size_t worker) { work(worker); });
+	// Stepping no generations reports the workers that failed to start.
+	m_transport->run({Command::Op::step});
+}
+
+template<typename A>
+inline Domain<A>::~Domain() {
+	try {
+		m_transport->run({Command::Op::quit});
+	} catch (const std::exception&) {
+		// The transport stops whatever workers are left.
+	}
+}
+
+template<typename A>
+template<typename Grid>
+inline void Domain<A>::scatter(const Grid& grid) {
+	State* const staging = reinterpret_cast<State*>(m_transport->staging());
+	for (size_t worker = 0; worker < workers(); ++worker) {
+		const size_t begin = slab_begin(worker);
+		const size_t end   = slab_begin(worker + 1);
+		for (size_t x = begin; x < end; ++x) {
+			for (size_t y = 0; y < m_height; ++y) {
+				staging[(x - begin) * m_height + y] = grid(x, y);
+			}
+		}
+		m_transport->run(
+		    {Command::Op::load, static_cast<std::uint32_t>(worker)});
+	}
+}
+
+template<typename A>
+template<typename Grid>
+inline void Domain<A>::gather(Grid& grid) {
+	const State* const staging =
+	    reinterpret_cast<const State*>(m_transport->staging());
+	for (size_t worker = 0; worker < workers(); ++worker) {
+		m_transport->run(
+		    {Command::Op::store, static_cast<std::uint32_t>(worker)});
+		const size_t begin = slab_begin(worker);
+		const size_t end   = slab_begin(worker + 1);
+		for (size_t x = begin; x < end; ++x) {
+			for (size_t y = 0; y < m_height; ++y) {
+				grid(x, y) = staging[(x - begin) * m_height + y];
+			}
+		}
+	}
+}
+
+template<typename A>
+inline void Domain<A>::step(const size_t generations) {
+	if (generations == 0) { return; }
+	m_transport->run({Command::Op::step, 0, generations});
+	m_generation += generations;
+}
+
+template<typename A>
+inline size_t Domain<A>::width() const {
+	return m_width;
+}
+
+template<typename A>
+inline size_t Domain<A>::height() const {
+	return m_height;
+}
+
+template<typename A>
+inline size_t Domain<A>::workers() const {
+	return m_transport->workers();
+}
+
+template<typename A>
+inline size_t Domain<A>::generation() const {
+	return m_generation;
+}
+
+template<typename A>
+inline size_t Domain<A>::edge_bytes(const size_t height) {
+	return ghost * height * sizeof(State);
+}
+
+template<typename A>
+inline size_t Domain<A>::staging_bytes(const size_t width,
+                                       const size_t height,
+                                       const size_t workers) {
+	// The widest slab.
+	return (width + workers - 1) / workers * height * sizeof(State);
+}
+
+template<typename A>
+inline A Domain<A>::default_factory(const size_t width, const size_t height) {
+	return A(width, height);
+}
+
+template<typename A>
+inline size_t Domain<A>::slab_begin(const size_t worker) const {
+	return worker * m_width / workers();
+}
+
+template<typename A>
+inline bool Domain<A>::has_neighbor(const size_t worker,
+                                    const Side   side) const {
+	if (m_boundary == Boundary::toroidal) { return true; }
+	return side == Side::left ? worker > 0 : worker + 1 < workers();
+}
+
+template<typename A>
+inline void Domain<A>::work(const size_t worker) {
+	// The slab with the ghost columns on the sides that have a neighbor.
+	// Ghost columns are stepped along with the rest, but the cells they
+	// get wrong are overwritten before anything reads them.
+	const size_t width = slab_begin(worker + 1) - slab_begin(worker)
+	                     + (has_neighbor(worker, Side::left) ? ghost : 0)
+	                     + (has_neighbor(worker, Side::right) ? ghost : 0);
+	std::optional<A> automaton;
+	std::string      failure;
+	try {
+		automaton.emplace(m_factory(width, m_height));
+		automaton->set_boundary(m_boundary);
+	} catch (const std::exception& error) {
+		failure = error.what();
+	}
+
+	while (true) {
+		const Command command = m_transport->receive(worker);
+		if (command.op == Command::Op::quit) {
+			m_transport->complete(worker);
+			return;
+		}
+		if (!automaton) {
+			m_transport->complete(worker, failure.c_str());
+			continue;
+		}
+		try {
+			execute(*automaton, worker, command);
+			m_transport->complete(worker);
+		} catch (const std::exception& error) {
+			m_transport->complete(worker, error.what());
+		}
+	}
+}
+
+template<typename A>
+inline void Domain<A>::execute(A&             automaton,
+                               const size_t   worker,
+                               const Command& command) {
+	const size_t left  = has_neighbor(worker, Side::left) ? ghost : 0;
+	const size_t owned = slab_begin(worker + 1) - slab_begin(worker);
+	switch (command.op) {
+	case Command::Op::load:
+	case Command::Op::store: {
+		if (command.worker != worker) { break; }
+		State* const staging =
+		    reinterpret_cast<State*>(m_transport->staging());
+		for (size_t x = 0; x < owned; ++x) {
+			for (size_t y = 0; y < m_height; ++y) {
+				State& cell = staging[x * m_height + y];
+				if (command.op == Command::Op::load) {
+					automaton(left + x, y) = cell;
+				} else {
+					cell = automaton(left + x, y);
+				}
+			}
+		}
+		break;
+	}
+	case Command::Op::step: {
+		for (std::uint64_t i = 0; i < command.generations; ++i) {
+			exchange(automaton, worker);
+			automaton.step();
+		}
+		break;
+	}
+	case Command::Op::quit: {
+		break;
+	}
+	}
+}
+
+template<typename A>
+inline void Domain<A>::exchange(A& automaton, const size_t worker) {
+	const size_t       left  = has_neighbor(worker, Side::left) ? ghost : 0;
+	const size_t       owned = slab_begin(worker + 1) - slab_begin(worker);
+	const size_t       generation = automaton.generation();
+	std::vector<State> edge(ghost * m_height);
+	auto               bytes = [&edge] {
+		return reinterpret_cast<std::byte*>(edge.data());
+	};
+	// Columns [`x`, `x + ghost`) of the slab to or from `edge`.
+	auto copy_out = [&](const size_t x) {
+		for (size_t i = 0; i < ghost; ++i) {
+			for (size_t y = 0; y < m_height; ++y) {
+				edge[i * m_height + y] = automaton(x + i, y);
+			}
+		}
+	};
+	auto copy_in = [&](const size_t x) {
+		for (size_t i = 0; i < ghost; ++i) {
+			for (size_t y = 0; y < m_height; ++y) {
+				automaton(x + i, y) = edge[i * m_height + y];
+			}
+		}
+	};
+
+	const bool has_left  = has_neighbor(worker, Side::left);
+	const bool has_right = has_neighbor(worker, Side::right);
+	if (has_left) {
+		copy_out(left);
+		m_transport->put_edge(worker, Side::left, generation, bytes());
+	}
+	if (has_right) {
+		copy_out(left + owned - ghost);
+		m_transport->put_edge(worker, Side::right, generation, bytes());
+	}
+	m_transport->barrier(worker, generation);
+	const size_t n = workers();
+	if (has_left) {
+		m_transport->get_edge((worker + n - 1) % n,
+		                      Side::right,
+		                      generation,
+		                      bytes());
+		copy_in(0);
+	}
+	if (has_right) {
+		m_transport->get_edge((worker + 1) % n,
+		                      Side::left,
+		                      generation,
+		                      bytes());
+		copy_in(left + owned);
+	}
+}
+
+} // namespace cellular
+
+#endif // CELLULAR_DOMAIN_HPP_
@@ -0,0 +1,421 @@
+#ifndef CELLULAR_EXPORT_HPP_
+#define CELLULAR_EXPORT_HPP_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "cellular_stream.hpp"
+
+namespace cellular {
+
+struct Rgb {
+	std::uint8_t r = 0;
+	std::uint8_t g = 0;
+	std::uint8_t b = 0;
+
+	constexpr bool operator==(const Rgb& other) const = default;
+	/// Rec. 601 luma, what the gray formats store.
+	constexpr std::uint8_t gray() const {
+		return static_cast<std::uint8_t>((299 * r + 587 * g + 114 * b) / 1000);
+	}
+};
+
+/// The color of every state of `StateType` in exported frames, black unless
+/// set.
+template<typename StateType>
+class Palette {
+	static_assert(sizeof(StateType) == 1, "states are looked up by byte");
+
+public:
+	Palette() = default;
+	inline Palette(std::initializer_list<std::pair<StateType, Rgb>> colors);
+	inline void set(const StateType state, const Rgb color);
+	inline Rgb  operator()(const StateType state) const;
+
+private:
+	static inline size_t index(const StateType state);
+
+	std::array<Rgb, 256> m_colors{};
+};
+
+template<typename T>
+inline Palette<T>::Palette(std::initializer_list<std::pair<T, Rgb>> colors) {
+	for (const auto& [state, color] : colors) { set(state, color); }
+}
+
+template<typename T>
+inline void Palette<T>::set(const T state, const Rgb color) {
+	m_colors[index(state)] = color;
+}
+
+template<typename T>
+inline Rgb Palette<T>::operator()(const T state) const {
+	return m_colors[index(state)];
+}
+
+template<typename T>
+inline size_t Palette<T>::index(const T state) {
+	std::uint8_t byte;
+	std::memcpy(&byte, &state, 1);
+	return byte;
+}
+
+enum class FrameFormat {
+	/// A binary PPM (P6) file per frame.
+	ppm,
+	/// A binary PGM (P5) file per frame, with the palette's colors as gray.
+	pgm,
+	/// The RGB pixels of every frame back to back in one stream, headerless
+	/// video that e.g. `ffmpeg -f rawvideo -pix_fmt rgb24 -s WxH -i -` reads.
+	raw_rgb,
+	/// The same with a gray byte per pixel, `-pix_fmt gray`.
+	raw_gray,
+};
+
+struct ExportOptions {
+	FrameFormat format = FrameFormat::ppm;
+	/// Where the PPM and PGM files go, named after the generation they're
+	/// of, e.g. `000042.ppm`, or after the order they were submitted in for
+	/// grids that don't keep count.
+	std::filesystem::path directory = ".";
+	/// Where the raw formats go, such as `std::cout`. Has to outlive the
+	/// exporter.
+	std::ostream* stream = nullptr;
+	/// Side of a cell in pixels.
+	size_t scale = 1;
+	/// Threads that encode and write frames.
+	size_t workers = 2;
+	/// Frames that can wait for a worker before `submit` blocks.
+	size_t queue = 8;
+};
+
+/// Writes grids as image frames on background threads. `submit` copies the
+/// grid into one of `queue` snapshots and returns, so the simulation only
+/// waits for the exporter when every snapshot is still waiting to be
+/// encoded. Workers encode frames in parallel, and write files in whatever
+/// order they finish in but the raw stream in the order they were
+/// submitted.
+template<typename StateType>
+class FrameExporter {
+public:
+	/// Throws `std::invalid_argument` for a raw format without a stream, or
+	/// a scale, worker count or queue of 0.
+	inline FrameExporter(Palette<StateType> palette, ExportOptions options);
+	FrameExporter(const FrameExporter&) = delete;
+	FrameExporter& operator=(const FrameExporter&) = delete;
+	/// Finishes, ignoring errors. Call `finish` to get them.
+	inline ~FrameExporter();
+	/// Queue a copy of `grid`, anything with `width`, `height` and a const
+	/// `operator()`, as the frame of `generation`. Waits for room in the
+	/// queue, and rethrows the first error a worker ran into.
+	template<typename Grid>
+	inline void submit(const Grid& grid, const size_t generation);
+	/// `submit` with the generation the grid says it's in. Frames of grids
+	/// that don't keep count are numbered in the order they're submitted.
+	template<typename Grid>
+	inline void submit(const Grid& grid);
+	/// Wait for every frame to be written and stop the workers. Rethrows
+	/// the first error a worker ran into. No frames can be submitted after.
+	inline void finish();
+	/// Amount of frames written so far.
+	inline size_t written() const;
+
+private:
+	template<typename Grid>
+	inline void enqueue(const Grid& grid, std::optional<size_t> generation);
+	inline void work();
+	inline void encode(const Snapshot<StateType>& frame,
+	                   std::vector<std::uint8_t>& bytes) const;
+	inline void write(const std::vector<std::uint8_t>& bytes,
+	                  const size_t                     number,
+	                  const size_t                     sequence);
+	/// Record the first error and wake everyone waiting, so they give up.
+	inline void fail(std::exception_ptr error);
+	inline bool gray() const;
+	inline bool raw() const;
+
+	Palette<StateType> m_palette;
+	ExportOptions      m_options;
+	/// `m_frames[i]` is submitted as the `m_sequence[i]`th frame, and named
+	/// after that instead of its generation if `m_unnumbered[i]`.
+	std::vector<Snapshot<StateType>> m_frames;
+	std::vector<size_t>              m_sequence;
+	std::vector<char>                m_unnumbered;
+	/// Indices into `m_frames`, by whether they're free or waiting.
+	std::deque<size_t>      m_free;
+	std::deque<size_t>      m_pending;
+	size_t                  m_submitted = 0;
+	bool                    m_stopping  = false;
+	std::atomic<bool>       m_failed    = false;
+	std::exception_ptr      m_error;
+	std::mutex              m_mutex;
+	std::condition_variable m_changed;
+	/// Raw frames are written in turn, the `m_next_write`th one next.
+	std::mutex               m_write_mutex;
+	std::condition_variable  m_turn;
+	size_t                   m_next_write = 0;
+	std::atomic<size_t>      m_written    = 0;
+	std::vector<std::thread> m_workers;
+};
+
+template<typename T>
+inline FrameExporter<T>::FrameExporter(Palette<T>    palette,
+                                       ExportOptions options) :
+    m_palette(std::move(palette)),
+    m_options(std::move(options)),
+    m_frames(m_options.queue),
+    m_sequence(m_options.queue),
+    m_unnumbered(m_options.queue) {
+	if (raw() && m_options.stream == nullptr) {
+		throw std::invalid_argument("raw frames need a stream");
+	}
+	if (m_options.scale == 0 || m_options.workers == 0
+	    || m_options.queue == 0) {
+		throw std::invalid_argument(
+		    "the scale, workers and queue have to be at least 1");
+	}
+	for (size_t i = 0; i < m_options.queue; ++i) { m_free.push_back(i); }
+	for (size_t i = 0; i < m_options.workers; ++i) {
+		m_workers.emplace_back([this] { work(); });
+	}
+}
+
+template<typename T>
+inline FrameExporter<T>::~FrameExporter() {
+	try {
+		finish();
+	} catch (...) {}
+}
+
+template<typename T>
+template<typename Grid>
+inline void FrameExporter<T>::submit(const Grid&  grid,
+                                     const size_t generation) {
+	enqueue(grid, generation);
+}
+
+template<typename T>
+template<typename Grid>
+inline void FrameExporter<T>::submit(const Grid& grid) {
+	if constexpr (requires { grid.generation(); }) {
+		submit(grid, detail::generation_of(grid));
+	} else {
+		// All of them would be generation 0 and overwrite each other.
+		enqueue(grid, std::nullopt);
+	}
+}
+
+template<typename T>
+template<typename Grid>
+inline void FrameExporter<T>::enqueue(const Grid&           grid,
+                                      std::optional<size_t> generation) {
+	size_t slot;
+	{
+		std::unique_lock lock(m_mutex);
+		if (m_stopping) {
+			throw std::logic_error("frames submitted after finish");
+		}
+		m_changed.wait(lock, [this] { return m_failed || !m_free.empty(); });
+		if (m_failed) { std::rethrow_exception(m_error); }
+		slot = m_free.front();
+		m_free.pop_front();
+	}
+	// The slot is ours alone until it's pending.
+	m_frames[slot].assign(grid, generation.value_or(0));
+	m_unnumbered[slot] = !generation;
+	{
+		// Numbered as it's queued, so workers take frames in order and the
+		// raw stream never waits for one that's still queued.
+		std::lock_guard lock(m_mutex);
+		m_sequence[slot] = m_submitted++;
+		m_pending.push_back(slot);
+	}
+	m_changed.notify_all();
+}
+
+template<typename T>
+inline void FrameExporter<T>::finish() {
+	{
+		std::lock_guard lock(m_mutex);
+		m_stopping = true;
+	}
+	m_changed.notify_all();
+	for (std::thread& worker : m_workers) {
+		if (worker.joinable()) { worker.join(); }
+	}
+	if (m_failed) { std::rethrow_exception(m_error); }
+	if (raw()) { m_options.stream->flush(); }
+}
+
+template<typename T>
+inline size_t FrameExporter<T>::written() const {
+	return m_written;
+}
+
+template<typename T>
+inline void FrameExporter<T>::work() {
+	std::vector<std::uint8_t> bytes;
+	for (;;) {
+		size_t slot;
+		{
+			std::unique_lock lock(m_mutex);
+			m_changed.wait(lock, [this] {
+				return m_failed || m_stopping || !m_pending.empty();
+			});
+			if (m_failed || m_pending.empty()) { return; }
+			slot = m_pending.front();
+			m_pending.pop_front();
+		}
+		const size_t sequence = m_sequence[slot];
+		const size_t number =
+		    m_unnumbered[slot] ? sequence : m_frames[slot].generation();
+		try {
+			encode(m_frames[slot], bytes);
+		} catch (...) {
+			fail(std::current_exception());
+			return;
+		}
+		// Free the snapshot before writing, to unblock `submit` sooner.
+		{
+			std::lock_guard lock(m_mutex);
+			m_free.push_back(slot);
+		}
+		m_changed.notify_all();
+		try {
+			write(bytes, number, sequence);
+		} catch (...) {
+			fail(std::current_exception());
+			return;
+		}
+		++m_written;
+	}
+}
+
+template<typename T>
+inline void FrameExporter<T>::encode(const Snapshot<T>&         frame,
+                                     std::vector<std::uint8_t>& bytes) const {
+	const size_t scale    = m_options.scale;
+	const size_t width    = frame.width() * scale;
+	const size_t height   = frame.height() * scale;
+	const size_t channels = gray() ? 1 : 3;
+	const size_t row_size = width * channels;
+
+	bytes.clear();
+	if (!raw()) {
+		const std::string header = (gray() ? "P5\n" : "P6\n")
+		                           + std::to_string(width) + ' '
+		                           + std::to_string(height) + "\n255\n";
+		bytes.assign(header.begin(), header.end());
+	}
+	const size_t offset = bytes.size();
+	bytes.resize(offset + row_size * height);
+
+	// Rows of pixels run along x but cells are stored along y, so go through
+	// the grid a strip of `strip` lines at a time to keep reading the same
+	// few cache lines of each.
+	constexpr size_t strip = 32;
+	for (size_t left = 0; left < frame.width(); left += strip) {
+		const size_t right = std::min(left + strip, frame.width());
+		for (size_t y = 0; y < frame.height(); ++y) {
+			std::uint8_t* out =
+			    &bytes[offset + y * scale * row_size + left * scale * channels];
+			for (size_t x = left; x < right; ++x) {
+				const Rgb color = m_palette(frame(x, y));
+				for (size_t i = 0; i < scale; ++i) {
+					if (channels == 1) {
+						*out++ = color.gray();
+					} else {
+						*out++ = color.r;
+						*out++ = color.g;
+						*out++ = color.b;
+					}
+				}
+			}
+		}
+	}
+	// The rest of a row of cells repeats its first row of pixels.
+	for (size_t y = 0; y < frame.height(); ++y) {
+		std::uint8_t* row = &bytes[offset + y * scale * row_size];
+		for (size_t i = 1; i < scale; ++i) {
+			std::memcpy(row + i * row_size, row, row_size);
+		}
+	}
+}
+
+template<typename T>
+inline void FrameExporter<T>::write(const std::vector<std::uint8_t>& bytes,
+                                    const size_t number,
+                                    const size_t sequence) {
+	if (!raw()) {
+		char name[32];
+		std::snprintf(
+		    name, sizeof(name), "%06zu.%s", number, gray() ? "pgm" : "ppm");
+		const std::filesystem::path path = m_options.directory / name;
+		std::ofstream               file(path, std::ios::binary);
+		file.write(reinterpret_cast<const char*>(bytes.data()),
+		           static_cast<std::streamsize>(bytes.size()));
+		if (!file) {
+			throw std::runtime_error("can't write " + path.string());
+		}
+		return;
+	}
+
+	std::unique_lock lock(m_write_mutex);
+	m_turn.wait(lock, [&] { return m_failed || m_next_write == sequence; });
+	if (m_failed) { return; }
+	m_options.stream->write(reinterpret_cast<const char*>(bytes.data()),
+	                        static_cast<std::streamsize>(bytes.size()));
+	if (!*m_options.stream) {
+		throw std::runtime_error("can't write the frame stream");
+	}
+	++m_next_write;
+	m_turn.notify_all();
+}
+
+template<typename T>
+inline void FrameExporter<T>::fail(std::exception_ptr error) {
+	{
+		std::lock_guard lock(m_mutex);
+		if (!m_error) { m_error = std::move(error); }
+		m_failed = true;
+	}
+	m_changed.notify_all();
+	// Taken so that no writer checks the flag before it's set and waits
+	// after it's notified.
+	{ std::lock_guard lock(m_write_mutex); }
+	m_turn.notify_all();
+}
+
+template<typename T>
+inline bool FrameExporter<T>::gray() const {
+	return m_options.format == FrameFormat::pgm
+	       || m_options.format == FrameFormat::raw_gray;
+}
+
+template<typename T>
+inline bool FrameExporter<T>::raw() const {
+	return m_options.format == FrameFormat::raw_rgb
+	       || m_options.format == FrameFormat::raw_gray;
+}
+
+} // namespace cellular
+
+#endif // CELLULAR_EXPORT_HPP_
@@ -0,0 +1,56 @@
+#ifndef CELLULAR_HASH_HPP_
+#define CELLULAR_HASH_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cellular {
+
+/// How `Automaton::run_until_stable` stopped.
+struct Stabilization {
+	enum class Kind {
+		/// No generation repeated within the generations it was given.
+		unsettled,
+		/// Every cell is in the default state, and stays there.
+		extinct,
+		/// The grid stopped changing.
+		still,
+		/// The grid cycles through `period` generations.
+		oscillating,
+	};
+
+	Kind kind = Kind::unsettled;
+	/// Generations between repeats, 1 for still lifes and extinction and 0
+	/// if unsettled.
+	size_t period = 0;
+	/// The first generation of the cycle, or the generation it gave up at if
+	/// unsettled.
+	size_t generation = 0;
+};
+
+namespace detail {
+	/// splitmix64's finalizer.
+	constexpr std::uint64_t mix(std::uint64_t z) {
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+		return z ^ (z >> 31);
+	}
+
+	/// The Zobrist key of the cell at (x, y) being in the state whose bits
+	/// are `state`. Computed rather than looked up in a table, which would
+	/// take more memory than the grid. The default state's key is 0, so a
+	/// grid with every cell in it hashes to 0.
+	constexpr std::uint64_t zobrist_key(const size_t        x,
+	                                    const size_t        y,
+	                                    const std::uint64_t state) {
+		const std::uint64_t cell = static_cast<std::uint64_t>(x) << 32 ^ y;
+		// Masked rather than branched on, whether a changing cell was in the
+		// default state is a coin flip.
+		const std::uint64_t keep = 0 - static_cast<std::uint64_t>(state != 0);
+		return mix(cell ^ state * 0x9e3779b97f4a7c15) & keep;
+	}
+} // namespace detail
+
+} // namespace cellular
+
+#endif // CELLULAR_HASH_HPP_
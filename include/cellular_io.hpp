@@ -0,0 +1,473 @@
+#ifndef CELLULAR_IO_HPP_
+#define CELLULAR_IO_HPP_
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CELLULAR_HAS_MMAP 1
+#else
+#include <fstream>
+#include <iterator>
+#endif
+
+namespace cellular::io {
+
+/// A view of a whole file. The file is memory-mapped where that's supported,
+/// so that pages are read in as a parser walks over them and can be dropped
+/// again by the OS once it's past them, instead of the file being copied
+/// into memory up front.
+class MappedFile {
+public:
+	enum class Mode {
+		read_only,
+		/// Writable through `data`, with writes going to private copies of
+		/// the pages that are never written back to the file.
+		copy_on_write,
+	};
+
+	inline explicit MappedFile(const std::filesystem::path& filename,
+	                           const Mode mode = Mode::read_only);
+	inline ~MappedFile();
+	inline MappedFile(MappedFile&& other) noexcept;
+	inline MappedFile& operator=(MappedFile&& other) noexcept;
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	inline std::string_view view() const;
+	/// The contents, which may only be written to in `Mode::copy_on_write`.
+	inline char* data();
+
+private:
+#ifdef CELLULAR_HAS_MMAP
+	char*       m_data = nullptr;
+	size_t      m_size = 0;
+#else
+	std::string m_data;
+#endif
+};
+
+/// Text formats that grids can be loaded from.
+enum class Format {
+	/// One character per cell in the automaton's own `char_to_state`
+	/// characters, lines separated by a delimiter.
+	plain,
+	/// Run length encoded, as written by Golly and most other Life
+	/// programs.
+	rle,
+	/// Coordinates of the live cells, one pair per line.
+	life_1_06,
+};
+
+/// Guess the format of `text` from its header: a "#Life 1.06" line, or a
+/// "x = ..." line after any '#' comment lines for RLE. Only the start of
+/// `text` is looked at, since plain grids can have lines starting with '#'
+/// too.
+inline Format detect_format(std::string_view text);
+
+/// Parse `text` in `format` in a single pass, calling `resize(width,
+/// height)` once with the grid's dimensions before any cell is set. Plain
+/// text then calls `set_char(x, y, c)` for every cell. The other formats
+/// only call `set_state(x, y, index)` for the cells that aren't in state 0,
+/// which the grid starts out in. Malformed input throws
+/// `std::invalid_argument`.
+template<typename Resize, typename SetChar, typename SetState>
+inline void parse(std::string_view text,
+                  Format           format,
+                  char             delimiter,
+                  Resize&&         resize,
+                  SetChar&&        set_char,
+                  SetState&&       set_state);
+
+/// `parse` in the detected format.
+template<typename Resize, typename SetChar, typename SetState>
+inline void parse(std::string_view text,
+                  char             delimiter,
+                  Resize&&         resize,
+                  SetChar&&        set_char,
+                  SetState&&       set_state);
+
+#ifdef CELLULAR_HAS_MMAP
+inline MappedFile::MappedFile(const std::filesystem::path& filename,
+                              const Mode                   mode) {
+	const int fd = ::open(filename.c_str(), O_RDONLY);
+	if (fd < 0) {
+		throw std::system_error(errno,
+		                        std::generic_category(),
+		                        "can't open " + filename.string());
+	}
+	struct stat info {};
+	if (::fstat(fd, &info) != 0) {
+		const int error = errno;
+		::close(fd);
+		throw std::system_error(error,
+		                        std::generic_category(),
+		                        "can't stat " + filename.string());
+	}
+	m_size = static_cast<size_t>(info.st_size);
+	// `mmap` doesn't take empty mappings, an empty file is an empty view.
+	if (m_size != 0) {
+		const int   protection = mode == Mode::copy_on_write
+		                             ? PROT_READ | PROT_WRITE
+		                             : PROT_READ;
+		void* const data =
+		    ::mmap(nullptr, m_size, protection, MAP_PRIVATE, fd, 0);
+		if (data == MAP_FAILED) {
+			const int error = errno;
+			::close(fd);
+			throw std::system_error(error,
+			                        std::generic_category(),
+			                        "can't map " + filename.string());
+		}
+		::madvise(data, m_size, MADV_SEQUENTIAL);
+		m_data = static_cast<char*>(data);
+	}
+	::close(fd);
+}
+
+inline MappedFile::~MappedFile() {
+	if (m_data != nullptr) {
+		::munmap(m_data, m_size);
+	}
+}
+
+inline MappedFile::MappedFile(MappedFile&& other) noexcept :
+    m_data(std::exchange(other.m_data, nullptr)),
+    m_size(std::exchange(other.m_size, 0)) {}
+
+inline MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+	std::swap(m_data, other.m_data);
+	std::swap(m_size, other.m_size);
+	return *this;
+}
+
+inline std::string_view MappedFile::view() const {
+	return {m_data, m_size};
+}
+
+inline char* MappedFile::data() {
+	return m_data;
+}
+#else
+// The copy is writable either way.
+inline MappedFile::MappedFile(const std::filesystem::path& filename,
+                              Mode) {
+	std::ifstream filein(filename, std::ios::binary);
+	if (!filein) {
+		throw std::system_error(std::make_error_code(std::errc::io_error),
+		                        "can't open " + filename.string());
+	}
+	m_data.assign(std::istreambuf_iterator<char>(filein),
+	              std::istreambuf_iterator<char>());
+}
+
+inline MappedFile::~MappedFile() = default;
+
+inline MappedFile::MappedFile(MappedFile&& other) noexcept = default;
+
+inline MappedFile& MappedFile::operator=(MappedFile&& other) noexcept =
+    default;
+
+inline std::string_view MappedFile::view() const {
+	return m_data;
+}
+
+inline char* MappedFile::data() {
+	return m_data.data();
+}
+#endif
+
+namespace detail {
+	/// Splits text into lines without copying it. Carriage returns at the
+	/// end of lines are dropped.
+	class LineReader {
+	public:
+		explicit LineReader(const std::string_view text) : m_text(text) {}
+
+		bool next(std::string_view& line) {
+			if (m_position >= m_text.size()) { return false; }
+			size_t end = m_text.find('\n', m_position);
+			if (end == std::string_view::npos) { end = m_text.size(); }
+			line = m_text.substr(m_position, end - m_position);
+			if (!line.empty() && line.back() == '\r') { line.remove_suffix(1); }
+			m_position = end + 1;
+			return true;
+		}
+		/// What hasn't been read yet.
+		std::string_view rest() const {
+			return m_text.substr(std::min(m_position, m_text.size()));
+		}
+
+	private:
+		std::string_view m_text;
+		size_t           m_position = 0;
+	};
+
+	inline bool is_space(const char c) {
+		return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+	}
+
+	inline std::string_view trim(std::string_view text) {
+		while (!text.empty() && is_space(text.front())) {
+			text.remove_prefix(1);
+		}
+		while (!text.empty() && is_space(text.back())) {
+			text.remove_suffix(1);
+		}
+		return text;
+	}
+
+	/// Parse the integer at the start of `text` and drop it from `text`.
+	template<typename Integer>
+	inline Integer take_integer(std::string_view& text) {
+		text = trim(text);
+		Integer value{};
+		const auto [end, error] =
+		    std::from_chars(text.data(), text.data() + text.size(), value);
+		if (error != std::errc()) {
+			throw std::invalid_argument("expected a number at \""
+			                            + std::string(text.substr(0, 16))
+			                            + '"');
+		}
+		text.remove_prefix(static_cast<size_t>(end - text.data()));
+		return value;
+	}
+
+	template<typename Resize, typename SetChar>
+	inline void parse_plain(const std::string_view text,
+	                        const char             delimiter,
+	                        Resize&&               resize,
+	                        SetChar&&              set_char) {
+		const size_t width = text.find(delimiter);
+		if (text.empty() || width == 0) {
+			throw std::invalid_argument("the grid is empty");
+		}
+		if (width == std::string_view::npos) {
+			// A single line without a delimiter.
+			resize(text.size(), size_t{1});
+			for (size_t x = 0; x < text.size(); ++x) {
+				set_char(x, size_t{0}, text[x]);
+			}
+			return;
+		}
+
+		// Every line is `width` cells and a delimiter, except that the last
+		// one doesn't need the delimiter.
+		const size_t stride = width + 1;
+		const size_t height = (text.size() + 1) / stride;
+		if (height * stride != text.size()
+		    && height * stride != text.size() + 1) {
+			throw std::invalid_argument("lines have to be the same length");
+		}
+		resize(width, height);
+		for (size_t y = 0; y < height; ++y) {
+			const char* const line = text.data() + y * stride;
+			if (y * stride + width < text.size() && line[width] != delimiter) {
+				throw std::invalid_argument("lines have to be the same length");
+			}
+			for (size_t x = 0; x < width; ++x) { set_char(x, y, line[x]); }
+		}
+	}
+
+	/// RLE states: 'b' or '.' is state 0, 'o' is state 1 and 'A' to 'X' are
+	/// states 1 to 24, like Golly writes automata with more than two states.
+	template<typename Resize, typename SetState>
+	inline void parse_rle(const std::string_view text,
+	                      Resize&&               resize,
+	                      SetState&&             set_state) {
+		LineReader       reader(text);
+		std::string_view line;
+		do {
+			if (!reader.next(line)) {
+				throw std::invalid_argument("RLE pattern without a header");
+			}
+			line = trim(line);
+		} while (line.empty() || line.front() == '#');
+
+		// "x = m, y = n" with an optional ", rule = ..." that is ignored,
+		// since the automaton's rules are fixed by its type.
+		size_t width  = 0;
+		size_t height = 0;
+		for (std::string_view rest = line; !rest.empty();) {
+			const size_t     comma = rest.find(',');
+			std::string_view field = trim(rest.substr(0, comma));
+			rest = comma == std::string_view::npos ? std::string_view{}
+			                                       : rest.substr(comma + 1);
+			const size_t equals = field.find('=');
+			if (equals == std::string_view::npos) {
+				throw std::invalid_argument("malformed RLE header");
+			}
+			const std::string_view key   = trim(field.substr(0, equals));
+			std::string_view       value = field.substr(equals + 1);
+			if (key == "x") {
+				width = take_integer<size_t>(value);
+			} else if (key == "y") {
+				height = take_integer<size_t>(value);
+			}
+		}
+		if (width == 0 || height == 0) {
+			throw std::invalid_argument("the grid is empty");
+		}
+		resize(width, height);
+
+		const std::string_view body  = reader.rest();
+		size_t                 x     = 0;
+		size_t                 y     = 0;
+		size_t                 count = 0;
+		for (const char c : body) {
+			if (c >= '0' && c <= '9') {
+				if (count > (std::numeric_limits<size_t>::max() - 9) / 10) {
+					throw std::invalid_argument("RLE run is too long");
+				}
+				count = count * 10 + static_cast<size_t>(c - '0');
+				continue;
+			}
+			if (is_space(c)) { continue; }
+			if (c == '!') { return; }
+
+			const size_t run = count == 0 ? 1 : count;
+			count            = 0;
+			if (c == '$') {
+				y += run;
+				x = 0;
+				continue;
+			}
+
+			unsigned int state = 0;
+			if (c == 'o') {
+				state = 1;
+			} else if (c >= 'A' && c <= 'X') {
+				state = static_cast<unsigned int>(c - 'A') + 1;
+			} else if (c != 'b' && c != '.') {
+				throw std::invalid_argument(std::string("unknown RLE state '")
+				                            + c + '\'');
+			}
+			if (run > width - x || y >= height) {
+				throw std::invalid_argument("RLE pattern is larger than its "
+				                            "header says");
+			}
+			if (state != 0) {
+				for (size_t i = 0; i < run; ++i) { set_state(x + i, y, state); }
+			}
+			x += run;
+		}
+		throw std::invalid_argument("RLE pattern doesn't end with '!'");
+	}
+
+	/// Calls `cell(x, y)` for every coordinate pair in a Life 1.06 file.
+	template<typename Cell>
+	inline void for_each_life_1_06_cell(const std::string_view text,
+	                                    Cell&&                 cell) {
+		LineReader       reader(text);
+		std::string_view line;
+		while (reader.next(line)) {
+			line = trim(line);
+			if (line.empty() || line.front() == '#') { continue; }
+			const auto x = take_integer<long long>(line);
+			const auto y = take_integer<long long>(line);
+			if (!trim(line).empty()) {
+				throw std::invalid_argument(
+				    "expected two coordinates per line");
+			}
+			cell(x, y);
+		}
+	}
+
+	/// Life 1.06 doesn't store the pattern's size, so the file is read
+	/// twice: once for the bounding box of the cells and once to set them.
+	/// Both passes go straight over `text`.
+	template<typename Resize, typename SetState>
+	inline void parse_life_1_06(const std::string_view text,
+	                            Resize&&               resize,
+	                            SetState&&             set_state) {
+		long long min_x = std::numeric_limits<long long>::max();
+		long long min_y = min_x;
+		long long max_x = std::numeric_limits<long long>::min();
+		long long max_y = max_x;
+		auto bounds = [&](const long long x, const long long y) {
+			min_x = std::min(min_x, x);
+			min_y = std::min(min_y, y);
+			max_x = std::max(max_x, x);
+			max_y = std::max(max_y, y);
+		};
+		for_each_life_1_06_cell(text, bounds);
+		if (min_x > max_x) {
+			// No live cells at all.
+			resize(size_t{1}, size_t{1});
+			return;
+		}
+		resize(static_cast<size_t>(max_x - min_x) + 1,
+		       static_cast<size_t>(max_y - min_y) + 1);
+		auto set = [&](const long long x, const long long y) {
+			set_state(static_cast<size_t>(x - min_x),
+			          static_cast<size_t>(y - min_y),
+			          1U);
+		};
+		for_each_life_1_06_cell(text, set);
+	}
+} // namespace detail
+
+inline Format detect_format(const std::string_view text) {
+	constexpr size_t   header_size = 64 * 1024;
+	detail::LineReader reader(text.substr(0, header_size));
+	std::string_view   line;
+	while (reader.next(line)) {
+		line = detail::trim(line);
+		if (line.rfind("#Life 1.06", 0) == 0) { return Format::life_1_06; }
+		if (line.empty() || line.front() == '#') { continue; }
+		if (line.front() == 'x') {
+			line.remove_prefix(1);
+			if (detail::trim(line).rfind('=', 0) == 0) { return Format::rle; }
+		}
+		break;
+	}
+	return Format::plain;
+}
+
+template<typename Resize, typename SetChar, typename SetState>
+inline void parse(const std::string_view text,
+                  const Format           format,
+                  const char             delimiter,
+                  Resize&&               resize,
+                  SetChar&&              set_char,
+                  SetState&&             set_state) {
+	switch (format) {
+	case Format::plain:
+		detail::parse_plain(text, delimiter, resize, set_char);
+		break;
+	case Format::rle: detail::parse_rle(text, resize, set_state); break;
+	case Format::life_1_06:
+		detail::parse_life_1_06(text, resize, set_state);
+		break;
+	}
+}
+
+template<typename Resize, typename SetChar, typename SetState>
+inline void parse(const std::string_view text,
+                  const char             delimiter,
+                  Resize&&               resize,
+                  SetChar&&              set_char,
+                  SetState&&             set_state) {
+	parse(text,
+	      detect_format(text),
+	      delimiter,
+	      std::forward<Resize>(resize),
+	      std::forward<SetChar>(set_char),
+	      std::forward<SetState>(set_state));
+}
+
+} // namespace cellular::io
+
+#endif // CELLULAR_IO_HPP_
@@ -0,0 +1,149 @@
+#ifndef CELLULAR_LAYOUT_HPP_
+#define CELLULAR_LAYOUT_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "experimental/mdspan"
+
+namespace stdex = std::experimental;
+namespace cellular {
+
+/// Two dimensional `mdspan` layout that stores the grid as `Tile`x`Tile`
+/// blocks, so that cells that are close in both dimensions are close in
+/// memory. The blocks and the cells inside of them are both ordered with
+/// the last index varying fastest, like `layout_right`.
+template<size_t Tile>
+struct layout_tiled {
+	static_assert(Tile > 0, "tiles can't be empty");
+
+	template<class Extents>
+	class mapping {
+	public:
+		constexpr mapping() noexcept = default;
+		constexpr mapping(const Extents& extents) noexcept :
+		    m_extents(extents),
+		    m_tiles_1((extents.extent(1) + Tile - 1) / Tile) {}
+
+		constexpr const Extents& extents() const noexcept { return m_extents; }
+
+		template<class I0, class I1>
+		constexpr std::ptrdiff_t operator()(const I0 i, const I1 j) const
+		    noexcept {
+			const auto tile = static_cast<std::ptrdiff_t>(i / Tile * m_tiles_1
+			                                              + j / Tile);
+			const auto cell = static_cast<std::ptrdiff_t>(i % Tile * Tile
+			                                              + j % Tile);
+			return tile * static_cast<std::ptrdiff_t>(Tile * Tile) + cell;
+		}
+		/// Partial tiles at the ends take up as much space as full ones.
+		constexpr std::ptrdiff_t required_span_size() const noexcept {
+			const std::ptrdiff_t tiles_0 =
+			    (m_extents.extent(0) + Tile - 1) / Tile;
+			return tiles_0 * m_tiles_1
+			       * static_cast<std::ptrdiff_t>(Tile * Tile);
+		}
+
+		static constexpr bool is_always_unique() noexcept { return true; }
+		static constexpr bool is_always_contiguous() noexcept { return false; }
+		static constexpr bool is_always_strided() noexcept { return false; }
+		constexpr bool        is_unique() const noexcept { return true; }
+		constexpr bool        is_contiguous() const noexcept { return false; }
+		constexpr bool        is_strided() const noexcept { return false; }
+
+	private:
+		Extents        m_extents;
+		std::ptrdiff_t m_tiles_1 = 0;
+	};
+};
+
+namespace detail {
+	/// Spread the low 32 bits of `value` out to the even bits.
+	constexpr std::uint64_t spread_bits(std::uint64_t value) {
+		value &= 0xffffffffULL;
+		value = (value | (value << 16)) & 0x0000ffff0000ffffULL;
+		value = (value | (value << 8)) & 0x00ff00ff00ff00ffULL;
+		value = (value | (value << 4)) & 0x0f0f0f0f0f0f0f0fULL;
+		value = (value | (value << 2)) & 0x3333333333333333ULL;
+		value = (value | (value << 1)) & 0x5555555555555555ULL;
+		return value;
+	}
+} // namespace detail
+
+/// Two dimensional `mdspan` layout that orders cells along a Z-order
+/// (Morton) curve inside of `Block`x`Block` blocks, which are themselves
+/// laid out like `layout_tiled`'s tiles. Blocking keeps the padding that a
+/// Z-order curve needs for sizes that aren't powers of two down to the last
+/// block along each dimension.
+template<size_t Block = 64>
+struct layout_morton {
+	static_assert(Block > 0 && (Block & (Block - 1)) == 0,
+	              "Morton blocks have to be a power of two wide");
+
+	template<class Extents>
+	class mapping {
+	public:
+		constexpr mapping() noexcept = default;
+		constexpr mapping(const Extents& extents) noexcept :
+		    m_extents(extents),
+		    m_blocks_1((extents.extent(1) + Block - 1) / Block) {}
+
+		constexpr const Extents& extents() const noexcept { return m_extents; }
+
+		template<class I0, class I1>
+		constexpr std::ptrdiff_t operator()(const I0 i, const I1 j) const
+		    noexcept {
+			const auto block = static_cast<std::ptrdiff_t>(
+			    i / Block * m_blocks_1 + j / Block);
+			// `i` gets the odd bits, so that the last index varies fastest.
+			const auto cell =
+			    static_cast<std::ptrdiff_t>(detail::spread_bits(i % Block) << 1
+			                                | detail::spread_bits(j % Block));
+			return block * static_cast<std::ptrdiff_t>(Block * Block) + cell;
+		}
+		constexpr std::ptrdiff_t required_span_size() const noexcept {
+			const std::ptrdiff_t blocks_0 =
+			    (m_extents.extent(0) + Block - 1) / Block;
+			return blocks_0 * m_blocks_1
+			       * static_cast<std::ptrdiff_t>(Block * Block);
+		}
+
+		static constexpr bool is_always_unique() noexcept { return true; }
+		static constexpr bool is_always_contiguous() noexcept { return false; }
+		static constexpr bool is_always_strided() noexcept { return false; }
+		constexpr bool        is_unique() const noexcept { return true; }
+		constexpr bool        is_contiguous() const noexcept { return false; }
+		constexpr bool        is_strided() const noexcept { return false; }
+
+	private:
+		Extents        m_extents;
+		std::ptrdiff_t m_blocks_1 = 0;
+	};
+};
+
+/// How `Automaton::step` walks a grid stored with `Layout`. `block` is the
+/// side of the square blocks that the layout keeps together, which `step`
+/// evaluates one at a time, or 0 if lines of constant first index are
+/// contiguous and `step` should go line by line. `kind` tells the layouts
+/// apart in checkpoints, which store the cells in the layout's order.
+template<typename Layout>
+struct layout_traits {
+	static constexpr size_t        block = 0;
+	static constexpr std::uint32_t kind  = 0;
+};
+
+template<size_t Tile>
+struct layout_traits<layout_tiled<Tile>> {
+	static constexpr size_t        block = Tile;
+	static constexpr std::uint32_t kind  = 1;
+};
+
+template<size_t Block>
+struct layout_traits<layout_morton<Block>> {
+	static constexpr size_t        block = Block;
+	static constexpr std::uint32_t kind  = 2;
+};
+
+} // namespace cellular
+
+#endif // CELLULAR_LAYOUT_HPP_
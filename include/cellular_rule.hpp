@@ -0,0 +1,184 @@
+#ifndef CELLULAR_RULE_HPP_
+#define CELLULAR_RULE_HPP_
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "cellular_simd.hpp"
+
+namespace cellular {
+
+/// A Life-like rule on the Moore neighborhood, or a Generations rule if it
+/// has more than two states. State 0 is dead and state 1 alive. In a
+/// Generations rule, live cells that don't survive go through the dying
+/// states 2, 3 and so on before they're dead again, and only live cells
+/// count as neighbors.
+struct LifeLikeRule {
+	/// Bit n is set if a dead cell with n live neighbors is born.
+	std::uint16_t birth = 0;
+	/// Bit n is set if a live cell with n live neighbors survives.
+	std::uint16_t survival = 0;
+	/// Amount of states, 2 for a plain Life-like rule.
+	std::uint8_t states = 2;
+
+	/// Parse a rule string, in B/S notation ("B3/S23", "B36/S23/C4"), in
+	/// S/B notation ("23/3") or in Generations' S/B/C notation ("/2/3" for
+	/// Brian's Brain). Throws `std::invalid_argument` for anything else.
+	static inline LifeLikeRule parse(std::string_view rule);
+	/// The rule in B/S notation, with a "/C" suffix for Generations rules.
+	inline std::string to_string() const;
+	/// The next state of a cell in `state` with `live` live neighbors.
+	constexpr std::uint8_t next(const std::uint8_t  state,
+	                            const unsigned int live) const {
+		if (state == 0) { return (birth >> live) & 1 ? 1 : 0; }
+		if (state == 1) {
+			if ((survival >> live) & 1) { return 1; }
+			return states > 2 ? 2 : 0;
+		}
+		return state + 1 < states ? state + 1 : 0;
+	}
+	/// The rule as a lookup table for the vectorized step.
+	inline CountRule count_rule() const {
+		return CountRule::from(std::uint8_t{1},
+		                       states,
+		                       [this](const std::uint8_t  state,
+		                              const unsigned int live) {
+			                       return next(state, live);
+		                       });
+	}
+
+	constexpr bool operator==(const LifeLikeRule& other) const = default;
+};
+
+/// Well known rules.
+namespace rules {
+	constexpr LifeLikeRule life{1 << 3, 1 << 2 | 1 << 3};
+	constexpr LifeLikeRule highlife{1 << 3 | 1 << 6, 1 << 2 | 1 << 3};
+	constexpr LifeLikeRule seeds{1 << 2, 0};
+	constexpr LifeLikeRule day_and_night{
+	    1 << 3 | 1 << 6 | 1 << 7 | 1 << 8,
+	    1 << 3 | 1 << 4 | 1 << 6 | 1 << 7 | 1 << 8};
+	constexpr LifeLikeRule brians_brain{1 << 2, 0, 3};
+} // namespace rules
+
+namespace detail {
+	/// Parse a run of neighbor counts such as "236" into a bit set.
+	inline std::uint16_t parse_counts(const std::string_view counts) {
+		std::uint16_t ret = 0;
+		for (const char c : counts) {
+			if (c < '0' || c > '8') {
+				throw std::invalid_argument(
+				    std::string("invalid neighbor count '") + c + '\'');
+			}
+			const auto bit = static_cast<std::uint16_t>(1 << (c - '0'));
+			if (ret & bit) {
+				throw std::invalid_argument(
+				    std::string("neighbor count ") + c + " given twice");
+			}
+			ret |= bit;
+		}
+		return ret;
+	}
+
+	inline std::uint8_t parse_states(const std::string_view states) {
+		unsigned int ret = 0;
+		for (const char c : states) {
+			if (c < '0' || c > '9' || ret > CountRule::max_states) {
+				throw std::invalid_argument("invalid amount of states");
+			}
+			ret = ret * 10 + static_cast<unsigned int>(c - '0');
+		}
+		if (ret < 2 || ret > CountRule::max_states) {
+			throw std::invalid_argument(
+			    "rules need between 2 and "
+			    + std::to_string(CountRule::max_states) + " states");
+		}
+		return static_cast<std::uint8_t>(ret);
+	}
+
+	inline char lower(const char c) {
+		return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+	}
+} // namespace detail
+
+inline LifeLikeRule LifeLikeRule::parse(std::string_view rule) {
+	while (!rule.empty() && rule.front() == ' ') { rule.remove_prefix(1); }
+	while (!rule.empty() && rule.back() == ' ') { rule.remove_suffix(1); }
+	if (rule.empty()) { throw std::invalid_argument("empty rule"); }
+
+	// Split on '/', into at most three parts.
+	std::string_view parts[3];
+	size_t           count = 0;
+	for (std::string_view rest = rule;;) {
+		if (count == 3) {
+			throw std::invalid_argument("too many parts in rule "
+			                            + std::string(rule));
+		}
+		const size_t slash = rest.find('/');
+		parts[count++]     = rest.substr(0, slash);
+		if (slash == std::string_view::npos) { break; }
+		rest.remove_prefix(slash + 1);
+	}
+
+	LifeLikeRule ret;
+	auto is_tagged = [](const std::string_view part) {
+		return !part.empty() && detail::lower(part.front()) >= 'a'
+		       && detail::lower(part.front()) <= 'z';
+	};
+	if (is_tagged(parts[0]) || is_tagged(parts[1])) {
+		// B/S notation, the parts can come in any order.
+		bool seen[3] = {};
+		for (size_t i = 0; i < count; ++i) {
+			const std::string_view part = parts[i];
+			const char tag = part.empty() ? '\0' : detail::lower(part.front());
+			if (tag == 'b' && !seen[0]) {
+				ret.birth = detail::parse_counts(part.substr(1));
+				seen[0]   = true;
+			} else if (tag == 's' && !seen[1]) {
+				ret.survival = detail::parse_counts(part.substr(1));
+				seen[1]      = true;
+			} else if ((tag == 'c' || tag == 'g') && !seen[2]) {
+				ret.states = detail::parse_states(part.substr(1));
+				seen[2]    = true;
+			} else if (i == 2 && !is_tagged(part) && !seen[2]) {
+				ret.states = detail::parse_states(part);
+				seen[2]    = true;
+			} else {
+				throw std::invalid_argument("invalid rule "
+				                            + std::string(rule));
+			}
+		}
+		if (!seen[0] || !seen[1]) {
+			throw std::invalid_argument("rule " + std::string(rule)
+			                            + " needs both B and S parts");
+		}
+	} else {
+		// S/B, or S/B/C for Generations.
+		if (count < 2) {
+			throw std::invalid_argument("invalid rule " + std::string(rule));
+		}
+		ret.survival = detail::parse_counts(parts[0]);
+		ret.birth    = detail::parse_counts(parts[1]);
+		if (count == 3) { ret.states = detail::parse_states(parts[2]); }
+	}
+	return ret;
+}
+
+inline std::string LifeLikeRule::to_string() const {
+	auto counts = [](const std::uint16_t bits) {
+		std::string ret;
+		for (int n = 0; n <= 8; ++n) {
+			if ((bits >> n) & 1) { ret += static_cast<char>('0' + n); }
+		}
+		return ret;
+	};
+	std::string ret = "B" + counts(birth) + "/S" + counts(survival);
+	if (states > 2) { ret += "/C" + std::to_string(states); }
+	return ret;
+}
+
+} // namespace cellular
+
+#endif // CELLULAR_RULE_HPP_
@@ -0,0 +1,540 @@
+#ifndef CELLULAR_SIMD_HPP_
+#define CELLULAR_SIMD_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#	define CELLULAR_SIMD_X86 1
+#	include <immintrin.h>
+#endif
+
+namespace cellular {
+
+/// A rule whose next state is a pure function of the current state and of
+/// how many of the 8 Moore neighbors are in the `counted` state. Automata
+/// with byte-sized states that describe their rule this way get a vectorized
+/// `step`.
+struct CountRule {
+	static constexpr size_t max_states = 16;
+
+	/// The state whose neighbors are counted.
+	std::uint8_t counted = 1;
+	/// Amount of states, at most `max_states`.
+	std::uint8_t states = 2;
+	/// `table[state][count]` is the next state of a cell in `state` with
+	/// `count` neighbors in the `counted` state. Counts above 8 are unused
+	/// but kept so every row is a 16-byte shuffle table.
+	std::array<std::array<std::uint8_t, 16>, max_states> table{};
+
+	/// Build the table by evaluating `rule(state, count)` for every state and
+	/// count.
+	template<typename StateType, typename Rule>
+	static CountRule from(const StateType counted,
+	                      const size_t    states,
+	                      Rule&&          rule) {
+		CountRule ret;
+		ret.counted = static_cast<std::uint8_t>(counted);
+		ret.states  = static_cast<std::uint8_t>(states);
+		for (size_t s = 0; s < states; ++s) {
+			for (unsigned int count = 0; count <= 8; ++count) {
+				ret.table[s][count] = static_cast<std::uint8_t>(
+				    rule(static_cast<StateType>(s), count));
+			}
+		}
+		return ret;
+	}
+};
+
+namespace simd {
+
+	enum class Isa { scalar, ssse3, avx2 };
+
+	/// Whether the CPU we're running on supports `isa`.
+	inline bool supported(const Isa isa) {
+		switch (isa) {
+		case Isa::scalar:
+			return true;
+#ifdef CELLULAR_SIMD_X86
+		case Isa::ssse3:
+			return __builtin_cpu_supports("ssse3");
+		case Isa::avx2:
+			return __builtin_cpu_supports("avx2");
+#endif
+		default:
+			return false;
+		}
+	}
+
+	/// The widest instruction set the CPU supports, detected once.
+	inline Isa best_isa() {
+		static const Isa isa = supported(Isa::avx2)    ? Isa::avx2
+		                       : supported(Isa::ssse3) ? Isa::ssse3
+		                                               : Isa::scalar;
+		return isa;
+	}
+
+	namespace detail {
+		/// Next state of cell `y` of `line`, checking for the ends of the
+		/// lines.
+		inline std::uint8_t next_cell(const CountRule&    rule,
+		                              const std::uint8_t* above,
+		                              const std::uint8_t* line,
+		                              const std::uint8_t* below,
+		                              const size_t        y,
+		                              const size_t        length) {
+			const size_t begin = y > 0 ? y - 1 : y;
+			const size_t end   = y + 1 < length ? y + 1 : y;
+			unsigned int count = 0;
+			for (size_t i = begin; i <= end; ++i) {
+				count += above[i] == rule.counted;
+				count += below[i] == rule.counted;
+				count += i != y && line[i] == rule.counted;
+			}
+			return rule.table[line[y]][count];
+		}
+
+		inline void step_scalar(const CountRule&    rule,
+		                        const std::uint8_t* above,
+		                        const std::uint8_t* line,
+		                        const std::uint8_t* below,
+		                        std::uint8_t*       out,
+		                        const size_t        begin,
+		                        const size_t        end) {
+			for (size_t y = begin; y < end; ++y) {
+				// Pointers, so that `y` being 0 reads the cells before it.
+				const std::uint8_t* a     = above + y;
+				const std::uint8_t* l     = line + y;
+				const std::uint8_t* b     = below + y;
+				unsigned int        count = 0;
+				for (std::ptrdiff_t i = -1; i <= 1; ++i) {
+					count += a[i] == rule.counted;
+					count += b[i] == rule.counted;
+				}
+				count += (l[-1] == rule.counted) + (l[1] == rule.counted);
+				out[y] = rule.table[l[0]][count];
+			}
+		}
+
+#ifdef CELLULAR_SIMD_X86
+		// Lambdas don't inherit the target attribute, so the loads are
+		// helpers of their own.
+		__attribute__((target("ssse3"))) inline __m128i matches_ssse3(
+		    const std::uint8_t* p,
+		    const __m128i       counted) {
+			return _mm_cmpeq_epi8(
+			    _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)),
+			    counted);
+		}
+
+		__attribute__((target("avx2"))) inline __m256i matches_avx2(
+		    const std::uint8_t* p,
+		    const __m256i       counted) {
+			return _mm256_cmpeq_epi8(
+			    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)),
+			    counted);
+		}
+
+		__attribute__((target("ssse3"))) inline void step_ssse3(
+		    const CountRule&    rule,
+		    const std::uint8_t* above,
+		    const std::uint8_t* line,
+		    const std::uint8_t* below,
+		    std::uint8_t*       out,
+		    size_t&             y,
+		    const size_t        end) {
+			const __m128i counted =
+			    _mm_set1_epi8(static_cast<char>(rule.counted));
+
+			for (; y + 16 <= end; y += 16) {
+				// Every match is -1, so subtracting them counts them.
+				__m128i count = _mm_setzero_si128();
+				for (const std::uint8_t* p : {above + y - 1,
+				                               above + y,
+				                               above + y + 1,
+				                               line + y - 1,
+				                               line + y + 1,
+				                               below + y - 1,
+				                               below + y,
+				                               below + y + 1}) {
+					count = _mm_sub_epi8(count, matches_ssse3(p, counted));
+				}
+
+				const __m128i center =
+				    _mm_loadu_si128(reinterpret_cast<const __m128i*>(line + y));
+				__m128i next = _mm_setzero_si128();
+				for (std::uint8_t s = 0; s < rule.states; ++s) {
+					const __m128i table = _mm_loadu_si128(
+					    reinterpret_cast<const __m128i*>(rule.table[s].data()));
+					const __m128i in_state = _mm_cmpeq_epi8(
+					    center,
+					    _mm_set1_epi8(static_cast<char>(s)));
+					const __m128i looked_up = _mm_shuffle_epi8(table, count);
+					next = _mm_or_si128(next,
+					                    _mm_and_si128(in_state, looked_up));
+				}
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + y), next);
+			}
+		}
+
+		__attribute__((target("avx2"))) inline void step_avx2(
+		    const CountRule&    rule,
+		    const std::uint8_t* above,
+		    const std::uint8_t* line,
+		    const std::uint8_t* below,
+		    std::uint8_t*       out,
+		    size_t&             y,
+		    const size_t        end) {
+			const __m256i counted =
+			    _mm256_set1_epi8(static_cast<char>(rule.counted));
+
+			for (; y + 32 <= end; y += 32) {
+				__m256i count = _mm256_setzero_si256();
+				for (const std::uint8_t* p : {above + y - 1,
+				                               above + y,
+				                               above + y + 1,
+				                               line + y - 1,
+				                               line + y + 1,
+				                               below + y - 1,
+				                               below + y,
+				                               below + y + 1}) {
+					count = _mm256_sub_epi8(count, matches_avx2(p, counted));
+				}
+
+				const __m256i center = _mm256_loadu_si256(
+				    reinterpret_cast<const __m256i*>(line + y));
+				__m256i next = _mm256_setzero_si256();
+				for (std::uint8_t s = 0; s < rule.states; ++s) {
+					// The shuffle works within 128-bit lanes, so the table is
+					// repeated in both.
+					const __m256i table = _mm256_broadcastsi128_si256(
+					    _mm_loadu_si128(reinterpret_cast<const __m128i*>(
+					        rule.table[s].data())));
+					const __m256i in_state = _mm256_cmpeq_epi8(
+					    center,
+					    _mm256_set1_epi8(static_cast<char>(s)));
+					next = _mm256_or_si256(
+					    next,
+					    _mm256_and_si256(in_state,
+					                     _mm256_shuffle_epi8(table, count)));
+				}
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + y), next);
+			}
+		}
+
+		__attribute__((target("ssse3"))) inline std::uint64_t sum_ssse3(
+		    const __m128i counts) {
+			const __m128i sums = _mm_sad_epu8(counts, _mm_setzero_si128());
+			return static_cast<std::uint64_t>(_mm_cvtsi128_si64(sums))
+			       + static_cast<std::uint64_t>(
+			           _mm_cvtsi128_si64(_mm_unpackhi_epi64(sums, sums)));
+		}
+
+		__attribute__((target("ssse3"))) inline void tally_ssse3(
+		    const std::uint8_t* from,
+		    const std::uint8_t* to,
+		    size_t&             y,
+		    const size_t        end,
+		    const size_t        states,
+		    std::uint64_t&      same,
+		    std::uint64_t*      to_counts,
+		    std::uint64_t*      from_counts) {
+			while (y + 16 <= end) {
+				// Every match is -1, so subtracting them counts them in bytes,
+				// which hold up to 255 vectors' worth.
+				const size_t blocks = std::min<size_t>((end - y) / 16, 255);
+				__m128i      same_counts = _mm_setzero_si128();
+				__m128i      to_bytes[CountRule::max_states];
+				__m128i      from_bytes[CountRule::max_states];
+				for (size_t s = 0; s < states; ++s) {
+					to_bytes[s]   = _mm_setzero_si128();
+					from_bytes[s] = _mm_setzero_si128();
+				}
+				for (size_t block = 0; block < blocks; ++block, y += 16) {
+					const __m128i before = _mm_loadu_si128(
+					    reinterpret_cast<const __m128i*>(from + y));
+					const __m128i after  = _mm_loadu_si128(
+					    reinterpret_cast<const __m128i*>(to + y));
+					same_counts = _mm_sub_epi8(same_counts,
+					                           _mm_cmpeq_epi8(before, after));
+					for (size_t s = 0; s < states; ++s) {
+						const __m128i state =
+						    _mm_set1_epi8(static_cast<char>(s));
+						to_bytes[s]   = _mm_sub_epi8(
+						    to_bytes[s], _mm_cmpeq_epi8(after, state));
+						from_bytes[s] = _mm_sub_epi8(
+						    from_bytes[s], _mm_cmpeq_epi8(before, state));
+					}
+				}
+				same += sum_ssse3(same_counts);
+				for (size_t s = 0; s < states; ++s) {
+					to_counts[s] += sum_ssse3(to_bytes[s]);
+					from_counts[s] += sum_ssse3(from_bytes[s]);
+				}
+			}
+		}
+
+		__attribute__((target("avx2"))) inline std::uint64_t sum_avx2(
+		    const __m256i counts) {
+			const __m256i sums =
+			    _mm256_sad_epu8(counts, _mm256_setzero_si256());
+			return static_cast<std::uint64_t>(_mm256_extract_epi64(sums, 0))
+			       + static_cast<std::uint64_t>(_mm256_extract_epi64(sums, 1))
+			       + static_cast<std::uint64_t>(_mm256_extract_epi64(sums, 2))
+			       + static_cast<std::uint64_t>(_mm256_extract_epi64(sums, 3));
+		}
+
+		__attribute__((target("avx2"))) inline void tally_avx2(
+		    const std::uint8_t* from,
+		    const std::uint8_t* to,
+		    size_t&             y,
+		    const size_t        end,
+		    const size_t        states,
+		    std::uint64_t&      same,
+		    std::uint64_t*      to_counts,
+		    std::uint64_t*      from_counts) {
+			while (y + 32 <= end) {
+				const size_t blocks = std::min<size_t>((end - y) / 32, 255);
+				__m256i      same_counts = _mm256_setzero_si256();
+				__m256i      to_bytes[CountRule::max_states];
+				__m256i      from_bytes[CountRule::max_states];
+				for (size_t s = 0; s < states; ++s) {
+					to_bytes[s]   = _mm256_setzero_si256();
+					from_bytes[s] = _mm256_setzero_si256();
+				}
+				for (size_t block = 0; block < blocks; ++block, y += 32) {
+					const __m256i before = _mm256_loadu_si256(
+					    reinterpret_cast<const __m256i*>(from + y));
+					const __m256i after  = _mm256_loadu_si256(
+					    reinterpret_cast<const __m256i*>(to + y));
+					same_counts = _mm256_sub_epi8(
+					    same_counts, _mm256_cmpeq_epi8(before, after));
+					for (size_t s = 0; s < states; ++s) {
+						const __m256i state =
+						    _mm256_set1_epi8(static_cast<char>(s));
+						to_bytes[s]   = _mm256_sub_epi8(
+						    to_bytes[s], _mm256_cmpeq_epi8(after, state));
+						from_bytes[s] = _mm256_sub_epi8(
+						    from_bytes[s], _mm256_cmpeq_epi8(before, state));
+					}
+				}
+				same += sum_avx2(same_counts);
+				for (size_t s = 0; s < states; ++s) {
+					to_counts[s] += sum_avx2(to_bytes[s]);
+					from_counts[s] += sum_avx2(from_bytes[s]);
+				}
+			}
+		}
+#endif
+	} // namespace detail
+
+	/// Count how the cells in [`begin`, `end`) changed from `from` to `to`:
+	/// adds the amount that differ to `changed`, and the change in the amount
+	/// of cells in state s to `population[s]` for every s below `states`.
+	inline void tally_span(const std::uint8_t* from,
+	                       const std::uint8_t* to,
+	                       const size_t        begin,
+	                       const size_t        end,
+	                       const size_t        states,
+	                       size_t&             changed,
+	                       std::ptrdiff_t*     population,
+	                       const Isa           isa = best_isa()) {
+		// The last state's count follows from the others, so it's skipped.
+		const size_t  counted = states > 0 ? states - 1 : 0;
+		std::uint64_t same    = 0;
+		std::uint64_t to_counts[CountRule::max_states]   = {};
+		std::uint64_t from_counts[CountRule::max_states] = {};
+		size_t        y                                  = begin;
+#ifdef CELLULAR_SIMD_X86
+		if (isa == Isa::avx2) {
+			detail::tally_avx2(
+			    from, to, y, end, counted, same, to_counts, from_counts);
+		}
+		if (isa != Isa::scalar) {
+			detail::tally_ssse3(
+			    from, to, y, end, counted, same, to_counts, from_counts);
+		}
+#endif
+		for (; y < end; ++y) {
+			same += from[y] == to[y];
+			if (to[y] < counted) { ++to_counts[to[y]]; }
+			if (from[y] < counted) { ++from_counts[from[y]]; }
+		}
+
+		changed += (end - begin) - same;
+		std::ptrdiff_t rest = 0;
+		for (size_t s = 0; s < counted; ++s) {
+			const auto delta = static_cast<std::ptrdiff_t>(to_counts[s])
+			                   - static_cast<std::ptrdiff_t>(from_counts[s]);
+			population[s] += delta;
+			rest -= delta;
+		}
+		if (states > 0) { population[states - 1] += rest; }
+	}
+
+	namespace detail {
+#ifdef CELLULAR_SIMD_X86
+		template<typename Function>
+		__attribute__((target("ssse3"))) inline void changes_ssse3(
+		    const std::uint8_t* from,
+		    const std::uint8_t* to,
+		    size_t&             y,
+		    const size_t        end,
+		    Function&           function) {
+			// In a local, which `function`'s writes can't alias.
+			size_t at = y;
+			for (; at + 16 <= end; at += 16) {
+				const __m128i before = _mm_loadu_si128(
+				    reinterpret_cast<const __m128i*>(from + at));
+				const __m128i after =
+				    _mm_loadu_si128(reinterpret_cast<const __m128i*>(to + at));
+				auto differ = static_cast<std::uint32_t>(
+				    ~_mm_movemask_epi8(_mm_cmpeq_epi8(before, after)) & 0xffff);
+				for (; differ != 0; differ &= differ - 1) {
+					function(at + static_cast<size_t>(__builtin_ctz(differ)));
+				}
+			}
+			y = at;
+		}
+
+		template<typename Function>
+		__attribute__((target("avx2"))) inline void changes_avx2(
+		    const std::uint8_t* from,
+		    const std::uint8_t* to,
+		    size_t&             y,
+		    const size_t        end,
+		    Function&           function) {
+			auto equal = [](const std::uint8_t* a, const std::uint8_t* b)
+			    __attribute__((target("avx2"))) {
+				    const auto*   lhs   = reinterpret_cast<const __m256i*>(a);
+				    const auto*   rhs   = reinterpret_cast<const __m256i*>(b);
+				    const __m256i equal = _mm256_cmpeq_epi8(
+				        _mm256_loadu_si256(lhs), _mm256_loadu_si256(rhs));
+				    const int mask = _mm256_movemask_epi8(equal);
+				    return static_cast<std::uint64_t>(
+				        static_cast<std::uint32_t>(mask));
+			    };
+			// 64 cells at a time, since every set of them that has changes
+			// costs a mispredicted branch at the end of the loop over them.
+			size_t at = y;
+			for (; at + 64 <= end; at += 64) {
+				std::uint64_t differ =
+				    ~(equal(from + at, to + at)
+				      | equal(from + at + 32, to + at + 32) << 32);
+				for (; differ != 0; differ &= differ - 1) {
+					function(at + static_cast<size_t>(__builtin_ctzll(differ)));
+				}
+			}
+			y = at;
+		}
+#endif
+	} // namespace detail
+
+	/// Call `function(y)` for every y in [`begin`, `end`) where `from` and
+	/// `to` differ, in order. Equal stretches are skipped a vector at a time.
+	template<typename Function>
+	inline void for_each_change(const std::uint8_t* from,
+	                            const std::uint8_t* to,
+	                            const size_t        begin,
+	                            const size_t        end,
+	                            Function&&          function,
+	                            const Isa           isa = best_isa()) {
+		size_t y = begin;
+#ifdef CELLULAR_SIMD_X86
+		if (isa == Isa::avx2) {
+			detail::changes_avx2(from, to, y, end, function);
+		}
+		if (isa != Isa::scalar) {
+			detail::changes_ssse3(from, to, y, end, function);
+		}
+#endif
+		for (; y < end; ++y) {
+			if (from[y] != to[y]) { function(y); }
+		}
+	}
+
+	/// Compute the next state of the cells of `line` in [`begin`, `end`) into
+	/// the same cells of `out`, reading the cell before `begin` and the one
+	/// at `end` of `above`, `line` and `below` unconditionally. `out` can't
+	/// overlap the others.
+	inline void step_span_unchecked(const CountRule&    rule,
+	                                const std::uint8_t* above,
+	                                const std::uint8_t* line,
+	                                const std::uint8_t* below,
+	                                std::uint8_t*       out,
+	                                const size_t        begin,
+	                                const size_t        end,
+	                                const Isa           isa = best_isa()) {
+		size_t y = begin;
+#ifdef CELLULAR_SIMD_X86
+		// Finish with one vector that overlaps the ones before it instead of
+		// falling back to narrower code, rewriting a few cells with the same
+		// states.
+		if (isa == Isa::avx2) {
+			detail::step_avx2(rule, above, line, below, out, y, end);
+			if (y < end && end - begin >= 32) {
+				y = end - 32;
+				detail::step_avx2(rule, above, line, below, out, y, end);
+			}
+		}
+		if (isa != Isa::scalar) {
+			detail::step_ssse3(rule, above, line, below, out, y, end);
+			if (y < end && end - begin >= 16) {
+				y = end - 16;
+				detail::step_ssse3(rule, above, line, below, out, y, end);
+			}
+		}
+#endif
+		if (y < end) {
+			detail::step_scalar(rule, above, line, below, out, y, end);
+		}
+	}
+
+	/// Compute the next state of the cells of `line` in [`begin`, `end`) into
+	/// the same cells of `out`. `above` and `below` are the adjacent lines,
+	/// all four are `length` cells long and `out` can't overlap the others.
+	/// Cells past the ends of the lines aren't counted.
+	inline void step_span(const CountRule&    rule,
+	                      const std::uint8_t* above,
+	                      const std::uint8_t* line,
+	                      const std::uint8_t* below,
+	                      std::uint8_t*       out,
+	                      const size_t        begin,
+	                      const size_t        end,
+	                      const size_t        length,
+	                      const Isa           isa = best_isa()) {
+		// The ends of the line are checked separately, so the interior can
+		// read one cell to each side unconditionally.
+		size_t       y        = begin;
+		const size_t interior = std::min(end, length - 1);
+		if (y == 0 && y < end) {
+			out[0] = detail::next_cell(rule, above, line, below, 0, length);
+			++y;
+		}
+		if (y < interior) {
+			step_span_unchecked(
+			    rule, above, line, below, out, y, interior, isa);
+			y = interior;
+		}
+		for (; y < end; ++y) {
+			out[y] = detail::next_cell(rule, above, line, below, y, length);
+		}
+	}
+
+	/// `step_span` over the whole line.
+	inline void step_line(const CountRule&    rule,
+	                      const std::uint8_t* above,
+	                      const std::uint8_t* line,
+	                      const std::uint8_t* below,
+	                      std::uint8_t*       out,
+	                      const size_t        length,
+	                      const Isa           isa = best_isa()) {
+		step_span(rule, above, line, below, out, 0, length, length, isa);
+	}
+
+} // namespace simd
+} // namespace cellular
+
+#endif // CELLULAR_SIMD_HPP_
@@ -0,0 +1,446 @@
+#ifndef CELLULAR_SPARSE_HPP_
+#define CELLULAR_SPARSE_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "cellular_hash.hpp"
+#include "cellular_simd.hpp"
+
+namespace cellular {
+
+/// An automaton with a `CountRule` on an unbounded plane. The plane is cut
+/// into `ChunkSize`x`ChunkSize` chunks, kept in a hash map keyed by their
+/// coordinates, and only the chunks with a cell that isn't in the default
+/// state exist. A step only visits the chunks that changed in the last one
+/// and their neighbors, allocates the neighbors that activity spreads to
+/// and frees the chunks that end up empty, so both memory and the time a
+/// step takes go with the live area rather than its bounding box. Freed
+/// chunks are kept in a pool and reused.
+///
+/// Chunk coordinates are 32-bit, so the plane spans 2^32 chunks on both
+/// axes, centered on (0, 0). Rules that give birth to default cells with no
+/// neighbors would fill the plane, and are rejected.
+template<typename StateType, size_t ChunkSize = 64>
+class SparseAutomaton {
+	static_assert(sizeof(StateType) == 1,
+	              "the vectorized step works on byte-sized states");
+	static_assert(ChunkSize >= 2, "chunks need at least 2x2 cells");
+
+public:
+	/// Throws `std::invalid_argument` if `rule` changes the state of default
+	/// cells surrounded by default cells.
+	explicit inline SparseAutomaton(const CountRule& rule);
+	inline StateType get(const std::int64_t x, const std::int64_t y) const;
+	inline void      set(const std::int64_t x,
+	                     const std::int64_t y,
+	                     const StateType    state);
+	inline void      step();
+	inline void      step(const size_t generations);
+	inline size_t    generation() const;
+	/// Amount of cells that aren't in the default state.
+	inline size_t    population() const;
+	/// Amount of chunks in use, and of the ones waiting in the pool.
+	inline size_t    chunk_count() const;
+	inline size_t    pooled_chunks() const;
+	/// Copy every cell (x, y) of `dense` to (`left` + x, `top` + y).
+	template<typename Grid>
+	inline void assign(const Grid&        dense,
+	                   const std::int64_t left = 0,
+	                   const std::int64_t top  = 0);
+	/// Copy the window of the plane starting at (`left`, `top`) with the
+	/// dimensions of `dense` into it.
+	template<typename Grid>
+	inline void copy_to(Grid&              dense,
+	                    const std::int64_t left = 0,
+	                    const std::int64_t top  = 0) const;
+	/// Return every chunk to the pool, leaving the plane empty.
+	inline void clear();
+
+	static constexpr size_t chunk_size = ChunkSize;
+
+private:
+	static constexpr size_t area   = ChunkSize * ChunkSize;
+	/// Side of a chunk with a cell of its neighbors on every edge.
+	static constexpr size_t padded = ChunkSize + 2;
+
+	struct Chunk {
+		Chunk() = default;
+		/// `cells` and `next` point into the chunk itself.
+		Chunk(const Chunk&) = delete;
+
+		std::array<std::uint8_t, 2 * area> storage;
+		/// The halves of `storage` with the current generation and the next
+		/// one, swapped by a step. Row-major like the dense grid, cell (x, y)
+		/// of the chunk is `cells[x * ChunkSize + y]`.
+		std::uint8_t* cells = storage.data();
+		std::uint8_t* next  = storage.data() + area;
+		/// Amount of cells that aren't in the default state.
+		size_t live = 0;
+		/// Whether a cell changed in the last step, or was set since.
+		bool changed = true;
+	};
+
+	struct KeyHash {
+		size_t operator()(const std::uint64_t at) const {
+			return static_cast<size_t>(detail::mix(at));
+		}
+	};
+
+	/// The step's result for a chunk that's kept or created.
+	struct Pending {
+		std::uint64_t key;
+		Chunk*        chunk;
+		/// Set if the chunk is new, and not in `m_chunks` yet.
+		std::unique_ptr<Chunk> created;
+		bool                   changed;
+		size_t                 live;
+	};
+
+	static inline std::uint64_t key(const std::int64_t chunk_x,
+	                                const std::int64_t chunk_y);
+	static inline std::int64_t  key_x(const std::uint64_t at);
+	static inline std::int64_t  key_y(const std::uint64_t at);
+	/// The chunk coordinate of `coordinate` and its offset in that chunk.
+	static inline std::int64_t  chunk_of(const std::int64_t coordinate);
+	static inline size_t        offset_in(const std::int64_t coordinate);
+	inline const Chunk*         find(const std::uint64_t at) const;
+	inline std::unique_ptr<Chunk> acquire();
+	inline void                   release(std::unique_ptr<Chunk> chunk);
+	/// Copy the chunk at (`chunk_x`, `chunk_y`) and the cells around it into
+	/// `m_padded`, unless it's absent and so are the cells around it, which
+	/// leaves it absent in the next generation too. Returns whether it
+	/// copied.
+	inline bool gather(const std::int64_t chunk_x, const std::int64_t chunk_y);
+	/// Whether a cell of the neighbors `around` a chunk that borders it isn't
+	/// in the default state, `around[dx + 1][dy + 1]` being the one at
+	/// (dx, dy) from it or null if it's absent.
+	static inline bool touched(const Chunk* const (&around)[3][3]);
+
+	CountRule m_rule;
+	std::unordered_map<std::uint64_t, std::unique_ptr<Chunk>, KeyHash>
+	                                    m_chunks;
+	std::vector<std::unique_ptr<Chunk>> m_pool;
+	/// Scratch space of `step`, kept to not allocate it every time.
+	std::array<std::uint8_t, padded * padded> m_padded{};
+	std::vector<std::uint64_t>                m_candidates;
+	std::vector<Pending>                      m_pending;
+	/// Chunks the last step freed. Their cells died, so their neighbors can
+	/// change even though they're gone from `m_chunks`.
+	std::vector<std::uint64_t> m_freed;
+	size_t                     m_generation = 0;
+};
+
+template<typename T, size_t C>
+inline SparseAutomaton<T, C>::SparseAutomaton(const CountRule& rule) :
+    m_rule(rule) {
+	// With every neighbor in the default state, the count is 8 if it's the
+	// counted state and 0 otherwise.
+	if (m_rule.table[0][m_rule.counted == 0 ? 8 : 0] != 0) {
+		throw std::invalid_argument(
+		    "the rule changes default cells with default neighbors, which "
+		    "would fill the plane");
+	}
+}
+
+template<typename T, size_t C>
+inline std::uint64_t SparseAutomaton<T, C>::key(const std::int64_t chunk_x,
+                                                const std::int64_t chunk_y) {
+	return static_cast<std::uint64_t>(static_cast<std::uint32_t>(chunk_x))
+	           << 32
+	       | static_cast<std::uint32_t>(chunk_y);
+}
+
+template<typename T, size_t C>
+inline std::int64_t SparseAutomaton<T, C>::key_x(const std::uint64_t at) {
+	return static_cast<std::int32_t>(static_cast<std::uint32_t>(at >> 32));
+}
+
+template<typename T, size_t C>
+inline std::int64_t SparseAutomaton<T, C>::key_y(const std::uint64_t at) {
+	return static_cast<std::int32_t>(static_cast<std::uint32_t>(at));
+}
+
+template<typename T, size_t C>
+inline std::int64_t
+SparseAutomaton<T, C>::chunk_of(const std::int64_t coordinate) {
+	constexpr auto size = static_cast<std::int64_t>(C);
+	// Rounded down rather than towards zero.
+	return coordinate >= 0 ? coordinate / size
+	                       : (coordinate - (size - 1)) / size;
+}
+
+template<typename T, size_t C>
+inline size_t SparseAutomaton<T, C>::offset_in(const std::int64_t coordinate) {
+	return static_cast<size_t>(coordinate
+	                           - chunk_of(coordinate)
+	                                 * static_cast<std::int64_t>(C));
+}
+
+template<typename T, size_t C>
+inline auto SparseAutomaton<T, C>::find(const std::uint64_t at) const
+    -> const Chunk* {
+	const auto found = m_chunks.find(at);
+	return found == m_chunks.end() ? nullptr : found->second.get();
+}
+
+template<typename T, size_t C>
+inline auto SparseAutomaton<T, C>::acquire() -> std::unique_ptr<Chunk> {
+	if (m_pool.empty()) { return std::make_unique<Chunk>(); }
+	std::unique_ptr<Chunk> chunk = std::move(m_pool.back());
+	m_pool.pop_back();
+	chunk->live    = 0;
+	chunk->changed = true;
+	return chunk;
+}
+
+template<typename T, size_t C>
+inline void SparseAutomaton<T, C>::release(std::unique_ptr<Chunk> chunk) {
+	m_pool.push_back(std::move(chunk));
+}
+
+template<typename T, size_t C>
+inline T SparseAutomaton<T, C>::get(const std::int64_t x,
+                                    const std::int64_t y) const {
+	const Chunk* chunk = find(key(chunk_of(x), chunk_of(y)));
+	if (chunk == nullptr) { return T(); }
+	return static_cast<T>(chunk->cells[offset_in(x) * C + offset_in(y)]);
+}
+
+template<typename T, size_t C>
+inline void SparseAutomaton<T, C>::set(const std::int64_t x,
+                                       const std::int64_t y,
+                                       const T            state) {
+	const std::uint64_t at    = key(chunk_of(x), chunk_of(y));
+	auto                found = m_chunks.find(at);
+	if (found == m_chunks.end()) {
+		if (state == T()) { return; }
+		std::unique_ptr<Chunk> chunk = acquire();
+		std::fill_n(chunk->cells, area, std::uint8_t{0});
+		found = m_chunks.emplace(at, std::move(chunk)).first;
+	}
+	// Chunks left empty are freed by the next step, which they take part in
+	// since they changed.
+	Chunk&        chunk = *found->second;
+	std::uint8_t& cell  = chunk.cells[offset_in(x) * C + offset_in(y)];
+	chunk.live += (state != T()) - (cell != 0);
+	cell          = static_cast<std::uint8_t>(state);
+	chunk.changed = true;
+}
+
+template<typename T, size_t C>
+inline bool SparseAutomaton<T, C>::gather(const std::int64_t chunk_x,
+                                          const std::int64_t chunk_y) {
+	// Neighbors by offset, [dx + 1][dy + 1].
+	const Chunk* around[3][3];
+	for (int dx = -1; dx <= 1; ++dx) {
+		for (int dy = -1; dy <= 1; ++dy) {
+			around[dx + 1][dy + 1] = find(key(chunk_x + dx, chunk_y + dy));
+		}
+	}
+	if (around[1][1] == nullptr && !touched(around)) { return false; }
+
+	// Cell `i` of the padded chunk is cell `i - 1` of the chunk, so
+	// [0, padded) on either axis spans the last cell of the previous chunk,
+	// the whole chunk and the first cell of the next one.
+	auto source = [](const size_t i) -> size_t {
+		return i == 0 ? 0 : i <= C ? 1 : 2;
+	};
+	auto local = [](const size_t i) -> size_t {
+		return i == 0 ? C - 1 : i <= C ? i - 1 : 0;
+	};
+	for (size_t px = 0; px < padded; ++px) {
+		std::uint8_t* line   = &m_padded[px * padded];
+		const size_t  column = source(px);
+		const size_t  x      = local(px);
+		for (size_t part = 0; part < 3; ++part) {
+			const Chunk* chunk = around[column][part];
+			// The span of the padded line that comes from this chunk.
+			const size_t begin = part == 0 ? 0 : part == 1 ? 1 : C + 1;
+			const size_t end   = part == 0 ? 1 : part == 1 ? C + 1 : padded;
+			if (chunk == nullptr) {
+				std::fill(line + begin, line + end, std::uint8_t{0});
+			} else {
+				std::copy_n(&chunk->cells[x * C + local(begin)],
+				            end - begin,
+				            line + begin);
+			}
+		}
+	}
+	return true;
+}
+
+template<typename T, size_t C>
+inline bool SparseAutomaton<T, C>::touched(const Chunk* const (&around)[3][3]) {
+	auto alive = [](const Chunk* chunk, const size_t x, const size_t y) {
+		return chunk != nullptr && chunk->cells[x * C + y] != 0;
+	};
+	if (alive(around[0][0], C - 1, C - 1) || alive(around[2][0], 0, C - 1)
+	    || alive(around[0][2], C - 1, 0) || alive(around[2][2], 0, 0)) {
+		return true;
+	}
+	for (size_t i = 0; i < C; ++i) {
+		if (alive(around[0][1], C - 1, i) || alive(around[2][1], 0, i)
+		    || alive(around[1][0], i, C - 1) || alive(around[1][2], i, 0)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+template<typename T, size_t C>
+inline void SparseAutomaton<T, C>::step() {
+	// Only chunks next to a change can change.
+	m_candidates.clear();
+	auto around = [this](const std::uint64_t at) {
+		for (int dx = -1; dx <= 1; ++dx) {
+			for (int dy = -1; dy <= 1; ++dy) {
+				m_candidates.push_back(
+				    key(key_x(at) + dx, key_y(at) + dy));
+			}
+		}
+	};
+	for (const auto& [at, chunk] : m_chunks) {
+		if (chunk->changed) { around(at); }
+	}
+	for (const std::uint64_t at : m_freed) { around(at); }
+	m_freed.clear();
+	std::sort(m_candidates.begin(), m_candidates.end());
+	m_candidates.erase(std::unique(m_candidates.begin(), m_candidates.end()),
+	                   m_candidates.end());
+
+	// Every candidate is computed from the current generation before any
+	// chunk is replaced.
+	m_pending.clear();
+	for (const std::uint64_t at : m_candidates) {
+		const auto   found    = m_chunks.find(at);
+		Chunk* const existing = found == m_chunks.end() ? nullptr
+		                                                : found->second.get();
+		if (!gather(key_x(at), key_y(at))) { continue; }
+
+		Pending pending{at, existing, nullptr, false, 0};
+		if (existing == nullptr) {
+			// Compared with the cells it's computed from below, which are
+			// all in the default state.
+			pending.created = acquire();
+			pending.chunk   = pending.created.get();
+			std::fill_n(pending.chunk->cells, area, std::uint8_t{0});
+		}
+		Chunk& chunk = *pending.chunk;
+		for (size_t x = 0; x < C; ++x) {
+			// Offset by a cell, so the cell before the first one is the
+			// previous chunk's.
+			simd::step_span_unchecked(m_rule,
+			                          &m_padded[x * padded + 1],
+			                          &m_padded[(x + 1) * padded + 1],
+			                          &m_padded[(x + 2) * padded + 1],
+			                          &chunk.next[x * C],
+			                          0,
+			                          C);
+		}
+		// Counted as two states, the default one and any other.
+		size_t         changed       = 0;
+		std::ptrdiff_t population[2] = {};
+		simd::tally_span(
+		    chunk.cells, chunk.next, 0, area, 2, changed, population);
+		pending.changed = changed != 0;
+		pending.live = static_cast<size_t>(
+		    static_cast<std::ptrdiff_t>(chunk.live) + population[1]);
+		m_pending.push_back(std::move(pending));
+	}
+
+	for (Pending& pending : m_pending) {
+		if (pending.live == 0 && pending.created) {
+			release(std::move(pending.created));
+			continue;
+		}
+		if (pending.live == 0) {
+			const auto found = m_chunks.find(pending.key);
+			release(std::move(found->second));
+			m_chunks.erase(found);
+			m_freed.push_back(pending.key);
+			continue;
+		}
+		pending.chunk->live    = pending.live;
+		pending.chunk->changed = pending.changed;
+		if (pending.changed) {
+			std::swap(pending.chunk->cells, pending.chunk->next);
+		}
+		if (pending.created) {
+			m_chunks.emplace(pending.key, std::move(pending.created));
+		}
+	}
+	++m_generation;
+}
+
+template<typename T, size_t C>
+inline void SparseAutomaton<T, C>::step(const size_t generations) {
+	for (size_t i = 0; i < generations; ++i) { step(); }
+}
+
+template<typename T, size_t C>
+inline size_t SparseAutomaton<T, C>::generation() const {
+	return m_generation;
+}
+
+template<typename T, size_t C>
+inline size_t SparseAutomaton<T, C>::population() const {
+	size_t ret = 0;
+	for (const auto& entry : m_chunks) { ret += entry.second->live; }
+	return ret;
+}
+
+template<typename T, size_t C>
+inline size_t SparseAutomaton<T, C>::chunk_count() const {
+	return m_chunks.size();
+}
+
+template<typename T, size_t C>
+inline size_t SparseAutomaton<T, C>::pooled_chunks() const {
+	return m_pool.size();
+}
+
+template<typename T, size_t C>
+template<typename Grid>
+inline void SparseAutomaton<T, C>::assign(const Grid&        dense,
+                                          const std::int64_t left,
+                                          const std::int64_t top) {
+	for (size_t x = 0; x < dense.width(); ++x) {
+		for (size_t y = 0; y < dense.height(); ++y) {
+			set(left + static_cast<std::int64_t>(x),
+			    top + static_cast<std::int64_t>(y),
+			    static_cast<T>(dense(x, y)));
+		}
+	}
+}
+
+template<typename T, size_t C>
+template<typename Grid>
+inline void SparseAutomaton<T, C>::copy_to(Grid&              dense,
+                                           const std::int64_t left,
+                                           const std::int64_t top) const {
+	for (size_t x = 0; x < dense.width(); ++x) {
+		for (size_t y = 0; y < dense.height(); ++y) {
+			dense(x, y) = get(left + static_cast<std::int64_t>(x),
+			                  top + static_cast<std::int64_t>(y));
+		}
+	}
+}
+
+template<typename T, size_t C>
+inline void SparseAutomaton<T, C>::clear() {
+	for (auto& entry : m_chunks) { release(std::move(entry.second)); }
+	m_chunks.clear();
+	m_freed.clear();
+}
+
+} // namespace cellular
+
+#endif // CELLULAR_SPARSE_HPP_
@@ -0,0 +1,77 @@
+#ifndef CELLULAR_STATIC_HPP_
+#define CELLULAR_STATIC_HPP_
+
+#include <cstddef>
+#include <type_traits>
+
+#include "cellular.hpp"
+
+namespace cellular {
+
+/// `Automaton` with its rule bound at compile time. `Derived` defines
+///
+///     StateType next_cell(StateType current_cell, size_t x, size_t y) const;
+///
+/// which the scalar step calls directly from its loop over the grid, so the
+/// rule inlines into the loop together with the `count_*` calls it makes,
+/// rather than costing a virtual call per cell. `next_state` forwards to it
+/// for whatever still goes through the virtual interface. `Derived` has to
+/// befriend this class if `next_cell` isn't public.
+template<typename Derived,
+         typename StateType,
+         typename Layout = stdex::layout_right>
+class StaticAutomaton : public Automaton<StateType, Layout> {
+public:
+	using Automaton<StateType, Layout>::Automaton;
+
+protected:
+	inline StateType next_state(const StateType current_cell,
+	                            const size_t    x,
+	                            const size_t    y) final;
+	inline bool      evaluate_cells(const size_t       x_begin,
+	                                const size_t       x_end,
+	                                const size_t       y_begin,
+	                                const size_t       y_end,
+	                                detail::StepTally* tally) final;
+
+private:
+	inline const Derived& derived() const;
+};
+
+template<typename D, typename T, typename L>
+inline T StaticAutomaton<D, T, L>::next_state(const T      current_cell,
+                                              const size_t x,
+                                              const size_t y) {
+	return derived().next_cell(current_cell, x, y);
+}
+
+template<typename D, typename T, typename L>
+inline bool StaticAutomaton<D, T, L>::evaluate_cells(
+    const size_t       x_begin,
+    const size_t       x_end,
+    const size_t       y_begin,
+    const size_t       y_end,
+    detail::StepTally* tally) {
+	static_assert(
+	    std::is_same_v<decltype(derived().next_cell(T(), 0, 0)), T>,
+	    "next_cell has to return the next state");
+	const D& automaton = derived();
+	return this->evaluate_cells_with(
+	    x_begin,
+	    x_end,
+	    y_begin,
+	    y_end,
+	    tally,
+	    [&automaton](const T current_cell, const size_t x, const size_t y) {
+		    return automaton.next_cell(current_cell, x, y);
+	    });
+}
+
+template<typename D, typename T, typename L>
+inline const D& StaticAutomaton<D, T, L>::derived() const {
+	return static_cast<const D&>(*this);
+}
+
+} // namespace cellular
+
+#endif // CELLULAR_STATIC_HPP_
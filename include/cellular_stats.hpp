@@ -0,0 +1,181 @@
+#ifndef CELLULAR_STATS_HPP_
+#define CELLULAR_STATS_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// Whether `Automaton` collects per-generation statistics for its
+/// observers. Define it as 0 to compile the collection out entirely:
+/// observers can still be added, but they're never called, and stepping
+/// is exactly what it'd be without them.
+#ifndef CELLULAR_STATS
+#define CELLULAR_STATS 1
+#endif
+
+namespace cellular {
+
+/// What happened in one generation of an `Automaton`.
+struct GenerationStats {
+	/// The generation that was just computed.
+	size_t generation = 0;
+	/// Wall time the step took.
+	double seconds = 0;
+	/// Cells whose next state was computed. Less than the whole grid with
+	/// activity tracking.
+	size_t evaluated = 0;
+	/// Cells whose state changed.
+	size_t changed = 0;
+	/// Amount of cells in each state after the generation, indexed by the
+	/// state's value and up to the highest state present. Only counted for
+	/// single byte states, empty otherwise.
+	std::vector<size_t> population;
+};
+
+using StatsObserver = std::function<void(const GenerationStats&)>;
+
+/// Keeps the statistics of every generation it observes, and writes them out
+/// as CSV or JSON.
+class StatsLog {
+public:
+	/// `state_names` name the population columns in state order, states
+	/// past them are named by their value.
+	inline explicit StatsLog(std::vector<std::string> state_names = {});
+	/// An observer that appends to this log, which has to outlive it.
+	inline StatsObserver observer();
+	inline void          record(const GenerationStats& stats);
+	inline const std::vector<GenerationStats>& generations() const;
+	inline void                                clear();
+	/// One row per generation, with a header row. The population columns
+	/// go up to the highest state any generation had.
+	inline void write_csv(std::ostream& out) const;
+	/// An array with an object per generation, populations keyed by state
+	/// name.
+	inline void write_json(std::ostream& out) const;
+
+private:
+	inline size_t      states() const;
+	inline std::string state_name(const size_t state) const;
+
+	std::vector<std::string>     m_state_names;
+	std::vector<GenerationStats> m_generations;
+};
+
+namespace detail {
+	/// Counts gathered while computing part of a generation, for the
+	/// observers and the hash.
+	struct StepTally {
+		size_t evaluated = 0;
+		size_t changed   = 0;
+		/// Change in the amount of cells in each state.
+		std::array<std::ptrdiff_t, 256> population{};
+		/// The Zobrist keys of the changed cells' old and new states XORed
+		/// together, which XORs the grid's hash into the next one's.
+		std::uint64_t hash = 0;
+
+		template<typename StateType>
+		void count_change(const StateType from, const StateType to) {
+			++changed;
+			if constexpr (sizeof(StateType) == 1) {
+				--population[static_cast<std::uint8_t>(from)];
+				++population[static_cast<std::uint8_t>(to)];
+			}
+		}
+	};
+
+	/// The tallies of a whole generation, merged from the tasks computing
+	/// it concurrently.
+	struct GenerationTally {
+		std::mutex mutex;
+		StepTally  total;
+
+		void merge(const StepTally& tally) {
+			std::lock_guard lock(mutex);
+			total.evaluated += tally.evaluated;
+			total.changed += tally.changed;
+			total.hash ^= tally.hash;
+			for (size_t i = 0; i < tally.population.size(); ++i) {
+				total.population[i] += tally.population[i];
+			}
+		}
+	};
+} // namespace detail
+
+inline StatsLog::StatsLog(std::vector<std::string> state_names) :
+    m_state_names(std::move(state_names)) {}
+
+inline StatsObserver StatsLog::observer() {
+	return [this](const GenerationStats& stats) { record(stats); };
+}
+
+inline void StatsLog::record(const GenerationStats& stats) {
+	m_generations.push_back(stats);
+}
+
+inline const std::vector<GenerationStats>& StatsLog::generations() const {
+	return m_generations;
+}
+
+inline void StatsLog::clear() {
+	m_generations.clear();
+}
+
+inline size_t StatsLog::states() const {
+	size_t ret = 0;
+	for (const GenerationStats& stats : m_generations) {
+		ret = std::max(ret, stats.population.size());
+	}
+	return ret;
+}
+
+inline std::string StatsLog::state_name(const size_t state) const {
+	if (state < m_state_names.size()) { return m_state_names[state]; }
+	return "state_" + std::to_string(state);
+}
+
+inline void StatsLog::write_csv(std::ostream& out) const {
+	const size_t states = this->states();
+	out << "generation,seconds,evaluated,changed";
+	for (size_t state = 0; state < states; ++state) {
+		out << ',' << state_name(state);
+	}
+	out << '\n';
+	for (const GenerationStats& stats : m_generations) {
+		out << stats.generation << ',' << stats.seconds << ','
+		    << stats.evaluated << ',' << stats.changed;
+		for (size_t state = 0; state < states; ++state) {
+			out << ','
+			    << (state < stats.population.size() ? stats.population[state]
+			                                        : 0);
+		}
+		out << '\n';
+	}
+}
+
+inline void StatsLog::write_json(std::ostream& out) const {
+	out << '[';
+	for (size_t i = 0; i < m_generations.size(); ++i) {
+		const GenerationStats& stats = m_generations[i];
+		out << (i == 0 ? "\n" : ",\n") << "  {\"generation\": "
+		    << stats.generation << ", \"seconds\": " << stats.seconds
+		    << ", \"evaluated\": " << stats.evaluated
+		    << ", \"changed\": " << stats.changed << ", \"population\": {";
+		for (size_t state = 0; state < stats.population.size(); ++state) {
+			out << (state == 0 ? "" : ", ") << '"' << state_name(state)
+			    << "\": " << stats.population[state];
+		}
+		out << "}}";
+	}
+	out << "\n]\n";
+}
+
+} // namespace cellular
+
+#endif // CELLULAR_STATS_HPP_
@@ -0,0 +1,331 @@
+#ifndef CELLULAR_STREAM_HPP_
+#define CELLULAR_STREAM_HPP_
+
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cellular {
+
+/// A lazily evaluated sequence of `T`s, made by a coroutine that `co_yield`s
+/// them. Each value is only computed once iteration gets to it, and the
+/// reference the iterator hands out is valid until it's advanced. Exceptions
+/// thrown by the coroutine come out of `begin` and `++`.
+template<typename T>
+class Generator {
+public:
+	struct promise_type;
+	using Handle = std::coroutine_handle<promise_type>;
+
+	struct promise_type {
+		const T*           value = nullptr;
+		std::exception_ptr error;
+
+		Generator get_return_object() {
+			return Generator(Handle::from_promise(*this));
+		}
+		std::suspend_always initial_suspend() noexcept { return {}; }
+		std::suspend_always final_suspend() noexcept { return {}; }
+		std::suspend_always yield_value(const T& yielded) noexcept {
+			value = std::addressof(yielded);
+			return {};
+		}
+		void return_void() noexcept {}
+		void unhandled_exception() { error = std::current_exception(); }
+	};
+
+	class iterator {
+	public:
+		using value_type      = T;
+		using difference_type = std::ptrdiff_t;
+
+		inline const T& operator*() const { return *m_handle.promise().value; }
+		inline const T* operator->() const { return m_handle.promise().value; }
+		inline iterator& operator++() {
+			resume(m_handle);
+			return *this;
+		}
+		inline void operator++(int) { ++*this; }
+		inline bool operator==(std::default_sentinel_t) const {
+			return m_handle.done();
+		}
+
+	private:
+		friend class Generator;
+		inline explicit iterator(const Handle handle) : m_handle(handle) {}
+
+		Handle m_handle;
+	};
+
+	inline Generator(Generator&& other) noexcept :
+	    m_handle(std::exchange(other.m_handle, nullptr)) {}
+	inline Generator& operator=(Generator&& other) noexcept {
+		std::swap(m_handle, other.m_handle);
+		return *this;
+	}
+	inline ~Generator() {
+		if (m_handle) { m_handle.destroy(); }
+	}
+	/// Runs the coroutine up to its first value, so only call it once.
+	inline iterator begin() {
+		resume(m_handle);
+		return iterator(m_handle);
+	}
+	inline std::default_sentinel_t end() const { return {}; }
+
+private:
+	inline explicit Generator(const Handle handle) : m_handle(handle) {}
+	static inline void resume(const Handle handle) {
+		handle.resume();
+		if (handle.promise().error) {
+			std::rethrow_exception(handle.promise().error);
+		}
+	}
+
+	Handle m_handle;
+};
+
+/// A copy of the cells of a grid in some generation.
+template<typename StateType>
+class Snapshot {
+public:
+	/// Copy the cells of `grid`, anything with `width`, `height` and a const
+	/// `operator()`.
+	template<typename Grid>
+	inline void assign(const Grid& grid, const size_t generation);
+	inline const StateType& operator()(const size_t x, const size_t y) const;
+	inline size_t           width() const;
+	inline size_t           height() const;
+	inline size_t           generation() const;
+	/// The cells, cell (x, y) at `x * height() + y` like in the dense grid.
+	inline const StateType* data() const;
+
+private:
+	size_t                 m_width      = 0;
+	size_t                 m_height     = 0;
+	size_t                 m_generation = 0;
+	std::vector<StateType> m_cells;
+};
+
+template<typename T>
+template<typename Grid>
+inline void Snapshot<T>::assign(const Grid& grid, const size_t generation) {
+	m_width      = grid.width();
+	m_height     = grid.height();
+	m_generation = generation;
+	m_cells.resize(m_width * m_height);
+	for (size_t x = 0; x < m_width; ++x) {
+		T* const line = &m_cells[x * m_height];
+		for (size_t y = 0; y < m_height; ++y) { line[y] = grid(x, y); }
+	}
+}
+
+template<typename T>
+inline const T& Snapshot<T>::operator()(const size_t x, const size_t y) const {
+	return m_cells[x * m_height + y];
+}
+
+template<typename T>
+inline size_t Snapshot<T>::width() const {
+	return m_width;
+}
+
+template<typename T>
+inline size_t Snapshot<T>::height() const {
+	return m_height;
+}
+
+template<typename T>
+inline size_t Snapshot<T>::generation() const {
+	return m_generation;
+}
+
+template<typename T>
+inline const T* Snapshot<T>::data() const {
+	return m_cells.data();
+}
+
+namespace detail {
+	template<typename Grid>
+	using StateOf =
+	    std::decay_t<decltype(std::declval<const Grid&>()(size_t{}, size_t{}))>;
+
+	/// The generation `grid` is in, for grids that keep count.
+	template<typename Grid>
+	inline size_t generation_of(const Grid& grid) {
+		if constexpr (requires { grid.generation(); }) {
+			return static_cast<size_t>(grid.generation());
+		} else {
+			return 0;
+		}
+	}
+
+	/// Steps a grid on its own thread, copying every `stride`th generation
+	/// into a ring of snapshots that a consumer takes them out of. The
+	/// producer waits while every snapshot is ready or held, so it runs at
+	/// most `buffers - 1` snapshots ahead of the consumer.
+	template<typename Grid>
+	class SnapshotPipeline {
+	public:
+		using Frame = Snapshot<StateOf<Grid>>;
+
+		inline SnapshotPipeline(Grid&        automaton,
+		                        const size_t stride,
+		                        const size_t buffers) :
+		    m_automaton(automaton),
+		    m_stride(stride),
+		    m_snapshots(buffers) {
+			for (size_t i = 0; i < buffers; ++i) { m_free.push_back(i); }
+			m_thread = std::thread([this] { produce(); });
+		}
+		SnapshotPipeline(const SnapshotPipeline&) = delete;
+		inline ~SnapshotPipeline() {
+			{
+				std::lock_guard lock(m_mutex);
+				m_stop = true;
+			}
+			m_changed.notify_all();
+			m_thread.join();
+		}
+
+		/// The next snapshot, waiting for it if it isn't ready yet. The one
+		/// returned before goes back to the producer.
+		inline const Frame& next() {
+			std::unique_lock lock(m_mutex);
+			if (m_held) {
+				m_free.push_back(*m_held);
+				m_held.reset();
+				m_changed.notify_all();
+			}
+			m_changed.wait(lock,
+			               [this] { return !m_ready.empty() || m_error; });
+			if (m_ready.empty()) { std::rethrow_exception(m_error); }
+			m_held = m_ready.front();
+			m_ready.pop_front();
+			return m_snapshots[*m_held];
+		}
+
+	private:
+		inline void produce() {
+			try {
+				size_t generation = generation_of(m_automaton);
+				for (bool first = true;; first = false) {
+					if (!first) {
+						m_automaton.step(m_stride);
+						generation += m_stride;
+					}
+					size_t slot;
+					{
+						std::unique_lock lock(m_mutex);
+						m_changed.wait(lock, [this] {
+							return m_stop || !m_free.empty();
+						});
+						if (m_stop) { return; }
+						slot = m_free.front();
+						m_free.pop_front();
+					}
+					// The slot is the producer's alone until it's ready.
+					m_snapshots[slot].assign(m_automaton, generation);
+					{
+						std::lock_guard lock(m_mutex);
+						m_ready.push_back(slot);
+					}
+					m_changed.notify_all();
+				}
+			} catch (...) {
+				{
+					std::lock_guard lock(m_mutex);
+					m_error = std::current_exception();
+				}
+				m_changed.notify_all();
+			}
+		}
+
+		Grid&              m_automaton;
+		size_t             m_stride;
+		std::vector<Frame> m_snapshots;
+		/// Indices into `m_snapshots`, by who they're with.
+		std::deque<size_t>      m_free;
+		std::deque<size_t>      m_ready;
+		std::optional<size_t>   m_held;
+		bool                    m_stop = false;
+		std::exception_ptr      m_error;
+		std::mutex              m_mutex;
+		std::condition_variable m_changed;
+		std::thread             m_thread;
+	};
+
+	template<typename Grid>
+	inline Generator<Grid> generations(Grid& automaton, const size_t stride) {
+		for (;;) {
+			co_yield automaton;
+			automaton.step(stride);
+		}
+	}
+
+	template<typename Grid>
+	inline Generator<Snapshot<StateOf<Grid>>>
+	pipelined_generations(Grid&        automaton,
+	                      const size_t stride,
+	                      const size_t buffers) {
+		SnapshotPipeline<Grid> pipeline(automaton, stride, buffers);
+		for (;;) { co_yield pipeline.next(); }
+	}
+
+	inline void check_stride(const size_t stride) {
+		if (stride == 0) {
+			throw std::invalid_argument("the stride has to be at least 1");
+		}
+	}
+} // namespace detail
+
+/// `automaton` in its current generation and then every `stride`th one after
+/// it, as a read-only view of the automaton itself. Generations are only
+/// stepped once the next one is asked for. The stream is endless, so stop
+/// iterating when done, and `automaton` has to outlive it.
+///
+///     for (const GameOfLife& grid : generations(automaton, 10)) {
+///         write(grid);
+///         if (grid.generation() == 1000) { break; }
+///     }
+template<typename Grid>
+inline Generator<Grid> generations(Grid& automaton, const size_t stride = 1) {
+	detail::check_stride(stride);
+	return detail::generations(automaton, stride);
+}
+
+/// Like `generations`, but `automaton` is stepped on a thread of its own
+/// while the consumer works on copies of its cells, so consuming one
+/// generation overlaps with computing the next ones. Snapshots come from a
+/// ring of `buffers`, and the thread waits when it's `buffers - 1` of them
+/// ahead of the consumer. Each snapshot is valid until the next one is
+/// asked for. `automaton` is stepped from the first snapshot on until the
+/// stream is destroyed, and mustn't be touched in between.
+template<typename Grid>
+inline Generator<Snapshot<detail::StateOf<Grid>>>
+pipelined_generations(Grid&        automaton,
+                      const size_t stride  = 1,
+                      const size_t buffers = 3) {
+	detail::check_stride(stride);
+	if (buffers < 2) {
+		throw std::invalid_argument(
+		    "the consumer holds one snapshot while the next one is made, so "
+		    "it takes at least 2 buffers");
+	}
+	return detail::pipelined_generations(automaton, stride, buffers);
+}
+
+} // namespace cellular
+
+#endif // CELLULAR_STREAM_HPP_
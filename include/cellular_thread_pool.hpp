@@ -0,0 +1,135 @@
+#ifndef CELLULAR_THREAD_POOL_HPP_
+#define CELLULAR_THREAD_POOL_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cellular {
+
+/// A fixed set of persistent worker threads that run data-parallel loops.
+/// The thread calling `parallel_for` takes part in the loop, so a pool of
+/// size n starts n - 1 threads.
+class ThreadPool {
+public:
+	inline explicit ThreadPool(
+	    const size_t threads = std::thread::hardware_concurrency());
+	inline ~ThreadPool();
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+	/// Amount of threads that run a loop, including the calling one.
+	inline size_t size() const;
+	/// Run `task(i)` for every i in [0, `count`) and wait for all of them to
+	/// finish. Indices are handed out dynamically, so uneven tasks balance
+	/// out. The first exception thrown by a task is rethrown here.
+	inline void parallel_for(const size_t                       count,
+	                         const std::function<void(size_t)>& task);
+
+private:
+	inline void worker();
+	/// Run tasks of the current loop until there are none left.
+	inline void drain();
+
+	std::vector<std::thread> m_workers;
+	/// Serializes concurrent `parallel_for` calls.
+	std::mutex              m_loop_mutex;
+	std::mutex              m_mutex;
+	std::condition_variable m_wake;
+	std::condition_variable m_done;
+	/// Bumped for every loop so the workers can tell a new one started.
+	std::uint64_t                      m_loop     = 0;
+	bool                               m_stopping = false;
+	const std::function<void(size_t)>* m_task     = nullptr;
+	size_t                             m_count    = 0;
+	std::atomic<size_t>                m_next{0};
+	/// Workers that haven't finished the current loop yet.
+	size_t             m_busy = 0;
+	std::exception_ptr m_error;
+};
+
+inline ThreadPool::ThreadPool(const size_t threads) {
+	const size_t workers = std::max<size_t>(threads, 1) - 1;
+	m_workers.reserve(workers);
+	for (size_t i = 0; i < workers; ++i) {
+		m_workers.emplace_back([this] { worker(); });
+	}
+}
+
+inline ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard lock(m_mutex);
+		m_stopping = true;
+	}
+	m_wake.notify_all();
+	for (std::thread& t : m_workers) { t.join(); }
+}
+
+inline size_t ThreadPool::size() const {
+	return m_workers.size() + 1;
+}
+
+inline void ThreadPool::parallel_for(const size_t                       count,
+                                     const std::function<void(size_t)>& task) {
+	if (count == 0) { return; }
+	if (m_workers.empty() || count == 1) {
+		for (size_t i = 0; i < count; ++i) { task(i); }
+		return;
+	}
+
+	std::lock_guard loop_lock(m_loop_mutex);
+	{
+		std::lock_guard lock(m_mutex);
+		m_task  = &task;
+		m_count = count;
+		m_next  = 0;
+		m_busy  = m_workers.size();
+		m_error = nullptr;
+		++m_loop;
+	}
+	m_wake.notify_all();
+
+	drain();
+
+	std::unique_lock lock(m_mutex);
+	m_done.wait(lock, [this] { return m_busy == 0; });
+	m_task = nullptr;
+	if (m_error) { std::rethrow_exception(m_error); }
+}
+
+inline void ThreadPool::worker() {
+	std::uint64_t seen = 0;
+	while (true) {
+		{
+			std::unique_lock lock(m_mutex);
+			m_wake.wait(lock, [&] { return m_stopping || m_loop != seen; });
+			if (m_stopping) { return; }
+			seen = m_loop;
+		}
+
+		drain();
+
+		std::lock_guard lock(m_mutex);
+		if (--m_busy == 0) { m_done.notify_one(); }
+	}
+}
+
+inline void ThreadPool::drain() {
+	for (size_t i = m_next++; i < m_count; i = m_next++) {
+		try {
+			(*m_task)(i);
+		} catch (...) {
+			std::lock_guard lock(m_mutex);
+			if (!m_error) { m_error = std::current_exception(); }
+		}
+	}
+}
+
+} // namespace cellular
+
+#endif // CELLULAR_THREAD_POOL_HPP_
@@ -0,0 +1,662 @@
+// Headless batch runner: load a pattern, run it for a number of generations
+// and print the final grid and statistics, without SDL or a render loop.
+//
+// Usage: cellular [options] PATTERN
+//   --automaton gol|wireworld       (default gol)
+//   --engine dense|packed|hashlife|sparse
+//                                   Game of Life engine (default dense)
+//   --engine dense|event            Wireworld engine (default dense)
+//   --rule RULE                     Life-like or Generations rule such as
+//                                   B36/S23 or /2/3, not for HashLife
+//   --generations N                 (default 100)
+//   --until-stable                  stop early once the grid repeats one of
+//                                   its last 64 generations, dense only
+//   --threads N                     dense engine only (default 1)
+//   --boundary dead|toroidal|reflective
+//                                   dense and event engines (default dead)
+//   --track-activity                dense engine only
+//   --restore                       PATTERN is a checkpoint, dense only
+//   --output PATH                   final grid as plain text, - for stdout
+//   --checkpoint PATH               final grid as a checkpoint, dense only
+//   --stats PATH                    statistics of every generation as CSV,
+//                                   or JSON if PATH ends in .json, dense only
+//   --json                          statistics as JSON
+//   --frames DIR                    every generation as a PPM file in DIR,
+//                                   dense only
+//   --video PATH                    every generation as raw rgb24 video, -
+//                                   for stdout, dense only
+//   --gray                          PGM frames and gray video instead
+//   --scale N                       pixels per cell side (default 1)
+//
+// HashLife and the sparse engine run on an infinite plane, the final grid is
+// the window of it that the pattern was loaded into.
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cellular_export.hpp"
+#include "cellular_sparse.hpp"
+#include "event_wireworld.hpp"
+#include "game_of_life.hpp"
+#include "hashlife.hpp"
+#include "life_like.hpp"
+#include "packed_game_of_life.hpp"
+#include "wireworld.hpp"
+
+namespace {
+struct Options {
+	std::string                 automaton   = "gol";
+	std::string                 engine      = "dense";
+	size_t                      generations = 100;
+	size_t                      threads     = 1;
+	Boundary                    boundary    = Boundary::dead;
+	bool                        track       = false;
+	bool                        restore     = false;
+	bool                        json        = false;
+	bool                        stable      = false;
+	bool                        gray        = false;
+	size_t                      scale       = 1;
+	std::filesystem::path       pattern;
+	std::optional<std::string>  output;
+	std::optional<LifeLikeRule> rule;
+	std::optional<std::string>  checkpoint;
+	std::optional<std::string>  stats;
+	std::optional<std::string>  frames;
+	std::optional<std::string>  video;
+};
+
+struct Statistics {
+	size_t width;
+	size_t height;
+	size_t generations;
+	/// Time taken to load the pattern and to run it.
+	double load_seconds;
+	double run_seconds;
+	/// Amount of cells in every state, in the order of the state enum.
+	std::vector<std::pair<std::string, size_t>> states;
+	/// What `--until-stable` found, and how many generations it ran.
+	std::optional<Stabilization> stabilization = std::nullopt;
+	size_t                       stepped = 0;
+};
+
+const char* usage =
+    "usage: cellular [--automaton gol|wireworld]\n"
+    "                [--engine dense|packed|hashlife|sparse|event]\n"
+    "                [--rule RULE]\n"
+    "                [--generations N] [--until-stable] [--threads N]\n"
+    "                [--boundary dead|toroidal|reflective] [--track-activity]\n"
+    "                [--restore] [--output PATH] [--checkpoint PATH]\n"
+    "                [--stats PATH] [--json] [--frames DIR] [--video PATH]\n"
+    "                [--gray] [--scale N] PATTERN\n";
+
+Options parse_options(const int argc, char** argv) {
+	Options options;
+	for (int i = 1; i < argc; ++i) {
+		const std::string option = argv[i];
+		auto              value  = [&]() -> std::string {
+			if (i + 1 == argc) {
+				throw std::invalid_argument("missing value for " + option);
+			}
+			return argv[++i];
+		};
+		if (option == "--automaton") {
+			options.automaton = value();
+		} else if (option == "--engine") {
+			options.engine = value();
+		} else if (option == "--rule") {
+			options.rule = LifeLikeRule::parse(value());
+		} else if (option == "--generations") {
+			options.generations = std::stoul(value());
+		} else if (option == "--until-stable") {
+			options.stable = true;
+		} else if (option == "--threads") {
+			options.threads = std::stoul(value());
+		} else if (option == "--boundary") {
+			const std::string boundary = value();
+			if (boundary == "dead") {
+				options.boundary = Boundary::dead;
+			} else if (boundary == "toroidal") {
+				options.boundary = Boundary::toroidal;
+			} else if (boundary == "reflective") {
+				options.boundary = Boundary::reflective;
+			} else {
+				throw std::invalid_argument("unknown boundary " + boundary);
+			}
+		} else if (option == "--track-activity") {
+			options.track = true;
+		} else if (option == "--restore") {
+			options.restore = true;
+		} else if (option == "--output") {
+			options.output = value();
+		} else if (option == "--checkpoint") {
+			options.checkpoint = value();
+		} else if (option == "--stats") {
+			options.stats = value();
+		} else if (option == "--json") {
+			options.json = true;
+		} else if (option == "--frames") {
+			options.frames = value();
+		} else if (option == "--video") {
+			options.video = value();
+		} else if (option == "--gray") {
+			options.gray = true;
+		} else if (option == "--scale") {
+			options.scale = std::stoul(value());
+		} else if (option == "--help" || option == "-h") {
+			std::fputs(usage, stdout);
+			std::exit(0);
+		} else if (!option.empty() && option[0] == '-') {
+			throw std::invalid_argument("unknown option " + option);
+		} else if (options.pattern.empty()) {
+			options.pattern = option;
+		} else {
+			throw std::invalid_argument("more than one pattern given");
+		}
+	}
+
+	if (options.pattern.empty()) {
+		throw std::invalid_argument("no pattern given");
+	}
+	if (options.automaton != "gol" && options.automaton != "wireworld") {
+		throw std::invalid_argument("unknown automaton " + options.automaton);
+	}
+	if (options.engine != "dense" && options.engine != "packed"
+	    && options.engine != "hashlife" && options.engine != "sparse"
+	    && options.engine != "event") {
+		throw std::invalid_argument("unknown engine " + options.engine);
+	}
+	if (options.automaton == "wireworld" && options.engine != "dense"
+	    && options.engine != "event") {
+		throw std::invalid_argument("Wireworld has the dense and event"
+		                            " engines");
+	}
+	if (options.automaton == "gol" && options.engine == "event") {
+		throw std::invalid_argument("the event engine is for Wireworld");
+	}
+	if (options.rule
+	    && (options.automaton != "gol" || options.engine == "hashlife")) {
+		throw std::invalid_argument("--rule needs the Game of Life dense,"
+		                            " packed or sparse engine");
+	}
+	if (options.rule && options.rule->states > 2
+	    && options.engine != "dense") {
+		throw std::invalid_argument("Generations rules need the dense engine");
+	}
+	const bool dense_only = options.threads != 1 || options.track
+	                        || options.restore || options.checkpoint
+	                        || options.stats || options.stable
+	                        || options.frames || options.video;
+	if (options.engine != "dense" && dense_only) {
+		throw std::invalid_argument("--threads, --track-activity, --restore,"
+		                            " --checkpoint, --stats, --until-stable,"
+		                            " --frames and --video need the dense"
+		                            " engine");
+	}
+	if (options.frames && options.video) {
+		throw std::invalid_argument("--frames and --video can't be combined");
+	}
+	if ((options.frames || options.video) && options.stable) {
+		throw std::invalid_argument("--until-stable can't export frames");
+	}
+	if (options.video == "-" && options.output == "-") {
+		throw std::invalid_argument("--video and --output can't both be -");
+	}
+	if (options.scale == 0) {
+		throw std::invalid_argument("--scale has to be at least 1");
+	}
+	if (options.boundary != Boundary::dead && options.engine != "dense"
+	    && options.engine != "event") {
+		throw std::invalid_argument("--boundary needs the dense or event"
+		                            " engine");
+	}
+	return options;
+}
+
+double seconds_since(const std::chrono::steady_clock::time_point start) {
+	const std::chrono::duration<double> elapsed =
+	    std::chrono::steady_clock::now() - start;
+	return elapsed.count();
+}
+
+/// Write `automaton` as plain text, which `set_grid_from_file` reads back.
+template<typename Grid, typename ToChar>
+void write_grid(const Grid&    automaton,
+                const ToChar&  to_char,
+                const Options& options) {
+	std::ofstream file;
+	if (*options.output != "-") {
+		file.open(*options.output, std::ios::binary);
+		if (!file) {
+			throw std::runtime_error("can't write " + *options.output);
+		}
+	}
+	std::ostream& out = *options.output == "-" ? std::cout : file;
+	std::string   line(automaton.width(), ' ');
+	for (size_t y = 0; y < automaton.height(); ++y) {
+		for (size_t x = 0; x < automaton.width(); ++x) {
+			line[x] = to_char(automaton(x, y));
+		}
+		out << line << '\n';
+	}
+}
+
+/// Names of the states of an automaton.
+template<typename State, size_t N>
+using StateNames = std::array<std::pair<const char*, State>, N>;
+
+/// The amount of cells of `automaton` in each of `states`.
+template<typename Grid, typename State, size_t N>
+std::vector<std::pair<std::string, size_t>>
+count_states(const Grid& automaton, const StateNames<State, N>& states) {
+	std::array<size_t, N> counts{};
+	for (size_t x = 0; x < automaton.width(); ++x) {
+		for (size_t y = 0; y < automaton.height(); ++y) {
+			const State state = automaton(x, y);
+			for (size_t i = 0; i < N; ++i) {
+				counts[i] += state == states[i].second;
+			}
+		}
+	}
+	std::vector<std::pair<std::string, size_t>> ret;
+	for (size_t i = 0; i < N; ++i) {
+		ret.emplace_back(states[i].first, counts[i]);
+	}
+	return ret;
+}
+
+/// Step `automaton` by `options.generations`, exporting every generation
+/// including the first to `--frames` or `--video`.
+template<typename Dense, typename State>
+void run_exporting(Dense&                automaton,
+                   const Palette<State>& palette,
+                   const Options&        options) {
+	ExportOptions export_options;
+	export_options.scale = options.scale;
+	std::ofstream file;
+	if (options.frames) {
+		export_options.format    = options.gray ? FrameFormat::pgm
+		                                        : FrameFormat::ppm;
+		export_options.directory = *options.frames;
+		std::filesystem::create_directories(export_options.directory);
+	} else {
+		export_options.format = options.gray ? FrameFormat::raw_gray
+		                                     : FrameFormat::raw_rgb;
+		if (*options.video != "-") {
+			file.open(*options.video, std::ios::binary);
+			if (!file) {
+				throw std::runtime_error("can't write " + *options.video);
+			}
+		}
+		export_options.stream = *options.video == "-" ? &std::cout : &file;
+	}
+	FrameExporter<State> exporter(palette, export_options);
+	exporter.submit(automaton);
+	for (size_t i = 0; i < options.generations; ++i) {
+		automaton.step();
+		exporter.submit(automaton);
+	}
+	exporter.finish();
+}
+
+/// Load, run and report on one of the `Automaton` based automata, built
+/// with `arguments` after its size. Frames are colored with `palette`.
+template<typename Dense, typename State, size_t N, typename... Arguments>
+Statistics run_dense(const Options&              options,
+                     const StateNames<State, N>& states,
+                     const Palette<State>&       palette,
+                     const Arguments&... arguments) {
+	auto  start = std::chrono::steady_clock::now();
+	Dense automaton(1, 1, arguments...);
+	if (options.restore) {
+		automaton.restore_checkpoint(options.pattern);
+	} else {
+		automaton.set_grid_from_file(options.pattern);
+		automaton.set_boundary(options.boundary);
+	}
+	automaton.set_threads(options.threads);
+	automaton.set_activity_tracking(options.track);
+	std::vector<std::string> state_names;
+	for (const auto& [name, state] : states) { state_names.push_back(name); }
+	StatsLog log(std::move(state_names));
+	if (options.stats) { automaton.add_observer(log.observer()); }
+	const double load_seconds = seconds_since(start);
+
+	start = std::chrono::steady_clock::now();
+	const size_t                 first = automaton.generation();
+	std::optional<Stabilization> stabilization;
+	if (options.stable) {
+		stabilization = automaton.run_until_stable(options.generations);
+	} else if (options.frames || options.video) {
+		run_exporting(automaton, palette, options);
+	} else {
+		automaton.step(options.generations);
+	}
+	const double run_seconds = seconds_since(start);
+
+	if (options.stats) {
+		std::ofstream file(*options.stats);
+		if (!file) {
+			throw std::runtime_error("can't write " + *options.stats);
+		}
+		const std::filesystem::path path = *options.stats;
+		if (path.extension() == ".json") {
+			log.write_json(file);
+		} else {
+			log.write_csv(file);
+		}
+	}
+
+	if (options.output) {
+		write_grid(
+		    automaton,
+		    [&](const State state) { return automaton.state_to_char(state); },
+		    options);
+	}
+	if (options.checkpoint) { automaton.save_checkpoint(*options.checkpoint); }
+	return {automaton.width(),
+	        automaton.height(),
+	        automaton.generation(),
+	        load_seconds,
+	        run_seconds,
+	        count_states(automaton, states),
+	        stabilization,
+	        automaton.generation() - first};
+}
+
+const StateNames<gol::State, 2> life_states{{
+    {"dead", gol::State::Dead},
+    {"alive", gol::State::Alive},
+}};
+
+const Palette<gol::State> life_palette{
+    {gol::State::Dead, {0, 0, 0}},
+    {gol::State::Alive, {255, 255, 255}},
+};
+
+Statistics run_packed(const Options& options) {
+	auto                  start = std::chrono::steady_clock::now();
+	gol::PackedGameOfLife automaton(options.pattern);
+	if (options.rule) { automaton.set_rule(*options.rule); }
+	const double          load_seconds = seconds_since(start);
+
+	start = std::chrono::steady_clock::now();
+	automaton.step(options.generations);
+	const double run_seconds = seconds_since(start);
+
+	if (options.output) {
+		const gol::GameOfLife characters(1, 1);
+		write_grid(
+		    automaton,
+		    [&](const gol::State state) {
+			    return characters.state_to_char(state);
+		    },
+		    options);
+	}
+	const size_t alive = automaton.population();
+	return {automaton.width(),
+	        automaton.height(),
+	        options.generations,
+	        load_seconds,
+	        run_seconds,
+	        {{"dead", automaton.width() * automaton.height() - alive},
+	         {"alive", alive}}};
+}
+
+Statistics run_hashlife(const Options& options) {
+	auto            start = std::chrono::steady_clock::now();
+	gol::GameOfLife window(options.pattern);
+	gol::HashLife   automaton(window);
+	const double    load_seconds = seconds_since(start);
+
+	start = std::chrono::steady_clock::now();
+	automaton.advance(options.generations);
+	const double run_seconds = seconds_since(start);
+
+	automaton.copy_to(window);
+	if (options.output) {
+		write_grid(
+		    window,
+		    [&](const gol::State state) { return window.state_to_char(state); },
+		    options);
+	}
+	// The population of the whole plane, which can be more than the
+	// window's.
+	const size_t alive = automaton.population();
+	return {window.width(),
+	        window.height(),
+	        automaton.generation(),
+	        load_seconds,
+	        run_seconds,
+	        {{"dead", window.width() * window.height() - alive},
+	         {"alive", alive}}};
+}
+
+Statistics run_sparse(const Options& options) {
+	auto                        start = std::chrono::steady_clock::now();
+	gol::GameOfLife             window(options.pattern);
+	SparseAutomaton<gol::State> automaton(
+	    options.rule.value_or(rules::life).count_rule());
+	automaton.assign(window);
+	const double load_seconds = seconds_since(start);
+
+	start = std::chrono::steady_clock::now();
+	automaton.step(options.generations);
+	const double run_seconds = seconds_since(start);
+
+	automaton.copy_to(window);
+	if (options.output) {
+		write_grid(
+		    window,
+		    [&](const gol::State state) { return window.state_to_char(state); },
+		    options);
+	}
+	// The population of the whole plane, like HashLife's.
+	const size_t alive = automaton.population();
+	return {window.width(),
+	        window.height(),
+	        automaton.generation(),
+	        load_seconds,
+	        run_seconds,
+	        {{"dead", window.width() * window.height() - alive},
+	         {"alive", alive}}};
+}
+
+/// Wireworld through `EventWireworld`, counting `states` like `run_dense`.
+Statistics run_event(const Options&                        options,
+                     const StateNames<wireworld::State, 4>& states) {
+	auto                 start = std::chrono::steady_clock::now();
+	wireworld::Wireworld dense(options.pattern);
+	dense.set_boundary(options.boundary);
+	wireworld::EventWireworld automaton(dense);
+	const double              load_seconds = seconds_since(start);
+
+	start = std::chrono::steady_clock::now();
+	automaton.step(options.generations);
+	const double run_seconds = seconds_since(start);
+
+	if (options.output) {
+		automaton.copy_to(dense);
+		write_grid(
+		    dense,
+		    [&](const wireworld::State state) {
+			    return dense.state_to_char(state);
+		    },
+		    options);
+	}
+	return {automaton.width(),
+	        automaton.height(),
+	        automaton.generation(),
+	        load_seconds,
+	        run_seconds,
+	        count_states(automaton, states)};
+}
+
+void print(const Statistics& statistics, const Options& options) {
+	// Keep stdout for the grid or the video if they're going there.
+	FILE* const  out     = options.output == "-" || options.video == "-"
+	                           ? stderr
+	                           : stdout;
+	const size_t stepped = statistics.stabilization ? statistics.stepped
+	                                                : options.generations;
+	const double cells   = static_cast<double>(statistics.width)
+	                     * statistics.height * stepped;
+	const double cells_per_second =
+	    statistics.run_seconds > 0 ? cells / statistics.run_seconds : 0;
+	// Game of Life runs B3/S23 unless told otherwise.
+	const std::string rule = options.rule ? options.rule->to_string()
+	                         : options.automaton == "gol" ? "B3/S23"
+	                                                      : "";
+	const char* stable = "";
+	if (statistics.stabilization) {
+		switch (statistics.stabilization->kind) {
+		case Stabilization::Kind::unsettled:
+			stable = "unsettled";
+			break;
+		case Stabilization::Kind::extinct:
+			stable = "extinct";
+			break;
+		case Stabilization::Kind::still:
+			stable = "still";
+			break;
+		case Stabilization::Kind::oscillating:
+			stable = "oscillating";
+			break;
+		}
+	}
+	if (options.json) {
+		std::fprintf(out,
+		             "{\"automaton\": \"%s\", \"engine\": \"%s\", "
+		             "\"rule\": \"%s\", "
+		             "\"width\": %zu, \"height\": %zu, \"generation\": %zu, "
+		             "\"threads\": %zu, \"load_seconds\": %.6f, "
+		             "\"run_seconds\": %.6f, \"cells_per_second\": %.6g, "
+		             "\"states\": {",
+		             options.automaton.c_str(),
+		             options.engine.c_str(),
+		             rule.c_str(),
+		             statistics.width,
+		             statistics.height,
+		             statistics.generations,
+		             options.threads,
+		             statistics.load_seconds,
+		             statistics.run_seconds,
+		             cells_per_second);
+		for (size_t i = 0; i < statistics.states.size(); ++i) {
+			std::fprintf(out,
+			             "%s\"%s\": %zu",
+			             i == 0 ? "" : ", ",
+			             statistics.states[i].first.c_str(),
+			             statistics.states[i].second);
+		}
+		std::fprintf(out, "}");
+		if (statistics.stabilization) {
+			std::fprintf(out,
+			             ", \"stable\": {\"kind\": \"%s\", \"period\": %zu, "
+			             "\"generation\": %zu}",
+			             stable,
+			             statistics.stabilization->period,
+			             statistics.stabilization->generation);
+		}
+		std::fprintf(out, "}\n");
+		return;
+	}
+	std::fprintf(out, "automaton:    %s\n", options.automaton.c_str());
+	std::fprintf(out, "engine:       %s\n", options.engine.c_str());
+	if (!rule.empty()) {
+		std::fprintf(out, "rule:         %s\n", rule.c_str());
+	}
+	std::fprintf(out,
+	             "size:         %zux%zu\n",
+	             statistics.width,
+	             statistics.height);
+	std::fprintf(out, "generation:   %zu\n", statistics.generations);
+	std::fprintf(out, "threads:      %zu\n", options.threads);
+	if (statistics.stabilization) {
+		std::fprintf(out,
+		             "stable:       %s, period %zu from generation %zu\n",
+		             stable,
+		             statistics.stabilization->period,
+		             statistics.stabilization->generation);
+	}
+	for (const auto& [name, count] : statistics.states) {
+		std::fprintf(out, "%-13s %zu\n", (name + ':').c_str(), count);
+	}
+	std::fprintf(out, "load time:    %.6f s\n", statistics.load_seconds);
+	std::fprintf(out, "run time:     %.6f s\n", statistics.run_seconds);
+	std::fprintf(out, "cells/s:      %.6g\n", cells_per_second);
+}
+} // namespace
+
+int main(int argc, char** argv) {
+	Options options;
+	try {
+		options = parse_options(argc, argv);
+	} catch (const std::exception& error) {
+		std::fprintf(stderr, "cellular: %s\n%s", error.what(), usage);
+		return 2;
+	}
+
+	try {
+		Statistics statistics;
+		if (options.automaton == "wireworld") {
+			using wireworld::State;
+			const StateNames<State, 4> states{{
+			    {"empty", State::Empty},
+			    {"heads", State::ElectronHead},
+			    {"tails", State::ElectronTail},
+			    {"conductors", State::Conductor},
+			}};
+			const Palette<State> palette{
+			    {State::Empty, {0, 0, 0}},
+			    {State::ElectronHead, {0, 64, 255}},
+			    {State::ElectronTail, {255, 32, 0}},
+			    {State::Conductor, {255, 200, 0}},
+			};
+			statistics =
+			    options.engine == "event"
+			        ? run_event(options, states)
+			        : run_dense<wireworld::Wireworld>(options, states, palette);
+		} else if (options.rule && options.engine == "dense") {
+			// Dying states of Generations rules are neither dead nor alive.
+			const StateNames<life_like::State, 2> states{{
+			    {"dead", 0},
+			    {"alive", 1},
+			}};
+			// Dying states fade from light to dark gray.
+			Palette<life_like::State> palette{{1, {255, 255, 255}}};
+			const size_t              dying = options.rule->states - 2;
+			for (size_t i = 0; i < dying; ++i) {
+				const auto level =
+				    static_cast<std::uint8_t>(192 - 160 * i / dying);
+				palette.set(static_cast<life_like::State>(i + 2),
+				            {level, level, level});
+			}
+			statistics = run_dense<life_like::LifeLike>(
+			    options, states, palette, *options.rule);
+		} else if (options.engine == "packed") {
+			statistics = run_packed(options);
+		} else if (options.engine == "hashlife") {
+			statistics = run_hashlife(options);
+		} else if (options.engine == "sparse") {
+			statistics = run_sparse(options);
+		} else {
+			statistics =
+			    run_dense<gol::GameOfLife>(options, life_states, life_palette);
+		}
+		print(statistics, options);
+	} catch (const std::exception& error) {
+		std::fprintf(stderr, "cellular: %s\n", error.what());
+		return 1;
+	}
+	return 0;
+}
@@ -3,8 +3,20 @@
 
 #include <SDL2/SDL.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
 #include <functional>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "cellular.hpp"
 
@@ -15,24 +27,297 @@ namespace cellular_gui {
 template<typename State>
 using ColorFunctor = std::function<SDL_Color(State)>;
 
-template<typename State>
-int draw_grid(Automaton<State>&     automaton,
-              ColorFunctor<State>&& state_to_color);
+// Frames of cell colors handed from the simulation thread to the renderer,
+// one 0xAARRGGBB pixel per cell in rows. There are three: the simulation
+// writes to its own and swaps it with the middle one, and the renderer
+// swaps its own with the middle one when a new frame is there. Neither ever
+// touches the frame the other one has, so frames never tear.
+class FrameExchange {
+public:
+	explicit FrameExchange(const size_t cells) :
+	    m_back(cells), m_middle(cells), m_front(cells) {}
 
-template<typename State>
-int draw_grid(Automaton<State>&     automaton,
-              ColorFunctor<State>&& state_to_color) {
-	constexpr const SDL_Color WHITE     = {255, 255, 255, 255};
-	constexpr const SDL_Color BLACK     = {0, 0, 0, 255};
-	constexpr const int       grid_size = 20;
-	constexpr const int       cell_size = 36;
+	/// The frame the simulation writes to.
+	std::vector<std::uint32_t>& back() { return m_back; }
+	/// Hand the back frame over to the renderer.
+	void publish() {
+		std::lock_guard lock(m_mutex);
+		std::swap(m_back, m_middle);
+		m_fresh = true;
+	}
+	/// Whether the renderer took the last frame, so a new one is worth
+	/// making.
+	bool wanted() const { return !m_fresh; }
+	/// The newest frame, or `nullptr` if there's none since the last call.
+	const std::vector<std::uint32_t>* take() {
+		std::lock_guard lock(m_mutex);
+		if (!m_fresh) { return nullptr; }
+		std::swap(m_front, m_middle);
+		m_fresh = false;
+		return &m_front;
+	}
 
-	// + 1 so that the last grid lines fit in the screen.
-	int window_width  = (automaton.width() * cell_size) + 1;
-	int window_height = (automaton.height() * cell_size) + 1;
+private:
+	std::mutex                 m_mutex;
+	std::vector<std::uint32_t> m_back;
+	std::vector<std::uint32_t> m_middle;
+	std::vector<std::uint32_t> m_front;
+	std::atomic<bool>          m_fresh = false;
+};
+
+// Steps `automaton` on its own thread, continuously or at a target rate,
+// and publishes frames of it whenever the renderer took the last one. The
+// automaton must not be touched by anything else while this runs, edits go
+// through `toggle`.
+template<typename AutomatonType, typename State>
+class Simulation {
+public:
+	/// Step at `rate` generations per second, as fast as possible if it's 0.
+	Simulation(AutomatonType&        automaton,
+	           ColorFunctor<State>&& state_to_color,
+	           const double          rate) :
+	    m_automaton(automaton),
+	    m_state_to_color(std::move(state_to_color)),
+	    m_frames(automaton.width() * automaton.height()),
+	    m_rate(rate) {
+		publish();
+		m_thread = std::thread([this] { run(); });
+	}
+	~Simulation() {
+		{
+			std::lock_guard lock(m_mutex);
+			m_stopping = true;
+		}
+		m_wake.notify_one();
+		m_thread.join();
+	}
+	Simulation(const Simulation&) = delete;
+	Simulation& operator=(const Simulation&) = delete;
+
+	FrameExchange& frames() { return m_frames; }
+	size_t         generation() const { return m_generation; }
+	bool           running() const {
+		std::lock_guard lock(m_mutex);
+		return m_running;
+	}
+	double rate() const {
+		std::lock_guard lock(m_mutex);
+		return m_rate;
+	}
+	void set_running(const bool running) {
+		change([&] { m_running = running; });
+	}
+	void set_rate(const double rate) {
+		change([&] { m_rate = rate; });
+	}
+	/// Step once, running or not.
+	void step_once() {
+		change([&] { ++m_steps; });
+	}
+	/// Move the cell at (`x`, `y`) to its next state with `cycle_state`.
+	void toggle(const size_t x, const size_t y) {
+		change([&] { m_edits.emplace_back(x, y); });
+	}
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	/// How often a paused simulation checks whether the renderer took the
+	/// last frame.
+	static constexpr auto idle_poll = std::chrono::milliseconds(10);
+	/// How far behind the target rate stepping may fall before it stops
+	/// trying to catch up.
+	static constexpr auto max_lag = std::chrono::milliseconds(250);
+
+	template<typename Change>
+	void change(Change&& change) {
+		{
+			std::lock_guard lock(m_mutex);
+			change();
+		}
+		m_wake.notify_one();
+	}
+
+	void run() {
+		auto next  = Clock::now();
+		bool stale = false;
+		while (true) {
+			std::vector<std::pair<size_t, size_t>> edits;
+			bool                                   step = false;
+			{
+				std::unique_lock lock(m_mutex);
+				// Sleep while paused or ahead of the target rate, unless
+				// something else comes up.
+				if (!m_running || m_rate > 0) {
+					const auto until =
+					    m_running ? next : Clock::now() + idle_poll;
+					m_wake.wait_until(lock, until, [this] {
+						return m_stopping || !m_edits.empty() || m_steps > 0;
+					});
+				}
+				if (m_stopping) { return; }
+				std::swap(edits, m_edits);
+				const auto now = Clock::now();
+				if (m_steps > 0) {
+					--m_steps;
+					step = true;
+				} else if (m_running && (m_rate <= 0 || now >= next)) {
+					step = true;
+				}
+				if (!m_running) {
+					next = now;
+				} else if (step && m_rate > 0) {
+					const auto period =
+					    std::chrono::duration_cast<Clock::duration>(
+					        std::chrono::duration<double>(1 / m_rate));
+					next = std::max(next + period, now - max_lag);
+				}
+			}
+
+			for (const auto& [x, y] : edits) {
+				const State current = m_automaton(x, y);
+				m_automaton(x, y)   = m_automaton.cycle_state(current);
+			}
+			if (step) {
+				m_automaton.step();
+				++m_generation;
+			}
+			stale = stale || step || !edits.empty();
+			// Frames nobody would see aren't worth making.
+			if (stale && m_frames.wanted()) {
+				publish();
+				stale = false;
+			}
+		}
+	}
+
+	void publish() {
+		const AutomatonType& grid   = m_automaton;
+		const size_t         width  = grid.width();
+		const size_t         height = grid.height();
+		auto&                frame  = m_frames.back();
+		// In tiles, since the grid is stored in columns and frames in rows.
+		constexpr size_t tile = 64;
+		for (size_t x0 = 0; x0 < width; x0 += tile) {
+			for (size_t y0 = 0; y0 < height; y0 += tile) {
+				const size_t x1 = std::min(width, x0 + tile);
+				const size_t y1 = std::min(height, y0 + tile);
+				for (size_t x = x0; x < x1; ++x) {
+					for (size_t y = y0; y < y1; ++y) {
+						frame[y * width + x] = color(grid(x, y));
+					}
+				}
+			}
+		}
+		m_frames.publish();
+	}
+
+	std::uint32_t color(const State state) {
+		// Single byte states are looked up in a palette that's filled in
+		// as they're first seen, rather than calling back for every cell.
+		if constexpr (sizeof(State) == 1) {
+			const auto index = static_cast<std::uint8_t>(state);
+			if (!m_known[index]) {
+				m_palette[index] = pixel(m_state_to_color(state));
+				m_known[index]   = true;
+			}
+			return m_palette[index];
+		} else {
+			return pixel(m_state_to_color(state));
+		}
+	}
+
+	static std::uint32_t pixel(const SDL_Color color) {
+		return std::uint32_t{color.a} << 24 | std::uint32_t{color.r} << 16
+		       | std::uint32_t{color.g} << 8 | color.b;
+	}
+
+	AutomatonType&                 m_automaton;
+	ColorFunctor<State>            m_state_to_color;
+	std::array<std::uint32_t, 256> m_palette{};
+	std::array<bool, 256>          m_known{};
+	FrameExchange                  m_frames;
+	std::atomic<size_t>            m_generation = 0;
+
+	mutable std::mutex                     m_mutex;
+	std::condition_variable                m_wake;
+	bool                                   m_running  = true;
+	bool                                   m_stopping = false;
+	double                                 m_rate;
+	size_t                                 m_steps = 0;
+	std::vector<std::pair<size_t, size_t>> m_edits;
+	std::thread                            m_thread;
+};
+
+// Which part of the grid is on screen: the grid coordinates of the window's
+// top left corner, and how many pixels wide a cell is.
+struct Viewport {
+	double left = 0;
+	double top  = 0;
+	double zoom = 1;
+
+	static constexpr double min_zoom = 1.0 / 64;
+	static constexpr double max_zoom = 128;
+
+	double cell_x(const double pixel_x) const { return left + pixel_x / zoom; }
+	double cell_y(const double pixel_y) const { return top + pixel_y / zoom; }
+	/// Show all of a `width` by `height` grid, centered.
+	void fit(const size_t width,
+	         const size_t height,
+	         const int    window_width,
+	         const int    window_height) {
+		zoom = std::clamp(std::min(window_width / double(width),
+		                           window_height / double(height)),
+		                  min_zoom,
+		                  max_zoom);
+		left = (width - window_width / zoom) / 2;
+		top  = (height - window_height / zoom) / 2;
+	}
+	/// Zoom by `factor`, keeping the cell under the pixel (`x`, `y`) in place.
+	void zoom_at(const int x, const int y, const double factor) {
+		const double cx = cell_x(x);
+		const double cy = cell_y(y);
+		zoom            = std::clamp(zoom * factor, min_zoom, max_zoom);
+		left            = cx - x / zoom;
+		top             = cy - y / zoom;
+	}
+};
+
+// `AutomatonType` is any grid exposing `operator()`, `width()`, `height()`,
+// `step()` and `cycle_state()`, e.g. an `Automaton<State>` or
+// `gol::PackedGameOfLife`. It's stepped on its own thread at `rate`
+// generations per second, or as fast as it goes if `rate` is 0, and drawn
+// through a texture that every new generation is streamed into.
+template<typename AutomatonType, typename State>
+int draw_grid(AutomatonType&        automaton,
+              ColorFunctor<State>&& state_to_color,
+              const double          rate = 10);
+
+template<typename AutomatonType, typename State>
+int draw_grid(AutomatonType&        automaton,
+              ColorFunctor<State>&& state_to_color,
+              const double          rate) {
+	constexpr const SDL_Color WHITE = {255, 255, 255, 255};
+	constexpr const SDL_Color BLACK = {0, 0, 0, 255};
+	constexpr const SDL_Color GREY  = {64, 64, 64, 255};
+	// Cells are drawn this big if the whole grid fits in the largest window.
+	constexpr const int cell_size         = 36;
+	constexpr const int max_window_width  = 1280;
+	constexpr const int max_window_height = 800;
+	// Lines between cells are only drawn once cells are this wide.
+	constexpr const double line_zoom = 8;
 
-	const SDL_Color BACKGROUND_COLOR = WHITE;
-	SDL_Color       LINE_COLOR       = BLACK;
+	const SDL_Color BACKGROUND_COLOR = GREY;
+	const SDL_Color GRID_COLOR       = WHITE;
+	const SDL_Color LINE_COLOR       = BLACK;
+
+	const int grid_width  = static_cast<int>(automaton.width());
+	const int grid_height = static_cast<int>(automaton.height());
+	// + 1 so that the last grid lines fit in the screen.
+	int window_width =
+	    std::min(grid_width * cell_size + 1, max_window_width);
+	int window_height =
+	    std::min(grid_height * cell_size + 1, max_window_height);
 
 	if (SDL_Init(SDL_INIT_VIDEO) < 0) {
 		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
@@ -41,40 +326,153 @@ int draw_grid(Automaton<State>&     automaton,
 		return EXIT_FAILURE;
 	}
 
-	SDL_Window*   window;
-	SDL_Renderer* renderer;
-	if (SDL_CreateWindowAndRenderer(window_width,
-	                                window_height,
-	                                0,
-	                                &window,
-	                                &renderer)
-	    < 0) {
+	SDL_Window* window = SDL_CreateWindow("cellular++",
+	                                      SDL_WINDOWPOS_CENTERED,
+	                                      SDL_WINDOWPOS_CENTERED,
+	                                      window_width,
+	                                      window_height,
+	                                      SDL_WINDOW_RESIZABLE);
+	if (window == nullptr) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
+		             "SDL_CreateWindow error: %s",
+		             SDL_GetError());
+		SDL_Quit();
+		return EXIT_FAILURE;
+	}
+	// Presenting waits for the display, which paces the render loop.
+	SDL_Renderer* renderer = SDL_CreateRenderer(
+	    window,
+	    -1,
+	    SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+	if (renderer == nullptr) { renderer = SDL_CreateRenderer(window, -1, 0); }
+	if (renderer == nullptr) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
+		             "SDL_CreateRenderer error: %s",
+		             SDL_GetError());
+		SDL_DestroyWindow(window);
+		SDL_Quit();
+		return EXIT_FAILURE;
+	}
+
+	// One texel per cell, scaled up without smoothing.
+	SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "nearest");
+	SDL_Texture* texture = SDL_CreateTexture(renderer,
+	                                         SDL_PIXELFORMAT_ARGB8888,
+	                                         SDL_TEXTUREACCESS_STREAMING,
+	                                         grid_width,
+	                                         grid_height);
+	if (texture == nullptr) {
 		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
-		             "SDL_CreateWindowAndRenderer error: %s",
+		             "SDL_CreateTexture error: %s",
 		             SDL_GetError());
+		SDL_DestroyRenderer(renderer);
+		SDL_DestroyWindow(window);
+		SDL_Quit();
 		return EXIT_FAILURE;
 	}
 
-	SDL_SetWindowTitle(window, "SDL Grid");
+	Viewport view;
+	view.fit(grid_width, grid_height, window_width, window_height);
+
+	Simulation<AutomatonType, State> simulation(automaton,
+	                                            std::move(state_to_color),
+	                                            rate);
+	// The last target rate, for going back to it from running uncapped.
+	double capped_rate = rate > 0 ? rate : 10;
 
-	int   x;
-	int   y;
-	bool  is_closed = false;
-	State current;
+	auto   title_time       = std::chrono::steady_clock::now();
+	size_t title_generation = 0;
+	bool   is_closed        = false;
 	while (!is_closed) {
+		SDL_GetWindowSize(window, &window_width, &window_height);
+
 		SDL_Event event;
 		while (SDL_PollEvent(&event)) {
 			switch (event.type) {
 			case SDL_MOUSEBUTTONDOWN: {
-				x               = (event.motion.x / cell_size);
-				y               = (event.motion.y / cell_size);
-				current         = automaton(x, y);
-				automaton(x, y) = automaton.cycle_state(current);
+				if (event.button.button != SDL_BUTTON_LEFT) { break; }
+				const double x = std::floor(view.cell_x(event.button.x));
+				const double y = std::floor(view.cell_y(event.button.y));
+				if (x >= 0 && y >= 0 && x < grid_width && y < grid_height) {
+					simulation.toggle(static_cast<size_t>(x),
+					                  static_cast<size_t>(y));
+				}
+				break;
+			}
+			case SDL_MOUSEMOTION: {
+				// Drag with the right or middle button to pan.
+				const Uint32 panning = SDL_BUTTON_RMASK | SDL_BUTTON_MMASK;
+				if (event.motion.state & panning) {
+					view.left -= event.motion.xrel / view.zoom;
+					view.top -= event.motion.yrel / view.zoom;
+				}
+				break;
+			}
+			case SDL_MOUSEWHEEL: {
+				int x = 0;
+				int y = 0;
+				SDL_GetMouseState(&x, &y);
+				view.zoom_at(x, y, std::pow(1.25, event.wheel.y));
 				break;
 			}
-
 			case SDL_KEYDOWN: {
-				automaton.step();
+				const double pan = 0.1 * window_width / view.zoom;
+				switch (event.key.keysym.sym) {
+				case SDLK_SPACE: {
+					simulation.set_running(!simulation.running());
+					break;
+				}
+				case SDLK_n:
+				case SDLK_RETURN: {
+					simulation.step_once();
+					break;
+				}
+				case SDLK_EQUALS:
+				case SDLK_PLUS:
+				case SDLK_KP_PLUS: {
+					capped_rate = std::min(capped_rate * 2, 1e6);
+					simulation.set_rate(capped_rate);
+					break;
+				}
+				case SDLK_MINUS:
+				case SDLK_KP_MINUS: {
+					capped_rate = std::max(capped_rate / 2, 0.25);
+					simulation.set_rate(capped_rate);
+					break;
+				}
+				case SDLK_0: {
+					simulation.set_rate(0);
+					break;
+				}
+				case SDLK_HOME: {
+					view.fit(grid_width,
+					         grid_height,
+					         window_width,
+					         window_height);
+					break;
+				}
+				case SDLK_LEFT: {
+					view.left -= pan;
+					break;
+				}
+				case SDLK_RIGHT: {
+					view.left += pan;
+					break;
+				}
+				case SDLK_UP: {
+					view.top -= pan;
+					break;
+				}
+				case SDLK_DOWN: {
+					view.top += pan;
+					break;
+				}
+				case SDLK_q:
+				case SDLK_ESCAPE: {
+					is_closed = true;
+					break;
+				}
+				}
 				break;
 			}
 			case SDL_QUIT: {
@@ -84,7 +482,14 @@ int draw_grid(Automaton<State>&     automaton,
 			}
 		}
 
-		// Draw grid background.
+		// Stream the newest generation in, if there is one.
+		if (const auto* frame = simulation.frames().take()) {
+			SDL_UpdateTexture(texture,
+			                  nullptr,
+			                  frame->data(),
+			                  grid_width * sizeof(std::uint32_t));
+		}
+
 		SDL_SetRenderDrawColor(renderer,
 		                       BACKGROUND_COLOR.r,
 		                       BACKGROUND_COLOR.g,
@@ -92,45 +497,90 @@ int draw_grid(Automaton<State>&     automaton,
 		                       BACKGROUND_COLOR.a);
 		SDL_RenderClear(renderer);
 
-		// Draw grid lines.
-		SDL_SetRenderDrawColor(renderer,
-		                       LINE_COLOR.r,
-		                       LINE_COLOR.g,
-		                       LINE_COLOR.b,
-		                       LINE_COLOR.a);
+		// Only the cells in the window are copied, so that the texture
+		// coordinates stay small however far in it's zoomed.
+		const auto to_pixel = [](const double cell, const double origin,
+		                         const double zoom) {
+			return static_cast<int>(std::lround((cell - origin) * zoom));
+		};
+		const int x0 = std::clamp(
+		    static_cast<int>(std::floor(view.left)), 0, grid_width);
+		const int y0 = std::clamp(
+		    static_cast<int>(std::floor(view.top)), 0, grid_height);
+		const int x1 = std::clamp(
+		    static_cast<int>(std::ceil(view.cell_x(window_width))),
+		    0,
+		    grid_width);
+		const int y1 = std::clamp(
+		    static_cast<int>(std::ceil(view.cell_y(window_height))),
+		    0,
+		    grid_height);
+		if (x0 < x1 && y0 < y1) {
+			const SDL_Rect source = {x0, y0, x1 - x0, y1 - y0};
+			const int      left   = to_pixel(x0, view.left, view.zoom);
+			const int      top    = to_pixel(y0, view.top, view.zoom);
+			const SDL_Rect target = {
+			    left,
+			    top,
+			    to_pixel(x1, view.left, view.zoom) - left,
+			    to_pixel(y1, view.top, view.zoom) - top,
+			};
+			SDL_SetRenderDrawColor(renderer,
+			                       GRID_COLOR.r,
+			                       GRID_COLOR.g,
+			                       GRID_COLOR.b,
+			                       GRID_COLOR.a);
+			SDL_RenderFillRect(renderer, &target);
+			SDL_RenderCopy(renderer, texture, &source, &target);
 
-		for (int x = 0; x < 1 + grid_size * cell_size; x += cell_size) {
-			SDL_RenderDrawLine(renderer, x, 0, x, window_height);
-		}
-
-		for (int y = 0; y < 1 + grid_size * cell_size; y += cell_size) {
-			SDL_RenderDrawLine(renderer, 0, y, window_width, y);
-		}
-
-		// Draw cells.
-		for (int i = 0; i <= grid_size * cell_size; i += cell_size) {
-			for (int j = 0; j <= grid_size * cell_size; j += cell_size) {
-				int      x                 = i / cell_size;
-				int      y                 = j / cell_size;
-				SDL_Rect current_cell_rect = {
-				    .x = i + 1,
-				    .y = j + 1,
-				    .w = cell_size - 1,
-				    .h = cell_size - 1,
-				};
-				SDL_Color color = state_to_color(automaton(x, y));
+			// Draw grid lines.
+			if (view.zoom >= line_zoom) {
 				SDL_SetRenderDrawColor(renderer,
-				                       color.r,
-				                       color.g,
-				                       color.b,
-				                       color.a);
-				SDL_RenderFillRect(renderer, &current_cell_rect);
+				                       LINE_COLOR.r,
+				                       LINE_COLOR.g,
+				                       LINE_COLOR.b,
+				                       LINE_COLOR.a);
+				const int right  = target.x + target.w;
+				const int bottom = target.y + target.h;
+				for (int x = x0; x <= x1; ++x) {
+					const int pixel = to_pixel(x, view.left, view.zoom);
+					SDL_RenderDrawLine(renderer, pixel, top, pixel, bottom);
+				}
+				for (int y = y0; y <= y1; ++y) {
+					const int pixel = to_pixel(y, view.top, view.zoom);
+					SDL_RenderDrawLine(renderer, left, pixel, right, pixel);
+				}
 			}
 		}
 
 		SDL_RenderPresent(renderer);
+
+		// Generation and measured rate in the title, twice a second.
+		const auto now = std::chrono::steady_clock::now();
+		if (now - title_time >= std::chrono::milliseconds(500)) {
+			const size_t generation = simulation.generation();
+			const std::chrono::duration<double> elapsed = now - title_time;
+			const double target   = simulation.rate();
+			char         limit[32] = "uncapped";
+			if (!simulation.running()) {
+				std::snprintf(limit, sizeof(limit), "paused");
+			} else if (target > 0) {
+				std::snprintf(limit, sizeof(limit), "target %g/s", target);
+			}
+			char title[128];
+			std::snprintf(title,
+			              sizeof(title),
+			              "cellular++ - generation %zu, %.1f/s, %s",
+			              generation,
+			              (generation - title_generation) / elapsed.count(),
+			              limit);
+			SDL_SetWindowTitle(window, title);
+			title_time       = now;
+			title_generation = generation;
+		}
 	}
 
+	SDL_DestroyTexture(texture);
 	SDL_DestroyRenderer(renderer);
 	SDL_DestroyWindow(window);
 	SDL_Quit();
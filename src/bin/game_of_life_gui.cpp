@@ -5,6 +5,7 @@
 #include <SDL2/SDL.h>
 
 #include <iostream>
+#include <string>
 
 #include "draw_grid.hpp"
 #include "game_of_life.hpp"
@@ -26,6 +27,8 @@ int main(int argc, char** argv) {
 		std::string file_path = argv[1];
 		gol.set_grid_from_file(file_path);
 	}
+	// Generations per second, 0 runs it as fast as it goes.
+	const double rate = argc >= 3 ? std::stod(argv[2]) : 10;
 
-	return draw_grid(gol, ColorFunctor<State>(state_to_color));
+	return draw_grid(gol, ColorFunctor<State>(state_to_color), rate);
 }
@@ -6,7 +6,6 @@
 
 #include <string>
 
-#include "cellular_gui.hpp"
 #include "draw_grid.hpp"
 #include "wireworld.hpp"
 
@@ -49,6 +48,8 @@ int main(int argc, char** argv) {
 		std::string file_path = argv[1];
 		wireworld.set_grid_from_file(file_path);
 	}
+	// Generations per second, 0 runs it as fast as it goes.
+	const double rate = argc >= 3 ? std::stod(argv[2]) : 10;
 
-	return draw_grid(wireworld, ColorFunctor<State>(state_to_color));
+	return draw_grid(wireworld, ColorFunctor<State>(state_to_color), rate);
 }
@@ -0,0 +1,429 @@
+#include "caves.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cellular.hpp"
+#include "cellular_hash.hpp"
+#include "cellular_simd.hpp"
+#include "cellular_thread_pool.hpp"
+
+using namespace cellular;
+using namespace caves;
+
+namespace {
+constexpr auto wall_byte  = static_cast<std::uint8_t>(State::Wall);
+constexpr auto floor_byte = static_cast<std::uint8_t>(State::Floor);
+
+/// The 4-5 rule by the amount of floors around a cell rather than walls,
+/// since the cells past the edges of the grid are walls that aren't
+/// counted. A wall stays one with at most 4 floors around it, a floor
+/// becomes a wall with at most 3.
+State rule(const State current_cell, const unsigned int floors) {
+	const unsigned int most = current_cell == State::Wall ? 4 : 3;
+	return floors <= most ? State::Wall : State::Floor;
+}
+
+const CountRule& count_rule() {
+	static const CountRule ret = CountRule::from(State::Floor, 2, rule);
+	return ret;
+}
+
+void check_density(const double density) {
+	// Written to catch NaN too.
+	if (!(density >= 0 && density <= 1)) {
+		throw std::invalid_argument("the density has to be in [0, 1]");
+	}
+}
+
+/// The walls of a random fill, cell by cell in the order the grid is
+/// stored in. Two cells are drawn from each step of a splitmix64 stream,
+/// which is much cheaper than a `std::bernoulli_distribution` and the same
+/// on every platform.
+class Fill {
+public:
+	Fill(const double density, const std::uint64_t seed) :
+	    m_threshold(static_cast<std::uint64_t>(density * 4294967296.0)),
+	    m_state(cellular::detail::mix(seed)) {}
+
+	bool wall() {
+		if (m_left == 0) {
+			m_state += 0x9e3779b97f4a7c15;
+			m_bits = cellular::detail::mix(m_state);
+			m_left = 2;
+		}
+		const std::uint64_t draw = m_bits & 0xffffffff;
+		m_bits >>= 32;
+		--m_left;
+		return draw < m_threshold;
+	}
+
+private:
+	/// `density` in 32-bit fixed point, 2^32 for 1.
+	std::uint64_t m_threshold;
+	std::uint64_t m_state;
+	std::uint64_t m_bits = 0;
+	unsigned int  m_left = 0;
+};
+
+/// Cells of a `width` by `height` map with a line of walls around it:
+/// column x is line x + 1 of `height + 2` cells, and cell y of it is at
+/// y + 1.
+size_t padded_size(const size_t width, const size_t height) {
+	return (width + 2) * (height + 2);
+}
+
+std::vector<std::uint8_t> padded_cells(const Caves& caves) {
+	const size_t              stride = caves.height() + 2;
+	std::vector<std::uint8_t> ret(padded_size(caves.width(), caves.height()),
+	                              wall_byte);
+	for (size_t x = 0; x < caves.width(); ++x) {
+		for (size_t y = 0; y < caves.height(); ++y) {
+			ret[(x + 1) * stride + y + 1] =
+			    static_cast<std::uint8_t>(caves(x, y));
+		}
+	}
+	return ret;
+}
+
+using caves::detail::FloorRun;
+
+/// The first cell of `line` from `y` on that isn't in `skip`, or `last` if
+/// there's none before it. Looks at 8 cells at a time.
+size_t skip_cells(const std::uint8_t* line,
+                  size_t              y,
+                  const size_t        last,
+                  const std::uint8_t  skip) {
+	const std::uint64_t pattern = 0x0101010101010101 * skip;
+	for (; y + 8 <= last; y += 8) {
+		std::uint64_t word;
+		std::memcpy(&word, &line[y], 8);
+		word ^= pattern;
+		if (word != 0) {
+			if constexpr (std::endian::native == std::endian::little) {
+				return y + std::countr_zero(word) / 8;
+			} else {
+				return y + std::countl_zero(word) / 8;
+			}
+		}
+	}
+	while (y < last && line[y] == skip) { ++y; }
+	return y;
+}
+
+std::uint32_t find(std::vector<FloorRun>& runs, std::uint32_t run) {
+	while (runs[run].parent != run) {
+		// Halve the path on the way up.
+		runs[run].parent = runs[runs[run].parent].parent;
+		run              = runs[run].parent;
+	}
+	return run;
+}
+
+/// Label the floor regions of the padded `cells` with union-find over runs
+/// of floors down each column rather than cell by cell: a run joins the
+/// regions of the runs it touches in the column before it. Regions are
+/// numbered in the order their first cell is scanned in, and their sizes
+/// go in `sizes`. Returns the amount of regions.
+size_t label(const std::uint8_t*    cells,
+             const size_t           width,
+             const size_t           height,
+             std::vector<FloorRun>& runs,
+             std::vector<size_t>&   sizes) {
+	const size_t stride = height + 2;
+	runs.clear();
+	size_t previous = 0;
+	for (size_t x = 1; x <= width; ++x) {
+		const std::uint8_t* const line  = &cells[x * stride];
+		const size_t              first = runs.size();
+		size_t                    touch = previous;
+		size_t                    y     = 1;
+		for (;;) {
+			const size_t begin = skip_cells(line, y, height + 1, wall_byte);
+			if (begin > height) { break; }
+			// The wall below the column ends the last run.
+			y = skip_cells(line, begin, height + 1, floor_byte);
+			const auto run = static_cast<std::uint32_t>(runs.size());
+			runs.push_back({static_cast<std::uint32_t>(x),
+			                static_cast<std::uint32_t>(begin),
+			                static_cast<std::uint32_t>(y),
+			                run,
+			                0});
+			// Runs of the column before are in order, so the ones that end
+			// above this one don't touch the runs below it either.
+			while (touch < first && runs[touch].end <= begin) { ++touch; }
+			for (size_t other = touch; other < first && runs[other].begin < y;
+			     ++other) {
+				const std::uint32_t a = find(runs, run);
+				const std::uint32_t b = find(runs, other);
+				// The earlier run stays the root, so it's labeled first.
+				runs[std::max(a, b)].parent = std::min(a, b);
+			}
+		}
+		previous = first;
+	}
+
+	sizes.clear();
+	for (std::uint32_t run = 0; run < runs.size(); ++run) {
+		FloorRun& root = runs[find(runs, run)];
+		if (root.region == 0) {
+			sizes.push_back(0);
+			root.region = static_cast<std::uint32_t>(sizes.size());
+		}
+		runs[run].region = root.region;
+		sizes[root.region - 1] += runs[run].end - runs[run].begin;
+	}
+	return sizes.size();
+}
+
+/// Fill in the regions `label` found that `min_region` and `largest_only`
+/// drop, see `Caves::prune`. Their sizes become 0. Returns the amount of
+/// regions left.
+size_t prune_regions(std::uint8_t*                cells,
+                     const size_t                 height,
+                     const std::vector<FloorRun>& runs,
+                     std::vector<size_t>&         sizes,
+                     const size_t                 min_region,
+                     const bool                   largest_only) {
+	const size_t largest =
+	    std::max_element(sizes.begin(), sizes.end()) - sizes.begin();
+	size_t left = 0;
+	for (size_t region = 0; region < sizes.size(); ++region) {
+		if (sizes[region] < min_region
+		    || (largest_only && region != largest)) {
+			sizes[region] = 0;
+		} else {
+			++left;
+		}
+	}
+	if (left == sizes.size()) { return left; }
+	for (const FloorRun& run : runs) {
+		if (sizes[run.region - 1] == 0) {
+			std::fill(&cells[run.x * (height + 2) + run.begin],
+			          &cells[run.x * (height + 2) + run.end],
+			          wall_byte);
+		}
+	}
+	return left;
+}
+} // namespace
+
+Caves::Caves(const size_t width, const size_t height) :
+    StaticAutomaton(width, height) {
+	set_count_rule(count_rule());
+}
+
+Caves::Caves(const std::filesystem::path& filename) : Caves(1, 1) {
+	// `char_to_state` can't be called from the base constructor.
+	set_grid_from_file(filename);
+}
+
+void Caves::fill(const double density, const std::uint64_t seed) {
+	check_density(density);
+	Fill random(density, seed);
+	for (size_t x = 0; x < width(); ++x) {
+		for (size_t y = 0; y < height(); ++y) {
+			(*this)(x, y) = random.wall() ? State::Wall : State::Floor;
+		}
+	}
+}
+
+Regions Caves::regions() const {
+	const std::vector<std::uint8_t> cells = padded_cells(*this);
+	std::vector<FloorRun>           runs;
+	Regions                         ret;
+	label(cells.data(), width(), height(), runs, ret.sizes);
+	ret.labels.assign(width() * height(), 0);
+	for (const FloorRun& run : runs) {
+		const size_t column = (run.x - 1) * height() - 1;
+		std::fill(&ret.labels[column + run.begin],
+		          &ret.labels[column + run.end],
+		          run.region);
+	}
+	return ret;
+}
+
+size_t Caves::prune(const size_t min_region, const bool largest_only) {
+	const size_t              stride = height() + 2;
+	std::vector<std::uint8_t> cells  = padded_cells(*this);
+	std::vector<FloorRun>     runs;
+	std::vector<size_t>       sizes;
+	label(cells.data(), width(), height(), runs, sizes);
+	const size_t left = prune_regions(
+	    cells.data(), height(), runs, sizes, min_region, largest_only);
+	for (size_t x = 0; x < width(); ++x) {
+		for (size_t y = 0; y < height(); ++y) {
+			if (cells[(x + 1) * stride + y + 1] == wall_byte) {
+				(*this)(x, y) = State::Wall;
+			}
+		}
+	}
+	return left;
+}
+
+void Caves::generate(const CaveOptions& options, const std::uint64_t seed) {
+	fill(options.density, seed);
+	step(options.passes);
+	if (options.min_region > 0 || options.largest_only) {
+		prune(options.min_region, options.largest_only);
+	}
+}
+
+char Caves::state_to_char(State state) const {
+	return state == State::Floor ? '.' : '#';
+}
+
+State Caves::char_to_state(char c) const {
+	switch (c) {
+	case '#':
+		return State::Wall;
+	case '.':
+		return State::Floor;
+	default:
+		throw std::invalid_argument(std::string{"Invalid state value: "} + c);
+	}
+}
+
+State Caves::cycle_state(const State current_cell) const {
+	return current_cell == State::Wall ? State::Floor : State::Wall;
+}
+
+State Caves::next_cell(const State  current_cell,
+                       const size_t x,
+                       const size_t y) const {
+	return rule(current_cell, count_moore(x, y, State::Floor));
+}
+
+State CaveMap::operator()(const size_t x, const size_t y) const {
+	return cells[x * height + y];
+}
+
+CaveBatch::CaveBatch(const size_t       width,
+                     const size_t       height,
+                     const CaveOptions& options) :
+    m_width(width),
+    m_height(height),
+    m_options(options) {
+	if (width == 0 || height == 0) {
+		throw std::invalid_argument("cave maps can't be empty");
+	}
+	check_density(options.density);
+}
+
+void CaveBatch::generate(std::vector<CaveMap>& maps,
+                         const std::uint64_t   first_seed,
+                         const size_t          count) {
+	maps.resize(count);
+	for (size_t i = 0; i < count; ++i) { maps[i].seed = first_seed + i; }
+
+	// A task per thread rather than per map, so every thread keeps to its
+	// own workspace while the maps are still handed out one at a time.
+	const size_t threads = m_pool ? m_pool->size() : 1;
+	if (m_workspaces.size() < threads) { m_workspaces.resize(threads); }
+	std::atomic<size_t> next = 0;
+	auto                work = [&](const size_t thread) {
+		for (size_t i = next++; i < count; i = next++) {
+			make(m_workspaces[thread], maps[i]);
+		}
+	};
+	if (m_pool) {
+		m_pool->parallel_for(threads, work);
+	} else {
+		work(0);
+	}
+}
+
+std::vector<CaveMap> CaveBatch::generate(const std::uint64_t first_seed,
+                                         const size_t        count) {
+	std::vector<CaveMap> ret;
+	generate(ret, first_seed, count);
+	return ret;
+}
+
+size_t CaveBatch::width() const {
+	return m_width;
+}
+
+size_t CaveBatch::height() const {
+	return m_height;
+}
+
+const CaveOptions& CaveBatch::options() const {
+	return m_options;
+}
+
+void CaveBatch::set_threads(const size_t threads) {
+	set_thread_pool(threads > 1
+	                    ? std::make_shared<cellular::ThreadPool>(threads)
+	                    : nullptr);
+}
+
+void CaveBatch::set_thread_pool(std::shared_ptr<cellular::ThreadPool> pool) {
+	m_pool = std::move(pool);
+}
+
+void CaveBatch::make(Workspace& workspace, CaveMap& map) const {
+	const size_t stride = m_height + 2;
+	const size_t size   = padded_size(m_width, m_height);
+	auto&        cells  = workspace.cells;
+	auto&        next   = workspace.next;
+	// Only the lines inside the walls are written from here on, so the
+	// walls around them stay.
+	cells.assign(size, wall_byte);
+	next.assign(size, wall_byte);
+
+	Fill random(m_options.density, map.seed);
+	for (size_t x = 1; x <= m_width; ++x) {
+		std::uint8_t* const line = &cells[x * stride];
+		for (size_t y = 1; y <= m_height; ++y) {
+			line[y] = random.wall() ? wall_byte : floor_byte;
+		}
+	}
+
+	const CountRule& rule = count_rule();
+	for (size_t pass = 0; pass < m_options.passes; ++pass) {
+		for (size_t x = 1; x <= m_width; ++x) {
+			simd::step_span_unchecked(rule,
+			                          &cells[(x - 1) * stride],
+			                          &cells[x * stride],
+			                          &cells[(x + 1) * stride],
+			                          &next[x * stride],
+			                          1,
+			                          m_height + 1);
+		}
+		cells.swap(next);
+	}
+
+	map.regions =
+	    label(cells.data(), m_width, m_height, workspace.runs, workspace.sizes);
+	if (m_options.min_region > 0 || m_options.largest_only) {
+		map.regions = prune_regions(cells.data(),
+		                            m_height,
+		                            workspace.runs,
+		                            workspace.sizes,
+		                            m_options.min_region,
+		                            m_options.largest_only);
+	}
+	map.floors = 0;
+	for (const size_t cells_in_region : workspace.sizes) {
+		map.floors += cells_in_region;
+	}
+
+	map.width  = m_width;
+	map.height = m_height;
+	map.cells.resize(m_width * m_height);
+	for (size_t x = 0; x < m_width; ++x) {
+		std::memcpy(&map.cells[x * m_height],
+		            &cells[(x + 1) * stride + 1],
+		            m_height);
+	}
+}
@@ -1,4 +1,153 @@
 #ifndef CELLULAR_CAVES_HPP_
 #define CELLULAR_CAVES_HPP_
 
-#endif
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include "cellular.hpp"
+#include "cellular_static.hpp"
+#include "cellular_thread_pool.hpp"
+
+using namespace cellular;
+
+namespace caves {
+// First state is the default one, so the cells past the edges of the grid
+// are walls.
+enum class State : std::uint8_t { Wall, Floor };
+
+/// How a cave map is made: a random fill, smoothing passes of the 4-5 rule
+/// and pruning of the floor regions that came out of it.
+struct CaveOptions {
+	/// Chance of a cell being a wall in the random fill.
+	double density = 0.45;
+	/// Steps of the 4-5 rule.
+	size_t passes = 5;
+	/// Floor regions with fewer cells are filled in with walls.
+	size_t min_region = 0;
+	/// Fill in every floor region but the largest one, the first of them if
+	/// several are the largest.
+	bool largest_only = false;
+};
+
+/// The floor regions of a map, cells connected through their edges.
+struct Regions {
+	/// Region of cell (x, y) at `x * height + y`, numbered from 1 in the
+	/// order the grid is scanned in, 0 for walls.
+	std::vector<std::uint32_t> labels;
+	/// Cells in region r at `sizes[r - 1]`.
+	std::vector<size_t> sizes;
+};
+
+/// Cave generation: walls become floors and floors walls by the 4-5 rule,
+/// a cell is a wall in the next generation if it's a wall with at least 4
+/// of its 8 neighbors walls or a floor with at least 5. Cells past the edges
+/// count as walls, so caves close up at the edges of the grid.
+class Caves : public StaticAutomaton<Caves, State> {
+public:
+	Caves(const size_t width, const size_t height);
+	Caves(const std::filesystem::path& filename);
+	/// Make every cell a wall with a chance of `density`, drawn from `seed`.
+	/// Throws `std::invalid_argument` if `density` isn't in [0, 1].
+	void    fill(const double density, const std::uint64_t seed);
+	Regions regions() const;
+	/// Fill in the floor regions with fewer than `min_region` cells, and
+	/// all but the largest one if `largest_only`. Returns the amount of
+	/// regions left.
+	size_t prune(const size_t min_region, const bool largest_only = false);
+	/// `fill`, step `options.passes` times and `prune`, which makes the
+	/// same map `CaveBatch` makes from `seed`.
+	void  generate(const CaveOptions& options, const std::uint64_t seed);
+	char  state_to_char(State state) const override;
+	State char_to_state(char c) const override;
+	State cycle_state(const State current_cell) const override;
+
+protected:
+	friend StaticAutomaton;
+	State next_cell(const State  current_cell,
+	                const size_t x,
+	                const size_t y) const;
+};
+
+namespace detail {
+	/// A stretch of floors down column `x`, from `begin` up to `end`, and
+	/// what the labeling made of it.
+	struct FloorRun {
+		std::uint32_t x;
+		std::uint32_t begin;
+		std::uint32_t end;
+		/// Index of a run it's connected to, its own for the first run of a
+		/// region.
+		std::uint32_t parent;
+		/// Its region, numbered from 1.
+		std::uint32_t region;
+	};
+} // namespace detail
+
+/// A map made by `CaveBatch`.
+struct CaveMap {
+	size_t        width  = 0;
+	size_t        height = 0;
+	std::uint64_t seed   = 0;
+	/// Cell (x, y) at `x * height + y`.
+	std::vector<State> cells;
+	/// Floor regions and floor cells left after pruning.
+	size_t regions = 0;
+	size_t floors  = 0;
+
+	State operator()(const size_t x, const size_t y) const;
+};
+
+/// Makes many cave maps of the same size and options, one per seed, without
+/// the `Automaton` machinery: each thread works in its own buffers, which
+/// are kept from one call to the next, and maps passed back in are
+/// refilled in place. Maps come out the same as `Caves::generate` makes
+/// them from the same seed, whatever the amount of threads.
+class CaveBatch {
+public:
+	/// Throws `std::invalid_argument` for an empty map or a `density` that
+	/// isn't in [0, 1].
+	CaveBatch(const size_t       width,
+	          const size_t       height,
+	          const CaveOptions& options = {});
+	/// Make `count` maps into `maps`, map i from seed `first_seed + i`.
+	/// `maps` is resized to `count`, and the maps already in it keep their
+	/// storage.
+	void generate(std::vector<CaveMap>& maps,
+	              const std::uint64_t   first_seed,
+	              const size_t          count);
+	std::vector<CaveMap> generate(const std::uint64_t first_seed,
+	                              const size_t        count);
+	size_t             width() const;
+	size_t             height() const;
+	const CaveOptions& options() const;
+	/// Make maps on a pool of `threads` threads, or serially if `threads`
+	/// is 1.
+	void set_threads(const size_t threads);
+	/// Make maps on `pool`, which may be shared with other automata.
+	/// Passing `nullptr` makes it serial again.
+	void set_thread_pool(std::shared_ptr<cellular::ThreadPool> pool);
+
+private:
+	/// What a thread makes maps in, the cells with a line of walls around
+	/// them so neither the rule nor the labeling check for the edges.
+	struct Workspace {
+		std::vector<std::uint8_t>     cells;
+		std::vector<std::uint8_t>     next;
+		std::vector<detail::FloorRun> runs;
+		std::vector<size_t>           sizes;
+	};
+
+	void make(Workspace& workspace, CaveMap& map) const;
+
+	size_t                                m_width;
+	size_t                                m_height;
+	CaveOptions                           m_options;
+	std::vector<Workspace>                m_workspaces;
+	std::shared_ptr<cellular::ThreadPool> m_pool;
+};
+} // namespace caves
+
+#endif // CELLULAR_CAVES_HPP_
@@ -0,0 +1,195 @@
+#include "event_wireworld.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "cellular.hpp"
+#include "wireworld.hpp"
+
+using namespace wireworld;
+
+EventWireworld::EventWireworld(const Wireworld& dense) { assign(dense); }
+
+EventWireworld::EventWireworld(const std::filesystem::path& filename) :
+    EventWireworld(Wireworld(filename)) {}
+
+void EventWireworld::assign(const Wireworld& dense) {
+	m_width      = dense.width();
+	m_height     = dense.height();
+	m_generation = 0;
+	m_column_start.assign(1, 0);
+	m_rows.clear();
+	m_states.clear();
+	m_heads.clear();
+	m_tails.clear();
+
+	// Columns are contiguous in the dense grid, so it's read column by
+	// column.
+	for (size_t x = 0; x < m_width; ++x) {
+		for (size_t y = 0; y < m_height; ++y) {
+			const State state = dense(x, y);
+			if (state == State::Empty) { continue; }
+			// Every node has at most 8 edges, which have to fit as well.
+			if (m_states.size() >= std::numeric_limits<Node>::max() / 8) {
+				throw std::length_error("too many cells for EventWireworld");
+			}
+			const auto node = static_cast<Node>(m_states.size());
+			if (state == State::ElectronHead) { m_heads.push_back(node); }
+			if (state == State::ElectronTail) { m_tails.push_back(node); }
+			m_rows.push_back(static_cast<std::uint32_t>(y));
+			m_states.push_back(state);
+		}
+		m_column_start.push_back(static_cast<Node>(m_states.size()));
+	}
+
+	// The node in every row of the last few columns used, since those are
+	// all that a node's neighbors can be in. Only the least recently used
+	// one is replaced, so the three a node needs are kept together.
+	const Boundary    boundary = dense.boundary();
+	const auto        w        = static_cast<std::ptrdiff_t>(m_width);
+	const auto        h        = static_cast<std::ptrdiff_t>(m_height);
+	std::vector<Node> column_nodes[4];
+	std::ptrdiff_t    cached_column[4] = {-1, -1, -1, -1};
+	size_t            last_used[4]     = {};
+	size_t            uses             = 0;
+	auto              column = [&](const std::ptrdiff_t x) -> const Node* {
+		size_t slot = 0;
+		for (size_t i = 0; i < 4; ++i) {
+			if (cached_column[i] == x) {
+				slot = i;
+				break;
+			}
+			if (last_used[i] < last_used[slot]) { slot = i; }
+		}
+		if (cached_column[slot] != x) {
+			column_nodes[slot].assign(m_height, no_node);
+			for (Node node = m_column_start[x]; node < m_column_start[x + 1];
+			     ++node) {
+				column_nodes[slot][m_rows[node]] = node;
+			}
+			cached_column[slot] = x;
+		}
+		last_used[slot] = ++uses;
+		return column_nodes[slot].data();
+	};
+
+	// Calls `visit(neighbor, node)` for every node in the neighborhood of
+	// every node, with the same neighbor several times if the boundary
+	// mirrors it into the neighborhood more than once.
+	auto for_each_neighbor = [&](const auto& visit) {
+		Node node = 0;
+		for (std::ptrdiff_t x = 0; x < w; ++x) {
+			if (node == m_column_start[x + 1]) { continue; }
+			const Node* columns[3];
+			for (std::ptrdiff_t dx = -1; dx <= 1; ++dx) {
+				const std::ptrdiff_t sx =
+				    detail::halo_source(x + dx, w, boundary);
+				columns[dx + 1] = sx < 0 ? nullptr : column(sx);
+			}
+			for (; node < m_column_start[x + 1]; ++node) {
+				const auto y = static_cast<std::ptrdiff_t>(m_rows[node]);
+				for (std::ptrdiff_t dy = -1; dy <= 1; ++dy) {
+					const std::ptrdiff_t sy =
+					    detail::halo_source(y + dy, h, boundary);
+					if (sy < 0) { continue; }
+					for (const std::ptrdiff_t dx : {-1, 0, 1}) {
+						if ((dx == 0 && dy == 0) || !columns[dx + 1]) {
+							continue;
+						}
+						const Node neighbor = columns[dx + 1][sy];
+						if (neighbor != no_node) { visit(neighbor, node); }
+					}
+				}
+			}
+		}
+	};
+
+	// Count the edges out of every node, then place them.
+	m_first_edge.assign(m_states.size() + 1, 0);
+	for_each_neighbor(
+	    [this](const Node from, Node) { ++m_first_edge[from + 1]; });
+	for (size_t i = 1; i < m_first_edge.size(); ++i) {
+		m_first_edge[i] += m_first_edge[i - 1];
+	}
+	m_edges.resize(m_first_edge.back());
+	std::vector<std::uint32_t> filled(m_first_edge.begin(),
+	                                  m_first_edge.end() - 1);
+	for_each_neighbor([&](const Node from, const Node to) {
+		m_edges[filled[from]++] = to;
+	});
+
+	m_heads_around.assign(m_states.size(), 0);
+	m_touched.clear();
+}
+
+void EventWireworld::step() {
+	// Only conductors next to a head can change into anything but
+	// themselves, so they're the only ones counted.
+	for (const Node head : m_heads) {
+		for (auto edge = m_first_edge[head]; edge < m_first_edge[head + 1];
+		     ++edge) {
+			const Node node = m_edges[edge];
+			if (m_states[node] != State::Conductor) { continue; }
+			if (m_heads_around[node]++ == 0) { m_touched.push_back(node); }
+		}
+	}
+
+	for (const Node tail : m_tails) { m_states[tail] = State::Conductor; }
+	for (const Node head : m_heads) { m_states[head] = State::ElectronTail; }
+	std::swap(m_tails, m_heads);
+	m_heads.clear();
+	for (const Node node : m_touched) {
+		if (m_heads_around[node] <= 2) {
+			m_states[node] = State::ElectronHead;
+			m_heads.push_back(node);
+		}
+		m_heads_around[node] = 0;
+	}
+	m_touched.clear();
+	++m_generation;
+}
+
+void EventWireworld::step(const size_t generations) {
+	for (size_t i = 0; i < generations; ++i) { step(); }
+}
+
+EventWireworld::Node EventWireworld::find(const size_t x,
+                                          const size_t y) const {
+	const auto begin = m_rows.begin() + m_column_start[x];
+	const auto end   = m_rows.begin() + m_column_start[x + 1];
+	const auto it    = std::lower_bound(begin, end, y);
+	if (it == end || *it != y) { return no_node; }
+	return static_cast<Node>(it - m_rows.begin());
+}
+
+State EventWireworld::operator()(const size_t x, const size_t y) const {
+	const Node node = find(x, y);
+	return node == no_node ? State::Empty : m_states[node];
+}
+
+size_t EventWireworld::width() const { return m_width; }
+
+size_t EventWireworld::height() const { return m_height; }
+
+size_t EventWireworld::generation() const { return m_generation; }
+
+size_t EventWireworld::cell_count() const { return m_states.size(); }
+
+size_t EventWireworld::head_count() const { return m_heads.size(); }
+
+void EventWireworld::copy_to(Wireworld& dense) const {
+	if (dense.width() != m_width || dense.height() != m_height) {
+		throw std::invalid_argument("Grid dimensions don't match");
+	}
+	Node node = 0;
+	for (size_t x = 0; x < m_width; ++x) {
+		for (size_t y = 0; y < m_height; ++y) {
+			const bool here = node < m_column_start[x + 1] && m_rows[node] == y;
+			dense(x, y)     = here ? m_states[node++] : State::Empty;
+		}
+	}
+}
@@ -0,0 +1,70 @@
+#ifndef CELLULAR_EVENT_WIREWORLD_HPP_
+#define CELLULAR_EVENT_WIREWORLD_HPP_
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include "wireworld.hpp"
+
+namespace wireworld {
+
+/// Wireworld engine that only visits the cells an electron can reach.
+/// Every non-empty cell of the grid becomes a node of a graph, linked to the
+/// nodes in its Moore neighborhood, and a generation walks the edges out of
+/// the current electron heads. Stepping costs time proportional to the
+/// amount of electrons, no matter how large the circuit is.
+///
+/// Cells can't be added or removed once the graph is built, so editing goes
+/// through a `Wireworld` and `assign`.
+class EventWireworld {
+public:
+	explicit EventWireworld(const Wireworld& dense);
+	EventWireworld(const std::filesystem::path& filename);
+	EventWireworld() = delete;
+	/// Build the graph from `dense`, taking its cells and boundary.
+	void   assign(const Wireworld& dense);
+	void   step();
+	void   step(const size_t generations);
+	State  operator()(const size_t x, const size_t y) const;
+	size_t width() const;
+	size_t height() const;
+	size_t generation() const;
+	/// Amount of non-empty cells, which is the amount of nodes.
+	size_t cell_count() const;
+	size_t head_count() const;
+	/// Copy every cell into `dense`, which must have the same dimensions.
+	void copy_to(Wireworld& dense) const;
+
+private:
+	using Node = std::uint32_t;
+
+	/// The node at (`x`, `y`), or `no_node` for an empty cell.
+	Node find(const size_t x, const size_t y) const;
+
+	static constexpr Node no_node = ~Node{0};
+
+	size_t m_width      = 0;
+	size_t m_height     = 0;
+	size_t m_generation = 0;
+	/// Nodes are numbered column by column, the nodes of column x are
+	/// `m_column_start[x]` up to `m_column_start[x + 1]`, sorted by y.
+	std::vector<Node>          m_column_start;
+	std::vector<std::uint32_t> m_rows;
+	std::vector<State>         m_states;
+	/// The nodes that have node n in their neighborhood are `m_edges` from
+	/// `m_first_edge[n]` up to `m_first_edge[n + 1]`, once for every time
+	/// they see it.
+	std::vector<std::uint32_t> m_first_edge;
+	std::vector<Node>          m_edges;
+	std::vector<Node>          m_heads;
+	std::vector<Node>          m_tails;
+	/// Heads around every conductor, only nonzero while stepping.
+	std::vector<std::uint8_t>  m_heads_around;
+	/// Conductors with a head around them, scratch space for `step`.
+	std::vector<Node>          m_touched;
+};
+
+} // namespace wireworld
+
+#endif // CELLULAR_EVENT_WIREWORLD_HPP_
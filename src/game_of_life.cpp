@@ -1,22 +1,24 @@
 #include "game_of_life.hpp"
 
-#include <SDL2/SDL.h>
-
 #include <filesystem>
 #include <stdexcept>
 
 #include "cellular.hpp"
-#include "cellular_gui.hpp"
 
 using namespace cellular;
 using namespace gol;
 
 // First state is the default one
 GameOfLife::GameOfLife(const size_t width, const size_t height) :
-    Automaton<State>(width, height) {}
+    StaticAutomaton(width, height) {
+	set_count_rule(CountRule::from(State::Alive, 2, rule));
+}
 
 GameOfLife::GameOfLife(const std::filesystem::path& filename) :
-    Automaton<State>(filename){};
+    GameOfLife(1, 1) {
+	// `char_to_state` can't be called from the base constructor.
+	set_grid_from_file(filename);
+}
 
 char GameOfLife::state_to_char(State state) const {
 	return state == State::Alive ? '#' : '*';
@@ -38,16 +40,14 @@ State GameOfLife::char_to_state(char c) const {
 	}
 }
 
-State GameOfLife::next_state(const State  current_cell,
-                             const size_t x,
-                             const size_t y) {
-	const auto&  neighborhood = moore_neighborhood_at(x, y);
-	unsigned int live_neighbors =
-	    std::count_if(std::begin(neighborhood),
-	                  std::end(neighborhood),
-	                  [](std::pair<const char*, State> const& p) {
-		                  return p.second == State::Alive;
-	                  });
+State GameOfLife::next_cell(const State  current_cell,
+                            const size_t x,
+                            const size_t y) const {
+	return rule(current_cell, count_moore(x, y, State::Alive));
+}
+
+State GameOfLife::rule(const State        current_cell,
+                       const unsigned int live_neighbors) {
 	State next_generation = current_cell;
 	switch (current_cell) {
 	case State::Alive:
@@ -1,20 +1,19 @@
 #ifndef CELLULAR_GAME_OF_LIFE_HPP_
 #define CELLULAR_GAME_OF_LIFE_HPP_
 
-#include <SDL2/SDL.h>
-
+#include <cstdint>
 #include <filesystem>
 
 #include "cellular.hpp"
-#include "cellular_gui.hpp"
+#include "cellular_static.hpp"
 
 using namespace cellular;
 
 namespace gol {
 // First state is the default one
-enum class State { Dead, Alive };
+enum class State : std::uint8_t { Dead, Alive };
 
-class GameOfLife : public Automaton<State> {
+class GameOfLife : public StaticAutomaton<GameOfLife, State> {
 public:
 	GameOfLife(const size_t width, const size_t height);
 	GameOfLife(const std::filesystem::path& filename);
@@ -23,9 +22,15 @@ public:
 	State cycle_state(const State current_cell) const override;
 
 protected:
-	State next_state(const State  current_cell,
-	                 const size_t x,
-	                 const size_t y) override;
+	friend StaticAutomaton;
+	State next_cell(const State  current_cell,
+	                const size_t x,
+	                const size_t y) const;
+
+private:
+	/// The rule itself, shared by `next_cell` and the vectorized step.
+	static State rule(const State        current_cell,
+	                  const unsigned int live_neighbors);
 };
 } // namespace gol
 
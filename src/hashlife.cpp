@@ -0,0 +1,388 @@
+#include "hashlife.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+#include "game_of_life.hpp"
+
+using namespace gol;
+
+namespace {
+std::uint64_t result_key(const std::uint32_t id, const unsigned int step_log2) {
+	return (std::uint64_t{id} << 6) | step_log2;
+}
+} // namespace
+
+size_t HashLife::ChildrenHash::operator()(const Children& c) const {
+	std::uint64_t h = c.nw;
+	h               = h * 0x9E3779B97F4A7C15ULL + c.ne;
+	h               = h * 0x9E3779B97F4A7C15ULL + c.sw;
+	h               = h * 0x9E3779B97F4A7C15ULL + c.se;
+	return h ^ (h >> 29);
+}
+
+HashLife::HashLife(const size_t max_nodes) : m_max_nodes(max_nodes) {
+	m_nodes.push_back({0, 0, 0, 0, 0, 0});
+	m_nodes.push_back({0, 0, 0, 0, 0, 1});
+	m_empty.push_back(dead_leaf);
+	m_root = empty(3);
+}
+
+HashLife::HashLife(const GameOfLife& dense, const size_t max_nodes) :
+    HashLife(max_nodes) {
+	assign(dense);
+}
+
+void HashLife::assign(const GameOfLife& dense) {
+	const auto   side  = std::max(dense.width(), dense.height());
+	unsigned int level = 3;
+	while ((size_t{1} << (level - 1)) < side) { ++level; }
+	const std::int64_t half = std::int64_t{1} << (level - 1);
+	m_root                  = build(dense, level, -half, -half);
+	m_generation            = 0;
+}
+
+State HashLife::get(const std::int64_t x, const std::int64_t y) const {
+	const std::int64_t r = radius();
+	if (x < -r || x >= r || y < -r || y >= r) { return State::Dead; }
+	return get(m_root, x + r, y + r);
+}
+
+void HashLife::set(const std::int64_t x,
+                   const std::int64_t y,
+                   const State        state) {
+	while (x < -radius() || x >= radius() || y < -radius() || y >= radius()) {
+		expand();
+	}
+	m_root = set(m_root, x + radius(), y + radius(), state);
+}
+
+void HashLife::advance(std::uint64_t generations) {
+	for (unsigned int step_log2 = 0; generations != 0; ++step_log2) {
+		if ((generations & 1) == 0) {
+			generations >>= 1;
+			continue;
+		}
+
+		// The pattern has to sit in the central quarter of the root, so that
+		// it can't reach past the center half (the successor) while moving at
+		// most one cell per generation.
+		while (m_nodes[m_root].level < step_log2 + 3
+		       || m_nodes[centered(centered(m_root))].population
+		              != m_nodes[m_root].population) {
+			expand();
+		}
+		m_root = successor(m_root, step_log2);
+		m_generation += std::uint64_t{1} << step_log2;
+		generations >>= 1;
+
+		if (m_nodes.size() > m_max_nodes) { collect_garbage(); }
+	}
+}
+
+std::uint64_t HashLife::generation() const {
+	return m_generation;
+}
+
+std::uint64_t HashLife::population() const {
+	return m_nodes[m_root].population;
+}
+
+void HashLife::copy_to(GameOfLife&        dense,
+                       const std::int64_t left,
+                       const std::int64_t top) const {
+	for (size_t x = 0; x < dense.width(); ++x) {
+		for (size_t y = 0; y < dense.height(); ++y) {
+			dense(x, y) = State::Dead;
+		}
+	}
+	fill(dense, m_root, -radius(), -radius(), left, top);
+}
+
+size_t HashLife::node_count() const {
+	return m_nodes.size();
+}
+
+void HashLife::collect_garbage() {
+	// Mark every node reachable from the root and the empty nodes.
+	// The leaves keep their ids.
+	std::vector<bool>   marked(m_nodes.size(), false);
+	std::vector<NodeId> stack(m_empty.begin(), m_empty.end());
+	stack.push_back(m_root);
+	stack.push_back(alive_leaf);
+	while (!stack.empty()) {
+		const NodeId id = stack.back();
+		stack.pop_back();
+		if (marked[id]) { continue; }
+		marked[id]    = true;
+		const Node& n = m_nodes[id];
+		if (n.level == 0) { continue; }
+		for (const NodeId child : {n.nw, n.ne, n.sw, n.se}) {
+			stack.push_back(child);
+		}
+	}
+
+	// Compact the surviving nodes. Children always have lower ids than their
+	// parents, so remapping in order sees every child before its parent.
+	std::vector<NodeId> remap(m_nodes.size(), 0);
+	std::vector<Node>   nodes;
+	nodes.reserve(std::count(marked.begin(), marked.end(), true));
+	m_index.clear();
+	for (NodeId id = 0; id < m_nodes.size(); ++id) {
+		if (!marked[id]) { continue; }
+		Node n = m_nodes[id];
+		if (n.level > 0) {
+			n.nw = remap[n.nw];
+			n.ne = remap[n.ne];
+			n.sw = remap[n.sw];
+			n.se = remap[n.se];
+			m_index.emplace(Children{n.nw, n.ne, n.sw, n.se},
+			                static_cast<NodeId>(nodes.size()));
+		}
+		remap[id] = static_cast<NodeId>(nodes.size());
+		nodes.push_back(n);
+	}
+
+	std::unordered_map<std::uint64_t, NodeId> results;
+	for (const auto& [key, result] : m_results) {
+		const NodeId id = static_cast<NodeId>(key >> 6);
+		if (marked[id] && marked[result]) {
+			results.emplace(result_key(remap[id], key & 63), remap[result]);
+		}
+	}
+
+	for (NodeId& id : m_empty) { id = remap[id]; }
+	m_root    = remap[m_root];
+	m_nodes   = std::move(nodes);
+	m_results = std::move(results);
+}
+
+HashLife::NodeId HashLife::node(const NodeId nw,
+                                const NodeId ne,
+                                const NodeId sw,
+                                const NodeId se) {
+	const Children children{nw, ne, sw, se};
+	if (auto it = m_index.find(children); it != m_index.end()) {
+		return it->second;
+	}
+
+	if (m_nodes.size() > UINT32_MAX) {
+		throw std::length_error("HashLife node cache exhausted");
+	}
+	const NodeId id = static_cast<NodeId>(m_nodes.size());
+	m_nodes.push_back({nw,
+	                   ne,
+	                   sw,
+	                   se,
+	                   static_cast<std::uint8_t>(m_nodes[nw].level + 1),
+	                   m_nodes[nw].population + m_nodes[ne].population
+	                       + m_nodes[sw].population + m_nodes[se].population});
+	m_index.emplace(children, id);
+	return id;
+}
+
+HashLife::NodeId HashLife::empty(const unsigned int level) {
+	while (m_empty.size() <= level) {
+		const NodeId e = m_empty.back();
+		m_empty.push_back(node(e, e, e, e));
+	}
+	return m_empty[level];
+}
+
+HashLife::NodeId HashLife::centered(const NodeId id) {
+	const Node n = m_nodes[id];
+	return node(m_nodes[n.nw].se,
+	            m_nodes[n.ne].sw,
+	            m_nodes[n.sw].ne,
+	            m_nodes[n.se].nw);
+}
+
+void HashLife::expand() {
+	const Node   n = m_nodes[m_root];
+	const NodeId e = empty(n.level - 1);
+	m_root         = node(node(e, e, e, n.nw),
+                  node(e, e, n.ne, e),
+                  node(e, n.sw, e, e),
+                  node(n.se, e, e, e));
+}
+
+HashLife::NodeId HashLife::successor(const NodeId       id,
+                                     const unsigned int step_log2) {
+	const Node n = m_nodes[id];
+	if (n.population == 0) { return empty(n.level - 1); }
+	if (n.level == 2) { return successor_base(id); }
+
+	const std::uint64_t key = result_key(id, step_log2);
+	if (auto it = m_results.find(key); it != m_results.end()) {
+		return it->second;
+	}
+
+	const Node nw = m_nodes[n.nw];
+	const Node ne = m_nodes[n.ne];
+	const Node sw = m_nodes[n.sw];
+	const Node se = m_nodes[n.se];
+
+	// The nine overlapping level - 1 nodes around the center.
+	const NodeId n00 = n.nw;
+	const NodeId n01 = node(nw.ne, ne.nw, nw.se, ne.sw);
+	const NodeId n02 = n.ne;
+	const NodeId n10 = node(nw.sw, nw.se, sw.nw, sw.ne);
+	const NodeId n11 = node(nw.se, ne.sw, sw.ne, se.nw);
+	const NodeId n12 = node(ne.sw, ne.se, se.nw, se.ne);
+	const NodeId n20 = n.sw;
+	const NodeId n21 = node(sw.ne, se.nw, sw.se, se.sw);
+	const NodeId n22 = n.se;
+
+	NodeId result;
+	if (step_log2 + 2 == n.level) {
+		// Full speed, advance twice by half the step.
+		const unsigned int half = step_log2 - 1;
+		const NodeId       r00  = successor(n00, half);
+		const NodeId       r01  = successor(n01, half);
+		const NodeId       r02  = successor(n02, half);
+		const NodeId       r10  = successor(n10, half);
+		const NodeId       r11  = successor(n11, half);
+		const NodeId       r12  = successor(n12, half);
+		const NodeId       r20  = successor(n20, half);
+		const NodeId       r21  = successor(n21, half);
+		const NodeId       r22  = successor(n22, half);
+		result = node(successor(node(r00, r01, r10, r11), half),
+		              successor(node(r01, r02, r11, r12), half),
+		              successor(node(r10, r11, r20, r21), half),
+		              successor(node(r11, r12, r21, r22), half));
+	} else {
+		// Slower than the node's natural step, take the centers without
+		// advancing and advance the recombined quarters once.
+		const NodeId c00 = centered(n00);
+		const NodeId c01 = centered(n01);
+		const NodeId c02 = centered(n02);
+		const NodeId c10 = centered(n10);
+		const NodeId c11 = centered(n11);
+		const NodeId c12 = centered(n12);
+		const NodeId c20 = centered(n20);
+		const NodeId c21 = centered(n21);
+		const NodeId c22 = centered(n22);
+		result = node(successor(node(c00, c01, c10, c11), step_log2),
+		              successor(node(c01, c02, c11, c12), step_log2),
+		              successor(node(c10, c11, c20, c21), step_log2),
+		              successor(node(c11, c12, c21, c22), step_log2));
+	}
+
+	m_results.emplace(key, result);
+	return result;
+}
+
+HashLife::NodeId HashLife::successor_base(const NodeId id) {
+	// Gather the 4x4 cells as a bitmask, bit 4 * y + x.
+	unsigned int cells = 0;
+	for (std::int64_t y = 0; y < 4; ++y) {
+		for (std::int64_t x = 0; x < 4; ++x) {
+			if (get(id, x, y) == State::Alive) { cells |= 1U << (4 * y + x); }
+		}
+	}
+
+	NodeId next[2][2];
+	for (int y = 1; y <= 2; ++y) {
+		for (int x = 1; x <= 2; ++x) {
+			unsigned int live_neighbors = 0;
+			for (int dy = -1; dy <= 1; ++dy) {
+				for (int dx = -1; dx <= 1; ++dx) {
+					if (dx == 0 && dy == 0) { continue; }
+					live_neighbors += (cells >> (4 * (y + dy) + x + dx)) & 1U;
+				}
+			}
+			const bool alive = (cells >> (4 * y + x)) & 1U;
+			next[y - 1][x - 1] =
+			    live_neighbors == 3 || (alive && live_neighbors == 2)
+			        ? alive_leaf
+			        : dead_leaf;
+		}
+	}
+	return node(next[0][0], next[0][1], next[1][0], next[1][1]);
+}
+
+HashLife::NodeId HashLife::set(const NodeId       id,
+                               const std::int64_t x,
+                               const std::int64_t y,
+                               const State        state) {
+	const Node n = m_nodes[id];
+	if (n.level == 0) { return state == State::Alive ? alive_leaf : dead_leaf; }
+
+	const std::int64_t half = std::int64_t{1} << (n.level - 1);
+	if (y < half) {
+		if (x < half) { return node(set(n.nw, x, y, state), n.ne, n.sw, n.se); }
+		return node(n.nw, set(n.ne, x - half, y, state), n.sw, n.se);
+	}
+	if (x < half) {
+		return node(n.nw, n.ne, set(n.sw, x, y - half, state), n.se);
+	}
+	return node(n.nw, n.ne, n.sw, set(n.se, x - half, y - half, state));
+}
+
+State HashLife::get(NodeId id, std::int64_t x, std::int64_t y) const {
+	while (m_nodes[id].level > 0) {
+		const Node&        n    = m_nodes[id];
+		const std::int64_t half = std::int64_t{1} << (n.level - 1);
+		if (y < half) {
+			id = x < half ? n.nw : n.ne;
+		} else {
+			id = x < half ? n.sw : n.se;
+			y -= half;
+		}
+		if (x >= half) { x -= half; }
+	}
+	return id == alive_leaf ? State::Alive : State::Dead;
+}
+
+HashLife::NodeId HashLife::build(const GameOfLife&  dense,
+                                 const unsigned int level,
+                                 const std::int64_t left,
+                                 const std::int64_t top) {
+	const std::int64_t side = std::int64_t{1} << level;
+	if (left + side <= 0 || top + side <= 0
+	    || left >= static_cast<std::int64_t>(dense.width())
+	    || top >= static_cast<std::int64_t>(dense.height())) {
+		return empty(level);
+	}
+	if (level == 0) {
+		return dense(left, top) == State::Alive ? alive_leaf : dead_leaf;
+	}
+
+	const std::int64_t half = side / 2;
+	return node(build(dense, level - 1, left, top),
+	            build(dense, level - 1, left + half, top),
+	            build(dense, level - 1, left, top + half),
+	            build(dense, level - 1, left + half, top + half));
+}
+
+void HashLife::fill(GameOfLife&        dense,
+                    const NodeId       id,
+                    const std::int64_t left,
+                    const std::int64_t top,
+                    const std::int64_t window_left,
+                    const std::int64_t window_top) const {
+	const Node&        n    = m_nodes[id];
+	const std::int64_t side = std::int64_t{1} << n.level;
+	if (n.population == 0 || left + side <= window_left
+	    || top + side <= window_top
+	    || left >= window_left + static_cast<std::int64_t>(dense.width())
+	    || top >= window_top + static_cast<std::int64_t>(dense.height())) {
+		return;
+	}
+	if (n.level == 0) {
+		dense(left - window_left, top - window_top) = State::Alive;
+		return;
+	}
+
+	const std::int64_t half = side / 2;
+	fill(dense, n.nw, left, top, window_left, window_top);
+	fill(dense, n.ne, left + half, top, window_left, window_top);
+	fill(dense, n.sw, left, top + half, window_left, window_top);
+	fill(dense, n.se, left + half, top + half, window_left, window_top);
+}
+
+std::int64_t HashLife::radius() const {
+	return std::int64_t{1} << (m_nodes[m_root].level - 1);
+}
@@ -0,0 +1,115 @@
+#ifndef CELLULAR_HASHLIFE_HPP_
+#define CELLULAR_HASHLIFE_HPP_
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "game_of_life.hpp"
+
+namespace gol {
+
+/// Game of Life on an unbounded plane using Gosper's HashLife algorithm.
+/// The universe is a canonicalized quadtree whose nodes are shared through a
+/// hash table, and the result of advancing each node is memoized, so
+/// repetitive patterns can be advanced by billions of generations.
+///
+/// Unlike `GameOfLife`, cells beyond the window copied in with `assign` are
+/// not treated as permanently dead, so patterns keep evolving past them.
+class HashLife {
+public:
+	/// `max_nodes` bounds the node cache, once it's exceeded unreachable nodes
+	/// and memoized results are collected between jumps.
+	explicit HashLife(const size_t max_nodes = default_max_nodes);
+	/// Copy every cell (x, y) of `dense` to (x, y) on the plane.
+	explicit HashLife(const GameOfLife& dense,
+	                  const size_t      max_nodes = default_max_nodes);
+	void  assign(const GameOfLife& dense);
+	State get(const std::int64_t x, const std::int64_t y) const;
+	void  set(const std::int64_t x, const std::int64_t y, const State state);
+	/// Advance by `generations`, jumping by the powers of two it consists of.
+	void          advance(const std::uint64_t generations);
+	std::uint64_t generation() const;
+	std::uint64_t population() const;
+	/// Copy the window of the plane starting at (`left`, `top`) with the
+	/// dimensions of `dense` into it.
+	void   copy_to(GameOfLife&        dense,
+	               const std::int64_t left = 0,
+	               const std::int64_t top  = 0) const;
+	size_t node_count() const;
+	/// Drop every node and memoized result that isn't reachable from the
+	/// current universe.
+	void collect_garbage();
+
+	static constexpr size_t default_max_nodes = size_t{1} << 22;
+
+private:
+	using NodeId = std::uint32_t;
+
+	struct Node {
+		NodeId        nw, ne, sw, se;
+		std::uint8_t  level;
+		std::uint64_t population;
+	};
+
+	struct Children {
+		NodeId nw, ne, sw, se;
+		bool   operator==(const Children& other) const = default;
+	};
+
+	struct ChildrenHash {
+		size_t operator()(const Children& c) const;
+	};
+
+	/// The leaves, level 0 nodes that are a single cell.
+	static constexpr NodeId dead_leaf  = 0;
+	static constexpr NodeId alive_leaf = 1;
+
+	NodeId node(const NodeId nw,
+	            const NodeId ne,
+	            const NodeId sw,
+	            const NodeId se);
+	NodeId empty(const unsigned int level);
+	/// Level `level - 1` node made of the central quarters of a level `level`
+	/// node.
+	NodeId centered(const NodeId id);
+	/// Wrap the universe in an empty border, doubling its side.
+	void   expand();
+	/// Center of `id` advanced by 2^`step_log2` generations.
+	NodeId successor(const NodeId id, const unsigned int step_log2);
+	/// Center of a 4x4 node advanced by one generation, computed directly.
+	NodeId successor_base(const NodeId id);
+	NodeId set(const NodeId       id,
+	           const std::int64_t x,
+	           const std::int64_t y,
+	           const State        state);
+	State  get(NodeId id, std::int64_t x, std::int64_t y) const;
+	NodeId build(const GameOfLife&  dense,
+	             const unsigned int level,
+	             const std::int64_t left,
+	             const std::int64_t top);
+	void   fill(GameOfLife&        dense,
+	            const NodeId       id,
+	            const std::int64_t left,
+	            const std::int64_t top,
+	            const std::int64_t window_left,
+	            const std::int64_t window_top) const;
+	/// Half of the root's side, the root covers [-radius, radius) on both
+	/// axes.
+	std::int64_t radius() const;
+
+	size_t            m_max_nodes;
+	std::vector<Node> m_nodes;
+	/// Canonical node of every set of children.
+	std::unordered_map<Children, NodeId, ChildrenHash> m_index;
+	/// Memoized successors, keyed by node id and step.
+	std::unordered_map<std::uint64_t, NodeId> m_results;
+	/// The empty node of every level that was needed so far.
+	std::vector<NodeId> m_empty;
+	NodeId              m_root;
+	std::uint64_t       m_generation = 0;
+};
+
+} // namespace gol
+
+#endif // CELLULAR_HASHLIFE_HPP_
@@ -0,0 +1,239 @@
+#ifndef CELLULAR_LIFE_BITS_HPP_
+#define CELLULAR_LIFE_BITS_HPP_
+
+#include <cstdint>
+#include <utility>
+
+#include "cellular_rule.hpp"
+
+// Bit-parallel Game of Life and Life-like rule arithmetic. Every bit of a
+// word is an independent cell, and the eight neighbor words hold the
+// matching neighbor of each cell.
+namespace gol::bits {
+
+inline void half_add(const std::uint64_t a,
+                     const std::uint64_t b,
+                     std::uint64_t&      sum,
+                     std::uint64_t&      carry) {
+	sum   = a ^ b;
+	carry = a & b;
+}
+
+inline void full_add(const std::uint64_t a,
+                     const std::uint64_t b,
+                     const std::uint64_t c,
+                     std::uint64_t&      sum,
+                     std::uint64_t&      carry) {
+	const std::uint64_t t = a ^ b;
+	sum                   = t ^ c;
+	carry                 = (a & b) | (t & c);
+}
+
+/// Next state of every cell in `center`, given its eight neighbor words.
+/// The neighbor count is summed with a tree of full adders, so all 64 cells
+/// are evaluated at once.
+inline std::uint64_t next_word(const std::uint64_t center,
+                               const std::uint64_t nw,
+                               const std::uint64_t n,
+                               const std::uint64_t ne,
+                               const std::uint64_t w,
+                               const std::uint64_t e,
+                               const std::uint64_t sw,
+                               const std::uint64_t s,
+                               const std::uint64_t se) {
+	std::uint64_t top_ones, top_twos;
+	std::uint64_t mid_ones, mid_twos;
+	std::uint64_t bottom_ones, bottom_twos;
+	full_add(nw, n, ne, top_ones, top_twos);
+	half_add(w, e, mid_ones, mid_twos);
+	full_add(sw, s, se, bottom_ones, bottom_twos);
+
+	// Weight 1 and the carry into weight 2.
+	std::uint64_t ones, ones_carry;
+	full_add(top_ones, mid_ones, bottom_ones, ones, ones_carry);
+
+	// Weight 2 and the carries into weight 4.
+	std::uint64_t twos_partial, fours_a, twos, fours_b;
+	full_add(top_twos, mid_twos, bottom_twos, twos_partial, fours_a);
+	half_add(twos_partial, ones_carry, twos, fours_b);
+
+	// Alive next generation iff the count is 3, or 2 and currently alive.
+	return twos & ~(fours_a | fours_b) & (ones | center);
+}
+
+/// The neighbor count of every cell of a word, bit-sliced: the count of
+/// cell x is bit x of `ones`, plus twice bit x of `twos` and so on.
+struct Counts {
+	std::uint64_t ones, twos, fours, eights;
+
+	/// The cells whose count is `count`. Counts other than 0 and 8 can't
+	/// have the eights bit set along with a lower one, so they skip it.
+	std::uint64_t equal(const unsigned int count) const {
+		if (count == 8) { return eights; }
+		const std::uint64_t low = (count & 1 ? ones : ~ones)
+		                          & (count & 2 ? twos : ~twos)
+		                          & (count & 4 ? fours : ~fours);
+		return count == 0 ? low & ~eights : low;
+	}
+};
+
+inline Counts count(const std::uint64_t nw,
+                    const std::uint64_t n,
+                    const std::uint64_t ne,
+                    const std::uint64_t w,
+                    const std::uint64_t e,
+                    const std::uint64_t sw,
+                    const std::uint64_t s,
+                    const std::uint64_t se) {
+	std::uint64_t top_ones, top_twos;
+	std::uint64_t mid_ones, mid_twos;
+	std::uint64_t bottom_ones, bottom_twos;
+	full_add(nw, n, ne, top_ones, top_twos);
+	half_add(w, e, mid_ones, mid_twos);
+	full_add(sw, s, se, bottom_ones, bottom_twos);
+
+	Counts        ret;
+	std::uint64_t ones_carry, twos_partial, fours_a, fours_b;
+	full_add(top_ones, mid_ones, bottom_ones, ret.ones, ones_carry);
+	full_add(top_twos, mid_twos, bottom_twos, twos_partial, fours_a);
+	half_add(twos_partial, ones_carry, ret.twos, fours_b);
+	half_add(fours_a, fours_b, ret.fours, ret.eights);
+	return ret;
+}
+
+/// Next state of every cell of a word under the Life-like rule with birth
+/// and survival counts `Birth` and `Survival` (see `LifeLikeRule`). The
+/// rule is known at compile time, so only the counts that are in it are
+/// ever compared against.
+template<std::uint16_t Birth, std::uint16_t Survival>
+struct StaticRule {
+	std::uint64_t operator()(const std::uint64_t center,
+	                         const std::uint64_t nw,
+	                         const std::uint64_t n,
+	                         const std::uint64_t ne,
+	                         const std::uint64_t w,
+	                         const std::uint64_t e,
+	                         const std::uint64_t sw,
+	                         const std::uint64_t s,
+	                         const std::uint64_t se) const {
+		const Counts counts = count(nw, n, ne, w, e, sw, s, se);
+		return (~center & matching<Birth>(counts))
+		       | (center & matching<Survival>(counts));
+	}
+
+private:
+	/// The cells whose count is in `Set`, unrolled at compile time.
+	template<std::uint16_t Set, unsigned int... C>
+	static std::uint64_t matching(const Counts& counts,
+	                              std::integer_sequence<unsigned int, C...>) {
+		return (((Set >> C) & 1 ? counts.equal(C) : 0) | ... | 0);
+	}
+	template<std::uint16_t Set>
+	static std::uint64_t matching(const Counts& counts) {
+		return matching<Set>(counts,
+		                     std::make_integer_sequence<unsigned int, 9>());
+	}
+};
+
+/// B3/S23 goes through the hand-tuned `next_word`.
+template<>
+struct StaticRule<1 << 3, 1 << 2 | 1 << 3> {
+	std::uint64_t operator()(const std::uint64_t center,
+	                         const std::uint64_t nw,
+	                         const std::uint64_t n,
+	                         const std::uint64_t ne,
+	                         const std::uint64_t w,
+	                         const std::uint64_t e,
+	                         const std::uint64_t sw,
+	                         const std::uint64_t s,
+	                         const std::uint64_t se) const {
+		return next_word(center, nw, n, ne, w, e, sw, s, se);
+	}
+};
+
+/// `StaticRule` for any rule, chosen at runtime. Rather than comparing the
+/// counts against all nine entries of the rule, the rule is spread into
+/// all-zero and all-one words and every cell picks its entry with a tree of
+/// bitwise multiplexers on the bits of its count.
+class DynamicRule {
+public:
+	DynamicRule(const std::uint16_t birth, const std::uint16_t survival) :
+	    m_birth(birth), m_survival(survival) {}
+
+	std::uint64_t operator()(const std::uint64_t center,
+	                         const std::uint64_t nw,
+	                         const std::uint64_t n,
+	                         const std::uint64_t ne,
+	                         const std::uint64_t w,
+	                         const std::uint64_t e,
+	                         const std::uint64_t sw,
+	                         const std::uint64_t s,
+	                         const std::uint64_t se) const {
+		const Counts counts = count(nw, n, ne, w, e, sw, s, se);
+		return (~center & m_birth.lookup(counts))
+		       | (center & m_survival.lookup(counts));
+	}
+
+private:
+	struct Table {
+		/// Entry 2i, and entry 2i xor entry 2i + 1.
+		std::uint64_t even[4], odd_diff[4];
+		std::uint64_t eight;
+
+		explicit Table(const std::uint16_t set) {
+			auto entry = [set](const unsigned int c) -> std::uint64_t {
+				return (set >> c) & 1 ? ~std::uint64_t{0} : 0;
+			};
+			for (unsigned int i = 0; i < 4; ++i) {
+				even[i]     = entry(2 * i);
+				odd_diff[i] = entry(2 * i) ^ entry(2 * i + 1);
+			}
+			eight = entry(8);
+		}
+
+		static std::uint64_t select(const std::uint64_t bit,
+		                            const std::uint64_t if_clear,
+		                            const std::uint64_t if_set) {
+			return if_clear ^ (bit & (if_clear ^ if_set));
+		}
+
+		std::uint64_t lookup(const Counts& counts) const {
+			std::uint64_t by_ones[4];
+			for (unsigned int i = 0; i < 4; ++i) {
+				by_ones[i] = even[i] ^ (counts.ones & odd_diff[i]);
+			}
+			const std::uint64_t low =
+			    select(counts.fours,
+			           select(counts.twos, by_ones[0], by_ones[1]),
+			           select(counts.twos, by_ones[2], by_ones[3]));
+			// A count of 8 has every lower bit clear.
+			return select(counts.eights, low, eight);
+		}
+	};
+
+	Table m_birth;
+	Table m_survival;
+};
+
+/// Call `step(next_word)` with the word kernel for the two-state `rule`.
+/// Well known rules get one specialized for them, any other rule still runs
+/// at the speed of the bit-sliced adder but goes through `DynamicRule`.
+template<typename Step>
+void with_kernel(const cellular::LifeLikeRule& rule, Step&& step) {
+	using namespace cellular::rules;
+	if (rule == life) {
+		step(StaticRule<life.birth, life.survival>());
+	} else if (rule == highlife) {
+		step(StaticRule<highlife.birth, highlife.survival>());
+	} else if (rule == seeds) {
+		step(StaticRule<seeds.birth, seeds.survival>());
+	} else if (rule == day_and_night) {
+		step(StaticRule<day_and_night.birth, day_and_night.survival>());
+	} else {
+		step(DynamicRule(rule.birth, rule.survival));
+	}
+}
+
+} // namespace gol::bits
+
+#endif // CELLULAR_LIFE_BITS_HPP_
@@ -0,0 +1,259 @@
+#include "life_ensemble.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "cellular_thread_pool.hpp"
+#include "game_of_life.hpp"
+#include "life_bits.hpp"
+
+using namespace gol;
+
+namespace {
+constexpr size_t batch_size = 64;
+} // namespace
+
+LifeEnsemble::LifeEnsemble(const size_t width,
+                           const size_t height,
+                           const size_t instances) :
+    m_width(width),
+    m_height(height),
+    m_instances(instances),
+    m_batches((instances + batch_size - 1) / batch_size),
+    m_stride(width + 2),
+    m_batch_words(m_stride * (height + 2)),
+    m_cells(2 * m_batches * m_batch_words, 0),
+    m_current(m_batches, 0),
+    m_active(m_batches, ~std::uint64_t{0}),
+    m_has_previous(m_batches, 0),
+    m_generations(instances, 0) {
+	// Lanes past the last instance never run.
+	if (instances % batch_size != 0) {
+		m_active.back() = (std::uint64_t{1} << (instances % batch_size)) - 1;
+	}
+}
+
+void LifeEnsemble::step() {
+	bits::with_kernel(m_rule,
+	                  [this](const auto& next_word) { step_with(next_word); });
+}
+
+template<typename NextWord>
+void LifeEnsemble::step_with(const NextWord& next_word) {
+	auto step_batch = [&](const size_t batch) {
+		const std::uint64_t active = m_active[batch];
+		if (active == 0) { return; }
+		fill_halo(batch);
+
+		const std::uint64_t* cells =
+		    &m_cells[(2 * batch + m_current[batch]) * m_batch_words];
+		std::uint64_t* next =
+		    &m_cells[(2 * batch + 1 - m_current[batch]) * m_batch_words];
+		// Copied, since the stores into `next` could alias the members as far
+		// as the compiler knows, which keeps it from vectorizing.
+		const size_t width  = m_width;
+		const size_t height = m_height;
+		const size_t stride = m_stride;
+		// The instances with any cell that differs from the current and from
+		// the previous generation.
+		std::uint64_t changed = 0;
+		std::uint64_t cycled  = 0;
+		for (size_t y = 1; y <= height; ++y) {
+			const std::uint64_t* above = cells + (y - 1) * stride;
+			const std::uint64_t* row   = cells + y * stride;
+			const std::uint64_t* below = cells + (y + 1) * stride;
+			std::uint64_t*       out   = next + y * stride;
+			// Plain bitwise operations on consecutive words, which the
+			// compiler can vectorize further.
+			for (size_t x = 1; x <= width; ++x) {
+				const std::uint64_t center = row[x];
+				std::uint64_t       word   = next_word(center,
+				                                       above[x - 1],
+				                                       above[x],
+				                                       above[x + 1],
+				                                       row[x - 1],
+				                                       row[x + 1],
+				                                       below[x - 1],
+				                                       below[x],
+				                                       below[x + 1]);
+				// Stopped instances keep their cells.
+				word = center ^ ((word ^ center) & active);
+				changed |= word ^ center;
+				cycled |= word ^ out[x];
+				out[x] = word;
+			}
+		}
+		m_current[batch] ^= 1;
+
+		for (std::uint64_t lanes = active; lanes != 0; lanes &= lanes - 1) {
+			++m_generations[batch * batch_size + std::countr_zero(lanes)];
+		}
+		std::uint64_t settled = 0;
+		if (m_stop == Stop::still) {
+			settled = ~changed;
+		} else if (m_stop == Stop::period_two) {
+			settled = ~changed | (~cycled & m_has_previous[batch]);
+		}
+		m_active[batch] &= ~settled;
+		// Even stopped instances have their previous generation now, it's
+		// the same as the current one.
+		m_has_previous[batch] = ~std::uint64_t{0};
+	};
+
+	if (m_pool) {
+		m_pool->parallel_for(m_batches, step_batch);
+	} else {
+		for (size_t batch = 0; batch < m_batches; ++batch) {
+			step_batch(batch);
+		}
+	}
+}
+
+void LifeEnsemble::step(const size_t generations) {
+	for (size_t i = 0; i < generations && active_count() > 0; ++i) { step(); }
+}
+
+void LifeEnsemble::fill_halo(const size_t batch) {
+	const auto w = static_cast<std::ptrdiff_t>(m_width);
+	const auto h = static_cast<std::ptrdiff_t>(m_height);
+	auto       fill = [&](const std::ptrdiff_t x, const std::ptrdiff_t y) {
+		const std::ptrdiff_t sx = detail::halo_source(x, w, m_boundary);
+		const std::ptrdiff_t sy = detail::halo_source(y, h, m_boundary);
+		m_cells[index(batch, x, y)] =
+		    sx < 0 || sy < 0 ? 0 : m_cells[index(batch, sx, sy)];
+	};
+	for (std::ptrdiff_t x = -1; x <= w; ++x) {
+		fill(x, -1);
+		fill(x, h);
+	}
+	for (std::ptrdiff_t y = 0; y < h; ++y) {
+		fill(-1, y);
+		fill(w, y);
+	}
+}
+
+size_t LifeEnsemble::index(const size_t         batch,
+                           const std::ptrdiff_t x,
+                           const std::ptrdiff_t y) const {
+	return (2 * batch + m_current[batch]) * m_batch_words
+	       + static_cast<size_t>(y + 1) * m_stride + static_cast<size_t>(x + 1);
+}
+
+State LifeEnsemble::operator()(const size_t instance,
+                               const size_t x,
+                               const size_t y) const {
+	const std::uint64_t word = m_cells[index(instance / batch_size, x, y)];
+	return (word >> (instance % batch_size)) & 1 ? State::Alive : State::Dead;
+}
+
+void LifeEnsemble::set(const size_t instance,
+                       const size_t x,
+                       const size_t y,
+                       const State  state) {
+	const size_t        batch = instance / batch_size;
+	const std::uint64_t mask  = std::uint64_t{1} << (instance % batch_size);
+	std::uint64_t&      word  = m_cells[index(batch, x, y)];
+	word = state == State::Alive ? word | mask : word & ~mask;
+	m_has_previous[batch] &= ~mask;
+}
+
+size_t LifeEnsemble::width() const {
+	return m_width;
+}
+
+size_t LifeEnsemble::height() const {
+	return m_height;
+}
+
+size_t LifeEnsemble::size() const {
+	return m_instances;
+}
+
+size_t LifeEnsemble::population(const size_t instance) const {
+	const size_t batch = instance / batch_size;
+	const size_t bit   = instance % batch_size;
+	size_t       ret   = 0;
+	for (size_t y = 0; y < m_height; ++y) {
+		const std::uint64_t* row = &m_cells[index(batch, 0, y)];
+		for (size_t x = 0; x < m_width; ++x) { ret += (row[x] >> bit) & 1; }
+	}
+	return ret;
+}
+
+size_t LifeEnsemble::generation(const size_t instance) const {
+	return m_generations[instance];
+}
+
+bool LifeEnsemble::active(const size_t instance) const {
+	return (m_active[instance / batch_size] >> (instance % batch_size)) & 1;
+}
+
+void LifeEnsemble::set_active(const size_t instance, const bool active) {
+	const std::uint64_t mask = std::uint64_t{1} << (instance % batch_size);
+	std::uint64_t&      word = m_active[instance / batch_size];
+	word                     = active ? word | mask : word & ~mask;
+}
+
+size_t LifeEnsemble::active_count() const {
+	size_t ret = 0;
+	for (const std::uint64_t word : m_active) { ret += std::popcount(word); }
+	return ret;
+}
+
+void LifeEnsemble::assign(const size_t instance, const GameOfLife& grid) {
+	if (grid.width() != m_width || grid.height() != m_height) {
+		throw std::invalid_argument("Grid dimensions don't match");
+	}
+	for (size_t x = 0; x < m_width; ++x) {
+		for (size_t y = 0; y < m_height; ++y) {
+			set(instance, x, y, grid(x, y));
+		}
+	}
+}
+
+void LifeEnsemble::copy_to(const size_t instance, GameOfLife& grid) const {
+	if (grid.width() != m_width || grid.height() != m_height) {
+		throw std::invalid_argument("Grid dimensions don't match");
+	}
+	for (size_t x = 0; x < m_width; ++x) {
+		for (size_t y = 0; y < m_height; ++y) {
+			grid(x, y) = (*this)(instance, x, y);
+		}
+	}
+}
+
+void LifeEnsemble::set_stop(const Stop stop) {
+	m_stop = stop;
+}
+
+void LifeEnsemble::set_boundary(const Boundary boundary) {
+	m_boundary = boundary;
+}
+
+Boundary LifeEnsemble::boundary() const {
+	return m_boundary;
+}
+
+void LifeEnsemble::set_rule(const cellular::LifeLikeRule& rule) {
+	if (rule.states != 2) {
+		throw std::invalid_argument("packed grids only hold two states");
+	}
+	m_rule = rule;
+}
+
+const cellular::LifeLikeRule& LifeEnsemble::rule() const {
+	return m_rule;
+}
+
+void LifeEnsemble::set_threads(const size_t threads) {
+	set_thread_pool(threads > 1
+	                    ? std::make_shared<cellular::ThreadPool>(threads)
+	                    : nullptr);
+}
+
+void LifeEnsemble::set_thread_pool(std::shared_ptr<cellular::ThreadPool> pool) {
+	m_pool = std::move(pool);
+}
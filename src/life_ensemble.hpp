@@ -0,0 +1,129 @@
+#ifndef CELLULAR_LIFE_ENSEMBLE_HPP_
+#define CELLULAR_LIFE_ENSEMBLE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "cellular.hpp"
+#include "cellular_rule.hpp"
+#include "cellular_thread_pool.hpp"
+#include "game_of_life.hpp"
+
+namespace gol {
+
+/// Many independent Game of Life grids of the same size, stepped together.
+/// The instances are interleaved in bits: instances are grouped into
+/// batches of 64, and a batch stores a single `uint64_t` per cell whose bit
+/// i is that cell in instance i of the batch. One pass of the word kernel
+/// over a batch steps all 64 of its instances at once, and batches are
+/// stepped in parallel when a thread pool is set.
+///
+/// Instances can be stopped individually with `set_active`, or stop by
+/// themselves once they settle down (see `set_stop`), after which they
+/// keep their last generation and cost nothing to step.
+class LifeEnsemble {
+public:
+	/// When an instance stops on its own.
+	enum class Stop {
+		/// Only when it's stopped with `set_active`.
+		never,
+		/// Once a generation is the same as the one before it.
+		still,
+		/// Once a generation is the same as one of the two before it, which
+		/// also catches blinkers and other period 2 oscillators.
+		period_two,
+	};
+
+	LifeEnsemble(const size_t width,
+	             const size_t height,
+	             const size_t instances);
+	LifeEnsemble() = delete;
+	/// Step every active instance once.
+	void step();
+	/// Step up to `generations` times, or until no instance is active.
+	void  step(const size_t generations);
+	State operator()(const size_t instance,
+	                 const size_t x,
+	                 const size_t y) const;
+	void  set(const size_t instance,
+	          const size_t x,
+	          const size_t y,
+	          const State  state);
+	size_t width() const;
+	size_t height() const;
+	/// Amount of instances.
+	size_t size() const;
+	/// Amount of live cells in `instance`.
+	size_t population(const size_t instance) const;
+	/// Amount of generations `instance` was stepped while active.
+	size_t generation(const size_t instance) const;
+	bool   active(const size_t instance) const;
+	/// Stop or resume stepping `instance`.
+	void   set_active(const size_t instance, const bool active);
+	size_t active_count() const;
+	/// Copy `grid`, which must have the same dimensions, into `instance`.
+	void assign(const size_t instance, const GameOfLife& grid);
+	/// Copy `instance` into `grid`, which must have the same dimensions.
+	void copy_to(const size_t instance, GameOfLife& grid) const;
+	/// `Stop::never` by default.
+	void set_stop(const Stop stop);
+	/// What the cells past the edges of every grid are, `Boundary::dead` by
+	/// default.
+	void               set_boundary(const cellular::Boundary boundary);
+	cellular::Boundary boundary() const;
+	/// Step with `rule` instead of B3/S23. Throws `std::invalid_argument`
+	/// for Generations rules, which need more than a bit per cell.
+	void                          set_rule(const cellular::LifeLikeRule& rule);
+	const cellular::LifeLikeRule& rule() const;
+	/// Step batches on a pool of `threads` threads, or serially if
+	/// `threads` is 1.
+	void set_threads(const size_t threads);
+	/// Step batches on `pool`, which may be shared with other automata.
+	/// Passing `nullptr` makes stepping serial again.
+	void set_thread_pool(std::shared_ptr<cellular::ThreadPool> pool);
+
+private:
+	/// `step` with the word kernel `next_word`, see `bits::StaticRule`.
+	template<typename NextWord>
+	void step_with(const NextWord& next_word);
+	/// Fill the halo of `batch` according to the boundary.
+	void fill_halo(const size_t batch);
+	/// The word of (`x`, `y`) in the current generation of `batch`, where -1
+	/// and the width or height are in the halo.
+	size_t index(const size_t         batch,
+	             const std::ptrdiff_t x,
+	             const std::ptrdiff_t y) const;
+
+	size_t m_width;
+	size_t m_height;
+	size_t m_instances;
+	size_t m_batches;
+	/// Words per row of a batch, the row and a halo word on either side.
+	size_t m_stride;
+	/// Words per batch, the rows and a halo row above and below them.
+	size_t m_batch_words;
+	/// Two buffers per batch, one after the other, each holding its cells
+	/// row by row. One is the current generation, the other the one before
+	/// it until the next one is computed in its place.
+	std::vector<std::uint64_t> m_cells;
+	/// Which of the buffers of every batch is the current generation.
+	/// Batches with no active instances aren't stepped, so they're swapped
+	/// one by one.
+	std::vector<std::uint8_t> m_current;
+	/// Bit i of word b is set if instance 64b + i is stepped.
+	std::vector<std::uint64_t> m_active;
+	/// Bit i of word b is set if instance 64b + i has the generation before
+	/// the current one in the other buffer, for `Stop::period_two`.
+	std::vector<std::uint64_t>            m_has_previous;
+	std::vector<size_t>                   m_generations;
+	Stop                                  m_stop     = Stop::never;
+	cellular::Boundary                    m_boundary = cellular::Boundary::dead;
+	cellular::LifeLikeRule                m_rule     = cellular::rules::life;
+	std::shared_ptr<cellular::ThreadPool> m_pool;
+};
+
+} // namespace gol
+
+#endif // CELLULAR_LIFE_ENSEMBLE_HPP_
@@ -0,0 +1,66 @@
+#include "life_like.hpp"
+
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "cellular.hpp"
+#include "cellular_rule.hpp"
+
+using namespace cellular;
+using namespace life_like;
+
+LifeLike::LifeLike(const size_t        width,
+                   const size_t        height,
+                   const LifeLikeRule& rule) :
+    StaticAutomaton(width, height),
+    m_rule(rule) {
+	set_count_rule(m_rule.count_rule());
+}
+
+LifeLike::LifeLike(const size_t           width,
+                   const size_t           height,
+                   const std::string_view rule) :
+    LifeLike(width, height, LifeLikeRule::parse(rule)) {}
+
+LifeLike::LifeLike(const std::filesystem::path& filename,
+                   const LifeLikeRule&          rule) :
+    LifeLike(1, 1, rule) {
+	// `char_to_state` can't be called from the base constructor.
+	set_grid_from_file(filename);
+}
+
+const LifeLikeRule& LifeLike::rule() const {
+	return m_rule;
+}
+
+char LifeLike::state_to_char(State state) const {
+	switch (state) {
+	case 0:
+		return '*';
+	case 1:
+		return '#';
+	default:
+		return static_cast<char>('a' + state - 2);
+	}
+}
+
+State LifeLike::char_to_state(char c) const {
+	if (c == '*') { return 0; }
+	if (c == '#') { return 1; }
+	if (c >= 'a' && c - 'a' + 2 < m_rule.states) {
+		return static_cast<State>(c - 'a' + 2);
+	}
+	throw std::invalid_argument(std::string{"Invalid state value: "} + c);
+}
+
+State LifeLike::cycle_state(const State current_cell) const {
+	return current_cell + 1 < m_rule.states ? current_cell + 1 : 0;
+}
+
+State LifeLike::next_cell(const State  current_cell,
+                          const size_t x,
+                          const size_t y) const {
+	return m_rule.next(current_cell, count_moore(x, y, State{1}));
+}
@@ -0,0 +1,47 @@
+#ifndef CELLULAR_LIFE_LIKE_HPP_
+#define CELLULAR_LIFE_LIKE_HPP_
+
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+#include "cellular.hpp"
+#include "cellular_rule.hpp"
+#include "cellular_static.hpp"
+
+using namespace cellular;
+
+namespace life_like {
+/// 0 is dead, 1 alive and anything above that one of a Generations rule's
+/// dying states.
+using State = std::uint8_t;
+
+/// Any Life-like or Generations rule, given as a `LifeLikeRule` or a rule
+/// string. The rule is compiled into the lookup table that the vectorized
+/// step runs on, so every rule steps as fast as `GameOfLife` does.
+class LifeLike : public StaticAutomaton<LifeLike, State> {
+public:
+	LifeLike(const size_t        width,
+	         const size_t        height,
+	         const LifeLikeRule& rule = rules::life);
+	LifeLike(const size_t width, const size_t height, std::string_view rule);
+	LifeLike(const std::filesystem::path& filename, const LifeLikeRule& rule);
+	const LifeLikeRule& rule() const;
+	/// Dead cells are '*' and live ones '#' like in `GameOfLife`, dying
+	/// states are 'a' for state 2, 'b' for state 3 and so on.
+	char  state_to_char(State state) const override;
+	State char_to_state(char c) const override;
+	State cycle_state(const State current_cell) const override;
+
+protected:
+	friend StaticAutomaton;
+	State next_cell(const State  current_cell,
+	                const size_t x,
+	                const size_t y) const;
+
+private:
+	LifeLikeRule m_rule;
+};
+} // namespace life_like
+
+#endif // CELLULAR_LIFE_LIKE_HPP_
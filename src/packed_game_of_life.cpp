@@ -0,0 +1,182 @@
+#include "packed_game_of_life.hpp"
+
+#include <bit>
+#include <filesystem>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "cellular_io.hpp"
+#include "game_of_life.hpp"
+#include "life_bits.hpp"
+
+using namespace gol;
+
+namespace {
+constexpr size_t bits_per_word = 64;
+} // namespace
+
+PackedGameOfLife::PackedGameOfLife(const size_t width, const size_t height) :
+    m_width(width),
+    m_height(height),
+    m_words_per_row((width + bits_per_word - 1) / bits_per_word),
+    m_last_word_mask(width % bits_per_word == 0
+                         ? ~std::uint64_t{0}
+                         : (std::uint64_t{1} << (width % bits_per_word)) - 1),
+    m_cells(m_words_per_row * height, 0),
+    m_next_cells(m_cells),
+    m_empty_row(m_words_per_row, 0) {}
+
+PackedGameOfLife::PackedGameOfLife(const std::filesystem::path& filename) :
+    PackedGameOfLife(1, 1) {
+	set_grid_from_file(filename);
+}
+
+PackedGameOfLife::PackedGameOfLife(const GameOfLife& dense) :
+    PackedGameOfLife(dense.width(), dense.height()) {
+	assign(dense);
+}
+
+void PackedGameOfLife::step() {
+	bits::with_kernel(m_rule,
+	                  [this](const auto& next_word) { step_with(next_word); });
+}
+
+template<typename NextWord>
+void PackedGameOfLife::step_with(const NextWord& next_word) {
+	const size_t words = m_words_per_row;
+	for (size_t y = 0; y < m_height; ++y) {
+		// Rows off the edge of the grid are read as empty rows.
+		const std::uint64_t* above =
+		    y > 0 ? &m_cells[(y - 1) * words] : m_empty_row.data();
+		const std::uint64_t* row = &m_cells[y * words];
+		const std::uint64_t* below =
+		    y + 1 < m_height ? &m_cells[(y + 1) * words] : m_empty_row.data();
+		std::uint64_t* next = &m_next_cells[y * words];
+
+		for (size_t k = 0; k < words; ++k) {
+			// Cell x's west neighbor is bit x - 1, so shifting a word left
+			// lines every cell up with its west neighbor. The bits that
+			// cross a word boundary come from the adjacent words.
+			auto west = [&](const std::uint64_t* r) {
+				return (r[k] << 1) | (k > 0 ? r[k - 1] >> 63 : 0);
+			};
+			auto east = [&](const std::uint64_t* r) {
+				return (r[k] >> 1) | (k + 1 < words ? r[k + 1] << 63 : 0);
+			};
+
+			next[k] = next_word(row[k],
+			                    west(above),
+			                    above[k],
+			                    east(above),
+			                    west(row),
+			                    east(row),
+			                    west(below),
+			                    below[k],
+			                    east(below));
+		}
+		next[words - 1] &= m_last_word_mask;
+	}
+	std::swap(m_cells, m_next_cells);
+}
+
+void PackedGameOfLife::step(const size_t generations) {
+	for (size_t i = 0; i < generations; ++i) { step(); }
+}
+
+PackedGameOfLife::CellReference PackedGameOfLife::operator()(const size_t x,
+                                                             const size_t y) {
+	return CellReference(m_cells[y * m_words_per_row + x / bits_per_word],
+	                     x % bits_per_word);
+}
+
+State PackedGameOfLife::operator()(const size_t x, const size_t y) const {
+	const std::uint64_t word = m_cells[y * m_words_per_row + x / bits_per_word];
+	return (word >> (x % bits_per_word)) & 1 ? State::Alive : State::Dead;
+}
+
+size_t PackedGameOfLife::width() const {
+	return m_width;
+}
+
+size_t PackedGameOfLife::height() const {
+	return m_height;
+}
+
+void PackedGameOfLife::set_grid_from_file(const std::filesystem::path& filename,
+                                          const char delimiter) {
+	const cellular::io::MappedFile file(filename);
+	load(file.view(), delimiter);
+}
+
+void PackedGameOfLife::set_grid_from_string(std::string&& str,
+                                            const char    delimiter) {
+	load(str, delimiter);
+}
+
+void PackedGameOfLife::load(const std::string_view text,
+                            const char             delimiter) {
+	// Parsed straight into the packed words, without a dense grid in between.
+	// Only the character mapping is shared with `GameOfLife`.
+	const GameOfLife                characters(1, 1);
+	std::optional<PackedGameOfLife> packed;
+	cellular::io::parse(
+	    text,
+	    delimiter,
+	    [&](const size_t width, const size_t height) {
+		    packed.emplace(width, height);
+	    },
+	    [&](const size_t x, const size_t y, const char c) {
+		    (*packed)(x, y) = characters.char_to_state(c);
+	    },
+	    [&](const size_t x, const size_t y, const unsigned int state) {
+		    if (state > 1) {
+			    throw std::invalid_argument("Game of Life only has 2 states");
+		    }
+		    (*packed)(x, y) = State::Alive;
+	    });
+	*this = std::move(*packed);
+}
+
+void PackedGameOfLife::set_rule(const cellular::LifeLikeRule& rule) {
+	if (rule.states != 2) {
+		throw std::invalid_argument("packed grids only hold two states");
+	}
+	m_rule = rule;
+}
+
+const cellular::LifeLikeRule& PackedGameOfLife::rule() const {
+	return m_rule;
+}
+
+State PackedGameOfLife::cycle_state(const State current_cell) const {
+	return current_cell == State::Alive ? State::Dead : State::Alive;
+}
+
+size_t PackedGameOfLife::population() const {
+	size_t ret = 0;
+	for (const std::uint64_t word : m_cells) { ret += std::popcount(word); }
+	return ret;
+}
+
+void PackedGameOfLife::copy_to(GameOfLife& dense) const {
+	if (dense.width() != m_width || dense.height() != m_height) {
+		throw std::invalid_argument("Grid dimensions don't match");
+	}
+	for (size_t x = 0; x < m_width; ++x) {
+		for (size_t y = 0; y < m_height; ++y) { dense(x, y) = (*this)(x, y); }
+	}
+}
+
+void PackedGameOfLife::assign(const GameOfLife& dense) {
+	for (size_t y = 0; y < m_height; ++y) {
+		for (size_t x = 0; x < m_width; ++x) {
+			if (dense(x, y) == State::Alive) {
+				m_cells[y * m_words_per_row + x / bits_per_word] |=
+				    std::uint64_t{1} << (x % bits_per_word);
+			}
+		}
+	}
+}
@@ -0,0 +1,114 @@
+#ifndef CELLULAR_PACKED_GAME_OF_LIFE_HPP_
+#define CELLULAR_PACKED_GAME_OF_LIFE_HPP_
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "cellular_rule.hpp"
+#include "game_of_life.hpp"
+
+namespace gol {
+
+/// Game of Life engine that packs 64 cells into every `uint64_t` and
+/// computes a whole word of next states at once. It exposes the same
+/// surface as `GameOfLife` (`operator()`, `width()`, `height()`, `step()`
+/// and the file loaders), so it can be used wherever a `GameOfLife` is
+/// expected by a template such as `cellular_gui::draw_grid`.
+///
+/// Other two-state Life-like rules can be set with `set_rule`. Well known
+/// ones step through a kernel specialized for them at compile time, any
+/// other through one that reads the rule at runtime.
+class PackedGameOfLife {
+public:
+	/// Proxy returned by the non-const `operator()`, since single bits can't
+	/// be referenced.
+	class CellReference {
+	public:
+		inline         operator State() const;
+		inline CellReference& operator=(const State state);
+		inline CellReference& operator=(const CellReference& other);
+
+	private:
+		friend class PackedGameOfLife;
+		inline CellReference(std::uint64_t& word, const unsigned int bit);
+
+		std::uint64_t& m_word;
+		std::uint64_t  m_mask;
+	};
+
+	PackedGameOfLife(const size_t width, const size_t height);
+	PackedGameOfLife(const std::filesystem::path& filename);
+	explicit PackedGameOfLife(const GameOfLife& dense);
+	PackedGameOfLife() = delete;
+	void          step();
+	void          step(const size_t generations);
+	CellReference operator()(const size_t x, const size_t y);
+	State         operator()(const size_t x, const size_t y) const;
+	size_t        width() const;
+	size_t        height() const;
+	void          set_grid_from_file(const std::filesystem::path& filename,
+	                                 const char delimiter = '\n');
+	void  set_grid_from_string(std::string&& str, const char delimiter = '\n');
+	State cycle_state(const State current_cell) const;
+	/// Amount of live cells.
+	size_t population() const;
+	/// Copy every cell into `dense`, which must have the same dimensions.
+	void copy_to(GameOfLife& dense) const;
+	/// Step with `rule` instead of B3/S23. Throws `std::invalid_argument`
+	/// for Generations rules, which need more than a bit per cell.
+	void                          set_rule(const cellular::LifeLikeRule& rule);
+	const cellular::LifeLikeRule& rule() const;
+
+private:
+	/// `step` with the word kernel `next_word`, see `bits::StaticRule`.
+	template<typename NextWord>
+	void step_with(const NextWord& next_word);
+	void assign(const GameOfLife& dense);
+	void load(const std::string_view text, const char delimiter);
+
+	size_t m_width;
+	size_t m_height;
+	/// Amount of words in every row, rows are padded to whole words.
+	size_t m_words_per_row;
+	/// Bits of the last word in every row that are inside the grid.
+	std::uint64_t m_last_word_mask;
+	/// Row-major words, bit `x % 64` of word `x / 64` in row `y` is the cell
+	/// (x, y).
+	std::vector<std::uint64_t> m_cells;
+	/// Scratch buffer for the next generation, swapped with `m_cells`.
+	std::vector<std::uint64_t> m_next_cells;
+	/// A row of dead cells, read in place of the rows off the grid's edges.
+	std::vector<std::uint64_t> m_empty_row;
+	cellular::LifeLikeRule     m_rule = cellular::rules::life;
+};
+
+inline PackedGameOfLife::CellReference::CellReference(std::uint64_t&     word,
+                                                      const unsigned int bit) :
+    m_word(word),
+    m_mask(std::uint64_t{1} << bit) {}
+
+inline PackedGameOfLife::CellReference::operator State() const {
+	return (m_word & m_mask) ? State::Alive : State::Dead;
+}
+
+inline PackedGameOfLife::CellReference&
+PackedGameOfLife::CellReference::operator=(const State state) {
+	if (state == State::Alive) {
+		m_word |= m_mask;
+	} else {
+		m_word &= ~m_mask;
+	}
+	return *this;
+}
+
+inline PackedGameOfLife::CellReference&
+PackedGameOfLife::CellReference::operator=(const CellReference& other) {
+	return *this = static_cast<State>(other);
+}
+
+} // namespace gol
+
+#endif // CELLULAR_PACKED_GAME_OF_LIFE_HPP_
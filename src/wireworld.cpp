@@ -10,10 +10,15 @@ using namespace wireworld;
 
 // First state is the default one
 Wireworld::Wireworld(const size_t width, const size_t height) :
-    Automaton<State>(width, height) {}
+    StaticAutomaton(width, height) {
+	set_count_rule(CountRule::from(State::ElectronHead, 4, rule));
+}
 
 Wireworld::Wireworld(const std::filesystem::path& filename) :
-    Automaton<State>(filename) {}
+    Wireworld(1, 1) {
+	// `char_to_state` can't be called from the base constructor.
+	set_grid_from_file(filename);
+}
 
 char Wireworld::state_to_char(State state) const {
 	char ret = ' ';
@@ -67,9 +72,19 @@ State Wireworld::char_to_state(char c) const {
 	}
 }
 
-State Wireworld::next_state(const State  current_cell,
-                            const size_t x,
-                            const size_t y) {
+State Wireworld::next_cell(const State  current_cell,
+                           const size_t x,
+                           const size_t y) const {
+	// Only conductors look at their neighbors.
+	const unsigned int nearby_heads =
+	    current_cell == State::Conductor
+	        ? count_moore(x, y, State::ElectronHead)
+	        : 0;
+	return rule(current_cell, nearby_heads);
+}
+
+State Wireworld::rule(const State        current_cell,
+                      const unsigned int nearby_heads) {
 	State ret = State::Empty;
 	switch (current_cell) {
 	case State::Empty: {
@@ -84,13 +99,6 @@ State Wireworld::next_state(const State  current_cell,
 		break;
 	}
 	case State::Conductor: {
-		const auto&  neighborhood = moore_neighborhood_at(x, y);
-		unsigned int nearby_heads =
-		    std::count_if(std::begin(neighborhood),
-		                  std::end(neighborhood),
-		                  [](std::pair<const char*, State> const& p) {
-			                  return p.second == State::ElectronHead;
-		                  });
 		if (nearby_heads == 1 || nearby_heads == 2) {
 			ret = State::ElectronHead;
 		} else {
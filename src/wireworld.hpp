@@ -1,20 +1,24 @@
 #ifndef CELLULAR_WIREWORLD_HPP_
 #define CELLULAR_WIREWORLD_HPP_
 
-#include <SDL2/SDL.h>
-
+#include <cstdint>
 #include <filesystem>
 
 #include "cellular.hpp"
-#include "cellular_gui.hpp"
+#include "cellular_static.hpp"
 
 using namespace cellular;
 
 namespace wireworld {
 // First state is the default one
-enum class State { Empty, ElectronHead, ElectronTail, Conductor };
+enum class State : std::uint8_t {
+	Empty,
+	ElectronHead,
+	ElectronTail,
+	Conductor
+};
 
-class Wireworld : public Automaton<State> {
+class Wireworld : public StaticAutomaton<Wireworld, State> {
 public:
 	Wireworld(const size_t width, const size_t height);
 	Wireworld(const std::filesystem::path& filename);
@@ -23,9 +27,15 @@ public:
 	State cycle_state(const State current_cell) const override;
 
 protected:
-	State next_state(const State  current_cell,
-	                 const size_t x,
-	                 const size_t y) override;
+	friend StaticAutomaton;
+	State next_cell(const State  current_cell,
+	                const size_t x,
+	                const size_t y) const;
+
+private:
+	/// The rule itself, shared by `next_cell` and the vectorized step.
+	static State rule(const State        current_cell,
+	                  const unsigned int nearby_heads);
 };
 } // namespace wireworld
 
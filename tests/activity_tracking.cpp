@@ -0,0 +1,65 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <random>
+
+#include "doctest.h"
+#include "game_of_life.hpp"
+#include "test_util.hpp"
+#include "wireworld.hpp"
+
+using test_util::same_cells;
+
+TEST_CASE("tracked Wireworld matches full stepping, with edits") {
+	using wireworld::State;
+
+	// Sparse wires with a few electrons, the rest of the grid is empty.
+	wireworld::Wireworld        full(150, 300);
+	std::mt19937                rng(4);
+	std::bernoulli_distribution wire(0.1);
+	std::bernoulli_distribution head(0.05);
+	for (size_t x = 0; x < full.width(); ++x) {
+		for (size_t y = 0; y < full.height(); ++y) {
+			if (wire(rng)) {
+				full(x, y) = head(rng) ? State::ElectronHead : State::Conductor;
+			}
+		}
+	}
+	wireworld::Wireworld tracked = full;
+	tracked.set_activity_tracking(true);
+
+	for (int generation = 0; generation < 60; ++generation) {
+		if (generation % 15 == 7) {
+			// Edits far from any activity have to be picked up too.
+			full(140, 295 - generation)    = State::ElectronHead;
+			tracked(140, 295 - generation) = State::ElectronHead;
+		}
+		full.step();
+		tracked.step();
+		REQUIRE(same_cells(full, tracked));
+	}
+}
+
+TEST_CASE("tracked Game of Life matches full stepping in parallel") {
+	using gol::State;
+
+	gol::GameOfLife full(200, 600);
+	// Gliders crossing several tiles and a blinker at a tile corner.
+	for (const size_t top : {0, 230}) {
+		full(1, top)     = State::Alive;
+		full(2, top + 1) = State::Alive;
+		full(0, top + 2) = State::Alive;
+		full(1, top + 2) = State::Alive;
+		full(2, top + 2) = State::Alive;
+	}
+	full(95, 256) = State::Alive;
+	full(96, 256) = State::Alive;
+	full(97, 256) = State::Alive;
+	gol::GameOfLife tracked = full;
+	tracked.set_activity_tracking(true);
+	tracked.set_threads(3);
+
+	for (int generation = 0; generation < 200; ++generation) {
+		full.step();
+		tracked.step();
+	}
+	CHECK(same_cells(full, tracked));
+}
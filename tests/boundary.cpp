@@ -0,0 +1,157 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <random>
+#include <vector>
+
+#include "doctest.h"
+#include "game_of_life.hpp"
+#include "test_util.hpp"
+
+namespace {
+using gol::State;
+using test_util::same_cells;
+
+/// Game of Life through `moore_view_at`, without a `CountRule`.
+class ViewLife : public Automaton<State> {
+public:
+	using Automaton<State>::Automaton;
+	char  state_to_char(State) const override { return '*'; }
+	State char_to_state(char) const override { return State::Dead; }
+	State cycle_state(const State current_cell) const override {
+		return current_cell;
+	}
+
+protected:
+	State next_state(const State  current_cell,
+	                 const size_t x,
+	                 const size_t y) override {
+		const auto view = moore_view_at(x, y);
+		CHECK(view.size()
+		      == (boundary() == Boundary::dead ? view.size() : 8U));
+		const unsigned int live = view.count(State::Alive);
+		return live == 3 || (current_cell == State::Alive && live == 2)
+		           ? State::Alive
+		           : State::Dead;
+	}
+};
+
+/// A generation of `cells`, computed with plain coordinate arithmetic.
+std::vector<State> reference_step(const std::vector<State>& cells,
+                                  const long                width,
+                                  const long                height,
+                                  const Boundary            boundary) {
+	auto source = [boundary](long i, const long size) {
+		if (boundary == Boundary::toroidal) { return (i + size) % size; }
+		if (boundary == Boundary::reflective) {
+			return i < 0 ? 0 : i >= size ? size - 1 : i;
+		}
+		return i;
+	};
+	std::vector<State> next(cells.size());
+	for (long x = 0; x < width; ++x) {
+		for (long y = 0; y < height; ++y) {
+			unsigned int live = 0;
+			for (long dx = -1; dx <= 1; ++dx) {
+				for (long dy = -1; dy <= 1; ++dy) {
+					const long nx = source(x + dx, width);
+					const long ny = source(y + dy, height);
+					if ((dx != 0 || dy != 0) && nx >= 0 && nx < width
+					    && ny >= 0 && ny < height) {
+						live += cells[nx * height + ny] == State::Alive;
+					}
+				}
+			}
+			const State current = cells[x * height + y];
+			next[x * height + y] =
+			    live == 3 || (current == State::Alive && live == 2)
+			        ? State::Alive
+			        : State::Dead;
+		}
+	}
+	return next;
+}
+
+template<typename Automaton>
+bool matches(const Automaton& automaton, const std::vector<State>& cells) {
+	for (size_t x = 0; x < automaton.width(); ++x) {
+		for (size_t y = 0; y < automaton.height(); ++y) {
+			if (automaton(x, y) != cells[x * automaton.height() + y]) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+} // namespace
+
+TEST_CASE("every boundary matches the reference") {
+	constexpr size_t width  = 70;
+	constexpr size_t height = 45;
+
+	std::mt19937                rng(8);
+	std::bernoulli_distribution alive(0.35);
+	for (const auto boundary :
+	     {Boundary::dead, Boundary::toroidal, Boundary::reflective}) {
+		std::vector<State> cells(width * height);
+		gol::GameOfLife    vectorized(width, height);
+		ViewLife           viewed(width, height);
+		for (size_t x = 0; x < width; ++x) {
+			for (size_t y = 0; y < height; ++y) {
+				const State state = alive(rng) ? State::Alive : State::Dead;
+				cells[x * height + y] = state;
+				vectorized(x, y)      = state;
+				viewed(x, y)          = state;
+			}
+		}
+		gol::GameOfLife tracked = vectorized;
+		vectorized.set_boundary(boundary);
+		viewed.set_boundary(boundary);
+		tracked.set_boundary(boundary);
+		tracked.set_activity_tracking(true);
+		tracked.set_threads(2);
+
+		for (int generation = 0; generation < 30; ++generation) {
+			cells = reference_step(cells, width, height, boundary);
+			vectorized.step();
+			viewed.step();
+			tracked.step();
+			REQUIRE(matches(vectorized, cells));
+			REQUIRE(matches(viewed, cells));
+			REQUIRE(matches(tracked, cells));
+		}
+	}
+}
+
+TEST_CASE("a glider goes around a torus") {
+	gol::GameOfLife automaton(16, 8);
+	automaton.set_boundary(Boundary::toroidal);
+	automaton(1, 0) = State::Alive;
+	automaton(2, 1) = State::Alive;
+	automaton(0, 2) = State::Alive;
+	automaton(1, 2) = State::Alive;
+	automaton(2, 2) = State::Alive;
+	const gol::GameOfLife start = automaton;
+
+	// A glider moves one cell diagonally every 4 generations, so it's back
+	// after moving lcm(16, 8) = 16 cells.
+	automaton.step(4 * 16);
+	CHECK(same_cells(automaton, start));
+}
+
+TEST_CASE("switching the boundary reschedules tracked tiles") {
+	gol::GameOfLife untracked(20, 20);
+	// Blocks on both edges are still lifes until they touch through a torus.
+	for (const size_t x : {0, 1, 18, 19}) {
+		untracked(x, 9)  = State::Alive;
+		untracked(x, 10) = State::Alive;
+	}
+	gol::GameOfLife tracked = untracked;
+	tracked.set_activity_tracking(true);
+
+	tracked.step(3);
+	untracked.step(3);
+	tracked.set_boundary(Boundary::toroidal);
+	untracked.set_boundary(Boundary::toroidal);
+	tracked.step();
+	untracked.step();
+	CHECK(same_cells(tracked, untracked));
+}
@@ -0,0 +1,173 @@
+#include "caves.hpp"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "doctest.h"
+
+using namespace caves;
+
+namespace {
+size_t count(const Caves& map, const State state) {
+	size_t ret = 0;
+	for (size_t x = 0; x < map.width(); ++x) {
+		for (size_t y = 0; y < map.height(); ++y) {
+			ret += map(x, y) == state;
+		}
+	}
+	return ret;
+}
+
+bool same_cells(const Caves& expected, const CaveMap& map) {
+	bool same = expected.width() == map.width
+	            && expected.height() == map.height;
+	for (size_t x = 0; same && x < map.width; ++x) {
+		for (size_t y = 0; y < map.height; ++y) {
+			same &= expected(x, y) == map(x, y);
+		}
+	}
+	return same;
+}
+} // namespace
+
+TEST_CASE("the 4-5 rule closes caves up at the edges") {
+	// Every cell is a floor, so only the corners, with 3 floors and 5 walls
+	// past the edges around them, become walls.
+	Caves open(6, 6);
+	open.fill(0, 1);
+	CHECK(count(open, State::Floor) == 36);
+	open.step();
+	CHECK(count(open, State::Wall) == 4);
+	CHECK(open(0, 0) == State::Wall);
+	CHECK(open(5, 5) == State::Wall);
+	CHECK(open(0, 1) == State::Floor);
+
+	// A lone floor fills in, a lone wall opens up.
+	Caves caves(5, 3);
+	caves.set_grid_from_string("#####\n"
+	                           "#.#..\n"
+	                           "#####\n");
+	caves.step();
+	CHECK(caves(1, 1) == State::Wall);
+
+	Caves pillar(5, 5);
+	pillar.set_grid_from_string(".....\n"
+	                            ".....\n"
+	                            "..#..\n"
+	                            ".....\n"
+	                            ".....\n");
+	pillar.step();
+	CHECK(pillar(2, 2) == State::Floor);
+}
+
+TEST_CASE("random fills follow the density and the seed") {
+	Caves caves(200, 100);
+	caves.fill(1, 7);
+	CHECK(count(caves, State::Wall) == 20000);
+	caves.fill(0.45, 7);
+	const size_t walls = count(caves, State::Wall);
+	CHECK(walls > 8600);
+	CHECK(walls < 9400);
+
+	Caves same(200, 100);
+	same.fill(0.45, 7);
+	Caves other(200, 100);
+	other.fill(0.45, 8);
+	size_t differ = 0;
+	for (size_t x = 0; x < caves.width(); ++x) {
+		for (size_t y = 0; y < caves.height(); ++y) {
+			CHECK(caves(x, y) == same(x, y));
+			differ += caves(x, y) != other(x, y);
+		}
+	}
+	CHECK(differ > 1000);
+
+	CHECK_THROWS_AS(caves.fill(1.5, 0), std::invalid_argument);
+	CHECK_THROWS_AS(caves.fill(-0.1, 0), std::invalid_argument);
+}
+
+TEST_CASE("floor regions are connected through edges") {
+	Caves caves(6, 4);
+	caves.set_grid_from_string("..#...\n"
+	                           "..#.#.\n"
+	                           "####.#\n"
+	                           "...##.\n");
+	const Regions regions = caves.regions();
+	// Columns are scanned first: the top left block, bottom left, top right
+	// and the two single floors. Diagonal neighbors don't connect.
+	REQUIRE(regions.sizes == std::vector<size_t>{4, 3, 5, 1, 1});
+	const auto label = [&](const size_t x, const size_t y) {
+		return regions.labels[x * caves.height() + y];
+	};
+	CHECK(label(0, 0) == 1);
+	CHECK(label(0, 3) == 2);
+	CHECK(label(2, 0) == 0);
+	CHECK(label(3, 0) == 3);
+	CHECK(label(5, 0) == 3);
+	CHECK(label(4, 2) == 4);
+	CHECK(label(5, 3) == 5);
+
+	Caves small = caves;
+	CHECK(small.prune(3) == 3);
+	CHECK(small(4, 2) == State::Wall);
+	CHECK(small(5, 3) == State::Wall);
+	CHECK(small(0, 3) == State::Floor);
+	CHECK(small.regions().sizes == std::vector<size_t>{4, 3, 5});
+
+	Caves largest = caves;
+	CHECK(largest.prune(0, true) == 1);
+	CHECK(count(largest, State::Floor) == 5);
+	CHECK(largest(3, 0) == State::Floor);
+}
+
+TEST_CASE("batches make the maps Caves::generate makes") {
+	CaveOptions options;
+	options.passes = 4;
+	for (const bool largest_only : {false, true}) {
+		options.largest_only = largest_only;
+		options.min_region   = largest_only ? 0 : 10;
+		// Heights around the vector widths, so the step's tail is covered.
+		for (const size_t height : {7, 33, 50}) {
+			CaveBatch            batch(41, height, options);
+			std::vector<CaveMap> maps = batch.generate(100, 12);
+			REQUIRE(maps.size() == 12);
+			for (size_t i = 0; i < maps.size(); ++i) {
+				Caves expected(41, height);
+				expected.generate(options, 100 + i);
+				CHECK(maps[i].seed == 100 + i);
+				CHECK(same_cells(expected, maps[i]));
+				const Regions regions = expected.regions();
+				CHECK(maps[i].regions == regions.sizes.size());
+				CHECK(maps[i].floors == count(expected, State::Floor));
+				if (largest_only) { CHECK(maps[i].regions <= 1); }
+			}
+		}
+	}
+}
+
+TEST_CASE("batches reuse their maps and don't depend on threads") {
+	CaveBatch            batch(64, 48);
+	std::vector<CaveMap> serial = batch.generate(5, 40);
+
+	batch.set_threads(3);
+	std::vector<CaveMap> maps;
+	batch.generate(maps, 5, 40);
+	const State* const storage = maps[17].cells.data();
+	for (size_t i = 0; i < maps.size(); ++i) {
+		CHECK(maps[i].cells == serial[i].cells);
+	}
+
+	// Fewer maps, then the same amount again, made in place.
+	batch.generate(maps, 1000, 20);
+	CHECK(maps.size() == 20);
+	batch.generate(maps, 5, 40);
+	CHECK(maps[17].cells == serial[17].cells);
+	CHECK(maps[17].cells.data() == storage);
+
+	CHECK_THROWS_AS(CaveBatch(0, 10), std::invalid_argument);
+	CaveOptions options;
+	options.density = 2;
+	CHECK_THROWS_AS(CaveBatch(10, 10, options), std::invalid_argument);
+}
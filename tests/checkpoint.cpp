@@ -0,0 +1,141 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "cellular_checkpoint.hpp"
+#include "cellular_layout.hpp"
+#include "doctest.h"
+#include "game_of_life.hpp"
+#include "test_util.hpp"
+
+namespace {
+using cellular::io::Compression;
+using gol::State;
+using test_util::random_soup;
+using test_util::same_cells;
+
+/// Game of Life stored in tiles, which checkpoints have to tell apart from
+/// `GameOfLife`.
+class TiledLife : public Automaton<State, layout_tiled<32>> {
+public:
+	using Automaton<State, layout_tiled<32>>::Automaton;
+	char  state_to_char(State) const override { return '*'; }
+	State char_to_state(char) const override { return State::Dead; }
+	State cycle_state(const State current_cell) const override {
+		return current_cell;
+	}
+
+protected:
+	State next_state(const State current_cell, const size_t, const size_t)
+	    override {
+		return current_cell;
+	}
+};
+
+/// A path in the temporary directory, removed again at the end of the
+/// scope.
+class TemporaryPath {
+public:
+	explicit TemporaryPath(const std::string& name) :
+	    m_path(std::filesystem::temp_directory_path() / name) {}
+	~TemporaryPath() { std::filesystem::remove(m_path); }
+	const std::filesystem::path& path() const { return m_path; }
+
+private:
+	std::filesystem::path m_path;
+};
+} // namespace
+
+TEST_CASE("checkpoints restore the grid, boundary and generation") {
+	for (const auto compression : {Compression::none, Compression::rle}) {
+		CAPTURE(static_cast<int>(compression));
+		const TemporaryPath checkpoint("cellular_test.checkpoint");
+
+		gol::GameOfLife original(300, 200);
+		random_soup(original, 0.3, 7);
+		original.set_boundary(Boundary::toroidal);
+		original.step(5);
+		original.save_checkpoint(checkpoint.path(), compression);
+
+		gol::GameOfLife restored(1, 1);
+		restored.restore_checkpoint(checkpoint.path());
+		CHECK(restored.generation() == 5);
+		CHECK(restored.boundary() == Boundary::toroidal);
+		CHECK(same_cells(original, restored));
+
+		// Stepping writes to the mapped grid, but never to the file.
+		original.step(20);
+		restored.step(20);
+		CHECK(restored.generation() == 25);
+		CHECK(same_cells(original, restored));
+		restored.restore_checkpoint(checkpoint.path());
+		CHECK(restored.generation() == 5);
+		restored.set_activity_tracking(true);
+		restored.step(20);
+		CHECK(same_cells(original, restored));
+	}
+}
+
+TEST_CASE("compression shrinks sparse grids") {
+	const TemporaryPath raw("cellular_test_raw.checkpoint");
+	const TemporaryPath rle("cellular_test_rle.checkpoint");
+	gol::GameOfLife     automaton(512, 512);
+	random_soup(automaton, 0.01, 7);
+	automaton.save_checkpoint(raw.path());
+	automaton.save_checkpoint(rle.path(), Compression::rle);
+	CHECK(std::filesystem::file_size(rle.path()) * 4
+	      < std::filesystem::file_size(raw.path()));
+}
+
+TEST_CASE("run length encoding round trips") {
+	std::mt19937      rng(3);
+	std::vector<char> bytes;
+	// Runs of every length around the encoding's limits, and literals.
+	for (size_t run = 1; run < 300; ++run) {
+		bytes.insert(bytes.end(), run, static_cast<char>(rng()));
+		for (size_t i = 0; i < run % 7; ++i) {
+			bytes.push_back(static_cast<char>(rng()));
+		}
+	}
+	std::vector<char> encoded;
+	cellular::io::detail::compress_rle(bytes.data(), bytes.size(), encoded);
+	std::vector<char> decoded(bytes.size());
+	cellular::io::decompress_rle({encoded.data(), encoded.size()},
+	                             decoded.data(),
+	                             decoded.size());
+	CHECK(decoded == bytes);
+	CHECK_THROWS_AS(cellular::io::decompress_rle({encoded.data(),
+	                                              encoded.size() - 1},
+	                                             decoded.data(),
+	                                             decoded.size()),
+	                std::invalid_argument);
+}
+
+TEST_CASE("mismatched and damaged checkpoints are rejected") {
+	const TemporaryPath checkpoint("cellular_test.checkpoint");
+	gol::GameOfLife     automaton(64, 64);
+	random_soup(automaton, 0.5, 7);
+	automaton.step();
+	automaton.save_checkpoint(checkpoint.path());
+
+	TiledLife tiled(1, 1);
+	CHECK_THROWS_AS(tiled.restore_checkpoint(checkpoint.path()),
+	                std::invalid_argument);
+
+	// Cut off in the middle of the cells.
+	std::filesystem::resize_file(checkpoint.path(),
+	                             std::filesystem::file_size(checkpoint.path())
+	                                 / 2);
+	gol::GameOfLife restored(8, 8);
+	CHECK_THROWS_AS(restored.restore_checkpoint(checkpoint.path()),
+	                std::invalid_argument);
+	CHECK(restored.width() == 8);
+
+	std::ofstream(checkpoint.path(), std::ios::trunc) << "*#*\n";
+	CHECK_THROWS_AS(restored.restore_checkpoint(checkpoint.path()),
+	                std::invalid_argument);
+}
@@ -0,0 +1,86 @@
+#include "cellular_domain.hpp"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <stdexcept>
+
+#include "doctest.h"
+#include "game_of_life.hpp"
+#include "test_util.hpp"
+#include "wireworld.hpp"
+
+using namespace gol;
+using test_util::mismatches;
+using test_util::random_soup;
+
+TEST_CASE("slabs step like the whole grid") {
+	for (const auto boundary :
+	     {Boundary::dead, Boundary::toroidal, Boundary::reflective}) {
+		for (const size_t workers : {1, 3}) {
+			CAPTURE(static_cast<int>(boundary));
+			CAPTURE(workers);
+			GameOfLife whole(101, 43);
+			random_soup(whole, 0.35, 9);
+			whole.set_boundary(boundary);
+
+			cellular::Domain<GameOfLife> domain(101, 43, workers, boundary);
+			domain.scatter(whole);
+			domain.step(30);
+			whole.step(30);
+			CHECK(domain.generation() == 30);
+
+			GameOfLife gathered(101, 43);
+			domain.gather(gathered);
+			CHECK(mismatches(whole, gathered) == 0);
+
+			// Scattering again starts over from the new cells.
+			random_soup(whole, 0.35, 10);
+			domain.scatter(whole);
+			domain.step(5);
+			whole.step(5);
+			domain.gather(gathered);
+			CHECK(mismatches(whole, gathered) == 0);
+		}
+	}
+}
+
+TEST_CASE("workers can be set up by the factory") {
+	using wireworld::Wireworld;
+	using wireworld::State;
+	// An electron running down a wire through every slab.
+	Wireworld whole(64, 20);
+	for (size_t x = 2; x < 64; ++x) { whole(x, 0) = State::Conductor; }
+	whole(0, 0) = State::ElectronTail;
+	whole(1, 0) = State::ElectronHead;
+
+	cellular::Domain<Wireworld> domain(
+	    64,
+	    20,
+	    4,
+	    Boundary::dead,
+	    [](const size_t width, const size_t height) {
+		    Wireworld automaton(width, height);
+		    automaton.set_activity_tracking(true);
+		    return automaton;
+	    });
+	domain.scatter(whole);
+	domain.step(40);
+	whole.step(40);
+	Wireworld gathered(64, 20);
+	domain.gather(gathered);
+	CHECK(gathered(41, 0) == State::ElectronHead);
+	CHECK(mismatches(whole, gathered) == 0);
+}
+
+TEST_CASE("failures reach the coordinator") {
+	CHECK_THROWS_AS(cellular::Domain<GameOfLife>(5, 5, 3),
+	                std::invalid_argument);
+	CHECK_THROWS_AS(cellular::Domain<GameOfLife>(
+	                    16,
+	                    16,
+	                    2,
+	                    Boundary::dead,
+	                    [](size_t, size_t) -> GameOfLife {
+		                    throw std::runtime_error("out of memory");
+	                    }),
+	                std::runtime_error);
+}
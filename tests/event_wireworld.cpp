@@ -0,0 +1,67 @@
+#include "event_wireworld.hpp"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <random>
+#include <stdexcept>
+
+#include "doctest.h"
+#include "test_util.hpp"
+#include "wireworld.hpp"
+
+using namespace wireworld;
+using test_util::mismatches;
+
+namespace {
+/// Fill `dense` with random wires with electrons on them.
+void random_circuit(Wireworld& dense, const unsigned int seed) {
+	std::mt19937                    rng(seed);
+	std::discrete_distribution<int> pick{40, 4, 4, 52};
+	for (size_t x = 0; x < dense.width(); ++x) {
+		for (size_t y = 0; y < dense.height(); ++y) {
+			dense(x, y) = static_cast<State>(pick(rng));
+		}
+	}
+}
+} // namespace
+
+TEST_CASE("event driven stepping matches the dense step") {
+	for (const auto boundary :
+	     {Boundary::dead, Boundary::toroidal, Boundary::reflective}) {
+		CAPTURE(static_cast<int>(boundary));
+		Wireworld dense(97, 61);
+		random_circuit(dense, 3);
+		dense.set_boundary(boundary);
+		EventWireworld events(dense);
+		CHECK(mismatches(dense, events) == 0);
+		for (int generation = 0; generation < 40; ++generation) {
+			dense.step();
+			events.step();
+		}
+		CHECK(events.generation() == 40);
+		CHECK(mismatches(dense, events) == 0);
+	}
+}
+
+TEST_CASE("an electron runs down a wire and leaves it") {
+	Wireworld dense(12, 3);
+	dense.set_grid_from_string("            \n"
+	                           "o*##########\n"
+	                           "            \n");
+	EventWireworld events(dense);
+	CHECK(events.cell_count() == 12);
+	CHECK(events.head_count() == 1);
+	events.step(5);
+	CHECK(events(6, 1) == State::ElectronHead);
+	CHECK(events(5, 1) == State::ElectronTail);
+	CHECK(events(1, 1) == State::Conductor);
+	CHECK(events.head_count() == 1);
+	events.step(6);
+	CHECK(events(11, 1) == State::ElectronTail);
+	CHECK(events.head_count() == 0);
+
+	Wireworld copy(12, 3);
+	events.copy_to(copy);
+	CHECK(mismatches(copy, events) == 0);
+	Wireworld wrong_size(3, 3);
+	CHECK_THROWS_AS(events.copy_to(wrong_size), std::invalid_argument);
+}
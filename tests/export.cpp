@@ -0,0 +1,173 @@
+#include "cellular_export.hpp"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "doctest.h"
+#include "game_of_life.hpp"
+#include "packed_game_of_life.hpp"
+#include "test_util.hpp"
+#include "wireworld.hpp"
+
+namespace {
+using gol::State;
+using test_util::random_soup;
+
+const Palette<State> palette{{State::Dead, {0, 0, 0}},
+                             {State::Alive, {255, 200, 0}}};
+
+/// A directory in the temporary directory, removed with everything in it at
+/// the end of the scope.
+class TemporaryDirectory {
+public:
+	explicit TemporaryDirectory(const std::string& name) :
+	    m_path(std::filesystem::temp_directory_path() / name) {
+		std::filesystem::remove_all(m_path);
+		std::filesystem::create_directory(m_path);
+	}
+	~TemporaryDirectory() { std::filesystem::remove_all(m_path); }
+	const std::filesystem::path& path() const { return m_path; }
+
+private:
+	std::filesystem::path m_path;
+};
+
+std::string read_file(const std::filesystem::path& path) {
+	std::ifstream file(path, std::ios::binary);
+	return {std::istreambuf_iterator<char>(file),
+	        std::istreambuf_iterator<char>()};
+}
+
+/// The pixels `automaton` should come out as, RGB or gray, rows along x.
+std::string pixels(const gol::GameOfLife& automaton,
+                   const size_t           scale,
+                   const bool             gray) {
+	std::string ret;
+	for (size_t py = 0; py < automaton.height() * scale; ++py) {
+		for (size_t px = 0; px < automaton.width() * scale; ++px) {
+			const Rgb color = palette(automaton(px / scale, py / scale));
+			if (gray) {
+				ret += static_cast<char>(color.gray());
+			} else {
+				ret += static_cast<char>(color.r);
+				ret += static_cast<char>(color.g);
+				ret += static_cast<char>(color.b);
+			}
+		}
+	}
+	return ret;
+}
+} // namespace
+
+TEST_CASE("frames are written as PPM and PGM files") {
+	for (const bool gray : {false, true}) {
+		TemporaryDirectory directory("cellular_export_test");
+		gol::GameOfLife    automaton(7, 5);
+		random_soup(automaton, 0.4, 9);
+		std::vector<std::string> expected;
+		{
+			ExportOptions options;
+			options.format    = gray ? FrameFormat::pgm : FrameFormat::ppm;
+			options.directory = directory.path();
+			options.scale     = 3;
+			FrameExporter<State> exporter(palette, options);
+			for (int generation = 0; generation < 4; ++generation) {
+				exporter.submit(automaton);
+				expected.push_back(pixels(automaton, 3, gray));
+				automaton.step();
+			}
+			exporter.finish();
+			CHECK(exporter.written() == 4);
+		}
+		for (size_t generation = 0; generation < 4; ++generation) {
+			const std::string name = "00000" + std::to_string(generation)
+			                         + (gray ? ".pgm" : ".ppm");
+			const std::string header = gray ? "P5\n21 15\n255\n"
+			                                : "P6\n21 15\n255\n";
+			CHECK(read_file(directory.path() / name)
+			      == header + expected[generation]);
+		}
+	}
+}
+
+TEST_CASE("frames of grids without a generation are numbered in order") {
+	TemporaryDirectory directory("cellular_export_packed_test");
+	gol::GameOfLife    automaton(7, 5);
+	random_soup(automaton, 0.4, 9);
+	gol::PackedGameOfLife    packed(automaton);
+	std::vector<std::string> expected;
+	{
+		ExportOptions options;
+		options.directory = directory.path();
+		options.workers   = 4;
+		FrameExporter<State> exporter(palette, options);
+		for (int frame = 0; frame < 6; ++frame) {
+			exporter.submit(packed);
+			expected.push_back(pixels(automaton, 1, false));
+			packed.step();
+			automaton.step();
+		}
+		exporter.finish();
+	}
+	for (size_t frame = 0; frame < 6; ++frame) {
+		const std::string name = "00000" + std::to_string(frame) + ".ppm";
+		CHECK(read_file(directory.path() / name)
+		      == "P6\n7 5\n255\n" + expected[frame]);
+	}
+}
+
+TEST_CASE("raw video keeps the frames in order") {
+	// More workers than snapshots, so frames finish out of order and
+	// `submit` has to wait.
+	ExportOptions options;
+	options.workers = 4;
+	options.queue   = 2;
+	for (const bool gray : {false, true}) {
+		std::ostringstream stream;
+		options.format = gray ? FrameFormat::raw_gray : FrameFormat::raw_rgb;
+		options.stream = &stream;
+		gol::GameOfLife automaton(33, 17);
+		random_soup(automaton, 0.4, 9);
+		std::string          expected;
+		FrameExporter<State> exporter(palette, options);
+		for (int generation = 0; generation < 60; ++generation) {
+			exporter.submit(automaton);
+			expected += pixels(automaton, 1, gray);
+			automaton.step();
+		}
+		exporter.finish();
+		CHECK(stream.str() == expected);
+	}
+}
+
+TEST_CASE("palettes are per state type") {
+	using wireworld::State;
+	const Palette<State> colors{{State::ElectronHead, {0, 0, 255}},
+	                            {State::Conductor, {255, 255, 0}}};
+	CHECK(colors(State::ElectronHead) == Rgb{0, 0, 255});
+	CHECK(colors(State::Conductor) == Rgb{255, 255, 0});
+	// Unset states are black.
+	CHECK(colors(State::ElectronTail) == Rgb{});
+	CHECK(Rgb{255, 255, 255}.gray() == 255);
+}
+
+TEST_CASE("export errors reach the caller") {
+	ExportOptions options;
+	options.format = FrameFormat::raw_rgb;
+	CHECK_THROWS_AS(FrameExporter<State>(palette, options),
+	                std::invalid_argument);
+
+	options.format    = FrameFormat::ppm;
+	options.directory = std::filesystem::temp_directory_path()
+	                    / "cellular_export_test_missing" / "frames";
+	FrameExporter<State>  exporter(palette, options);
+	const gol::GameOfLife automaton(4, 4);
+	exporter.submit(automaton);
+	CHECK_THROWS_AS(exporter.finish(), std::runtime_error);
+}
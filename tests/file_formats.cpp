@@ -0,0 +1,187 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include "cellular_io.hpp"
+#include "doctest.h"
+#include "game_of_life.hpp"
+#include "packed_game_of_life.hpp"
+#include "wireworld.hpp"
+
+namespace {
+using cellular::io::Format;
+
+/// A file with `contents` in the temporary directory, removed again at the
+/// end of the scope.
+class TemporaryFile {
+public:
+	TemporaryFile(const std::string& name, const std::string& contents) :
+	    m_path(std::filesystem::temp_directory_path() / name) {
+		std::ofstream(m_path, std::ios::binary) << contents;
+	}
+	~TemporaryFile() { std::filesystem::remove(m_path); }
+	const std::filesystem::path& path() const { return m_path; }
+
+private:
+	std::filesystem::path m_path;
+};
+
+// The vertical blinker in `spinner.txt`, in every format.
+const std::string spinner_plain = "*****\n**#**\n**#**\n**#**\n*****\n";
+const std::string spinner_rle =
+    "#N Blinker\n#C A comment.\nx = 5, y = 5, rule = B3/S23\n"
+    "5b$2bo2b$2bo2b$\n2bo2b$5b!\n";
+// Life 1.06 has no size, so the grid is just the bounding box.
+const std::string spinner_life_1_06 = "#Life 1.06\n0 -1\n0 0\n0 1\n";
+
+/// Game of Life states without a rule, constructed through `Automaton`'s
+/// own file constructor.
+class FileLife : public cellular::Automaton<gol::State> {
+public:
+	using Automaton::Automaton;
+	char state_to_char(const gol::State state) const override {
+		return state == gol::State::Alive ? '#' : '*';
+	}
+	gol::State char_to_state(const char c) const override {
+		return c == '#' ? gol::State::Alive : gol::State::Dead;
+	}
+	gol::State cycle_state(const gol::State state) const override {
+		return state;
+	}
+
+protected:
+	gol::State next_state(const gol::State state,
+	                      const size_t,
+	                      const size_t) override {
+		return state;
+	}
+};
+
+template<typename Life>
+void check_spinner(const Life& automaton, const size_t left, const size_t top) {
+	for (size_t x = 0; x < automaton.width(); ++x) {
+		for (size_t y = 0; y < automaton.height(); ++y) {
+			const bool alive = x == left && y >= top && y < top + 3;
+			CHECK(automaton(x, y) == (alive ? gol::State::Alive
+			                                : gol::State::Dead));
+		}
+	}
+}
+} // namespace
+
+TEST_CASE("formats are detected from the header") {
+	using cellular::io::detect_format;
+	CHECK(detect_format(spinner_plain) == Format::plain);
+	CHECK(detect_format(spinner_rle) == Format::rle);
+	CHECK(detect_format("x=3,y=1\n3o!") == Format::rle);
+	CHECK(detect_format(spinner_life_1_06) == Format::life_1_06);
+	// Grid lines that start with a live cell aren't comments.
+	CHECK(detect_format("#**\n***\n") == Format::plain);
+}
+
+TEST_CASE("plain text, RLE and Life 1.06 load the same pattern") {
+	const TemporaryFile plain("cellular_spinner.txt", spinner_plain);
+	const TemporaryFile rle("cellular_spinner.rle", spinner_rle);
+	const TemporaryFile life_1_06("cellular_spinner.lif", spinner_life_1_06);
+
+	gol::GameOfLife automaton(plain.path());
+	CHECK(automaton.width() == 5);
+	CHECK(automaton.height() == 5);
+	check_spinner(automaton, 2, 1);
+
+	automaton.set_grid_from_file(rle.path());
+	CHECK(automaton.width() == 5);
+	CHECK(automaton.height() == 5);
+	check_spinner(automaton, 2, 1);
+	automaton.step();
+	CHECK(automaton(1, 2) == gol::State::Alive);
+	CHECK(automaton(3, 2) == gol::State::Alive);
+
+	automaton.set_grid_from_file(life_1_06.path());
+	CHECK(automaton.width() == 1);
+	CHECK(automaton.height() == 3);
+	check_spinner(automaton, 0, 0);
+
+	gol::PackedGameOfLife packed(rle.path());
+	check_spinner(packed, 2, 1);
+	packed.set_grid_from_file(life_1_06.path());
+	check_spinner(packed, 0, 0);
+	packed.set_grid_from_string(std::string(spinner_plain));
+	check_spinner(packed, 2, 1);
+}
+
+TEST_CASE("the file constructor loads with the derived class's states") {
+	const TemporaryFile plain("cellular_spinner.txt", spinner_plain);
+	const FileLife      automaton(plain.path());
+	CHECK(automaton.width() == 5);
+	CHECK(automaton.height() == 5);
+	check_spinner(automaton, 2, 1);
+
+	// Loading explicitly before the first use replaces the pending file.
+	FileLife replaced(plain.path());
+	replaced.set_grid_from_string("#", '\n');
+	CHECK(replaced.width() == 1);
+	CHECK(replaced(0, 0) == gol::State::Alive);
+
+	FileLife missing("cellular_missing.txt");
+	CHECK_THROWS(missing.width());
+}
+
+TEST_CASE("plain text doesn't need a trailing delimiter") {
+	gol::GameOfLife automaton(1, 1);
+	automaton.set_grid_from_string("*#*;***", ';');
+	CHECK(automaton.width() == 3);
+	CHECK(automaton.height() == 2);
+	CHECK(automaton(1, 0) == gol::State::Alive);
+	CHECK(automaton(1, 1) == gol::State::Dead);
+}
+
+TEST_CASE("multi-state RLE") {
+	// Wireworld states are numbered like Golly's: A is an electron head, B a
+	// tail and C a conductor.
+	wireworld::Wireworld automaton(1, 1);
+	automaton.set_grid_from_string("x = 4, y = 2\nBA2C$.3C!");
+	CHECK(automaton.width() == 4);
+	CHECK(automaton.height() == 2);
+	CHECK(automaton(0, 0) == wireworld::State::ElectronTail);
+	CHECK(automaton(1, 0) == wireworld::State::ElectronHead);
+	CHECK(automaton(2, 0) == wireworld::State::Conductor);
+	CHECK(automaton(0, 1) == wireworld::State::Empty);
+	CHECK(automaton(3, 1) == wireworld::State::Conductor);
+
+	// Past the 4 states of Wireworld, and the 16 of any count rule.
+	CHECK_THROWS_AS(automaton.set_grid_from_string("x = 2, y = 1\nAD!"),
+	                std::invalid_argument);
+	CHECK_THROWS_AS(automaton.set_grid_from_string("x = 1, y = 1\nX!"),
+	                std::invalid_argument);
+	CHECK(automaton.width() == 4);
+}
+
+TEST_CASE("malformed input throws and keeps the grid") {
+	gol::GameOfLife automaton(1, 1);
+	automaton.set_grid_from_string(std::string(spinner_plain));
+
+	CHECK_THROWS_AS(automaton.set_grid_from_string("**\n***\n"),
+	                std::invalid_argument);
+	CHECK_THROWS_AS(automaton.set_grid_from_string("**\n*x\n"),
+	                std::invalid_argument);
+	CHECK_THROWS_AS(automaton.set_grid_from_string(""), std::invalid_argument);
+	CHECK_THROWS_AS(automaton.set_grid_from_string("x = 2, y = 1\n3o!"),
+	                std::invalid_argument);
+	CHECK_THROWS_AS(automaton.set_grid_from_string("x = 2, y = 1\n2o"),
+	                std::invalid_argument);
+	CHECK_THROWS_AS(automaton.set_grid_from_string("x = 2, y = 1\n2z!"),
+	                std::invalid_argument);
+	CHECK_THROWS_AS(automaton.set_grid_from_string("x = 2, y = 1\nBo!"),
+	                std::invalid_argument);
+	CHECK_THROWS_AS(automaton.set_grid_from_string("#Life 1.06\n1 a\n"),
+	                std::invalid_argument);
+	CHECK_THROWS_AS(automaton.set_grid_from_file("/nonexistent/grid.rle"),
+	                std::system_error);
+
+	CHECK(automaton.width() == 5);
+	check_spinner(automaton, 2, 1);
+}
@@ -17,12 +17,18 @@ TEST_CASE("generation 0") {
 	// 	INFO('\n');
 	// }
 	CHECK(automaton(0, 0) == State::Dead);
-	// CHECK(automaton(2, 1) == State::Alive);
+	CHECK(automaton(2, 1) == State::Alive);
 }
 
-// TEST_CASE("generation 1") {
-// 	automaton.step();
-// 	CHECK(automaton(0, 0) == State::Dead);
-// 	CHECK(automaton(2, 1) == State::Dead);
-// 	CHECK(automaton(1, 2) == State::Alive);
-// }
+TEST_CASE("generation 1") {
+	automaton.step();
+	CHECK(automaton(0, 0) == State::Dead);
+	CHECK(automaton(2, 1) == State::Dead);
+	CHECK(automaton(1, 2) == State::Alive);
+}
+
+TEST_CASE("generation 2") {
+	automaton.step();
+	CHECK(automaton(2, 1) == State::Alive);
+	CHECK(automaton(1, 2) == State::Dead);
+}
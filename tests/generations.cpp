@@ -0,0 +1,80 @@
+#include "cellular_stream.hpp"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <stdexcept>
+#include <vector>
+
+#include "doctest.h"
+#include "game_of_life.hpp"
+#include "packed_game_of_life.hpp"
+#include "test_util.hpp"
+
+using namespace gol;
+using test_util::random_soup;
+using test_util::same_cells;
+
+namespace {
+/// Take `count` generations from `stream` and check them against stepping
+/// a copy of `start` by `stride` at a time.
+template<typename Stream>
+void check_stream(Stream&&          stream,
+                  const GameOfLife& start,
+                  const size_t      stride,
+                  const size_t      count) {
+	GameOfLife expected = start;
+	size_t     taken    = 0;
+	for (const auto& grid : stream) {
+		REQUIRE(grid.generation() == taken * stride);
+		REQUIRE(same_cells(expected, grid));
+		expected.step(stride);
+		if (++taken == count) { break; }
+	}
+	CHECK(taken == count);
+}
+} // namespace
+
+TEST_CASE("generations are stepped as they're asked for") {
+	GameOfLife automaton(48, 40);
+	random_soup(automaton, 0.4, 1);
+	const GameOfLife start = automaton;
+	{
+		auto stream = generations(automaton, 3);
+		CHECK(automaton.generation() == 0);
+		check_stream(stream, start, 3, 5);
+	}
+	// Nothing past the last generation taken.
+	CHECK(automaton.generation() == 12);
+
+	// The stream yields the automaton itself.
+	for (const GameOfLife& grid : generations(automaton)) {
+		CHECK(&grid == &automaton);
+		break;
+	}
+}
+
+TEST_CASE("pipelined generations match stepping in place") {
+	for (const size_t buffers : {2, 3, 5}) {
+		GameOfLife automaton(48, 40);
+		random_soup(automaton, 0.4, 2);
+		const GameOfLife start = automaton;
+		check_stream(
+		    pipelined_generations(automaton, 2, buffers), start, 2, 30);
+		// The producer may have stepped ahead, but it's stopped now.
+		CHECK(automaton.generation() >= 58);
+		CHECK(automaton.generation() % 2 == 0);
+	}
+
+	// Grids that don't count generations are counted from 0.
+	GameOfLife start(48, 40);
+	random_soup(start, 0.4, 3);
+	PackedGameOfLife packed(start);
+	check_stream(pipelined_generations(packed, 1, 2), start, 1, 10);
+}
+
+TEST_CASE("streams reject empty strides and rings") {
+	GameOfLife automaton(4, 4);
+	CHECK_THROWS_AS(generations(automaton, 0), std::invalid_argument);
+	CHECK_THROWS_AS(pipelined_generations(automaton, 0), std::invalid_argument);
+	CHECK_THROWS_AS(pipelined_generations(automaton, 1, 1),
+	                std::invalid_argument);
+}
@@ -0,0 +1,60 @@
+#include "hashlife.hpp"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include "doctest.h"
+#include "game_of_life.hpp"
+#include "test_util.hpp"
+
+using namespace gol;
+using test_util::random_soup;
+using test_util::same_cells;
+
+TEST_CASE("matches the dense engine") {
+	// The soup sits in the middle of a dead margin that's wider than the
+	// amount of generations, so the dense grid's edges don't matter.
+	constexpr size_t size        = 96;
+	constexpr size_t margin      = 32;
+	constexpr int    generations = 29;
+
+	GameOfLife dense(size, size);
+	random_soup(dense, 0.4, 3, margin);
+
+	HashLife hashlife(dense);
+	for (int i = 0; i < generations; ++i) { dense.step(); }
+	hashlife.advance(generations);
+	CHECK(hashlife.generation() == generations);
+
+	GameOfLife copy(size, size);
+	hashlife.copy_to(copy);
+	CHECK(same_cells(copy, dense));
+}
+
+TEST_CASE("glider after a billion generations") {
+	// A glider moves one cell diagonally every four generations.
+	HashLife hashlife;
+	hashlife.set(1, 0, State::Alive);
+	hashlife.set(2, 1, State::Alive);
+	hashlife.set(0, 2, State::Alive);
+	hashlife.set(1, 2, State::Alive);
+	hashlife.set(2, 2, State::Alive);
+
+	constexpr std::uint64_t generations = 1'000'000'000;
+	constexpr std::int64_t  offset      = generations / 4;
+	hashlife.advance(generations);
+	CHECK(hashlife.population() == 5);
+	CHECK(hashlife.get(offset + 1, offset + 0) == State::Alive);
+	CHECK(hashlife.get(offset + 2, offset + 1) == State::Alive);
+	CHECK(hashlife.get(offset + 0, offset + 2) == State::Alive);
+	CHECK(hashlife.get(offset + 1, offset + 2) == State::Alive);
+	CHECK(hashlife.get(offset + 2, offset + 2) == State::Alive);
+}
+
+TEST_CASE("garbage collection keeps the universe intact") {
+	HashLife hashlife(GameOfLife("./spinner.txt"), 64);
+	hashlife.advance(1001);
+	CHECK(hashlife.node_count() < 200);
+	CHECK(hashlife.population() == 3);
+	CHECK(hashlife.get(1, 2) == State::Alive);
+	CHECK(hashlife.get(2, 1) == State::Dead);
+}
@@ -0,0 +1,100 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <vector>
+
+#include "cellular_layout.hpp"
+#include "doctest.h"
+#include "game_of_life.hpp"
+#include "test_util.hpp"
+
+namespace {
+using gol::State;
+using test_util::random_soup;
+using test_util::same_cells;
+
+/// Game of Life stored with `Layout`.
+template<typename Layout>
+class LayoutLife : public Automaton<State, Layout> {
+public:
+	using Automaton<State, Layout>::Automaton;
+	char  state_to_char(State) const override { return '*'; }
+	State char_to_state(char) const override { return State::Dead; }
+	State cycle_state(const State current_cell) const override {
+		return current_cell;
+	}
+
+protected:
+	State next_state(const State  current_cell,
+	                 const size_t x,
+	                 const size_t y) override {
+		const unsigned int live = this->count_moore(x, y, State::Alive);
+		return live == 3 || (current_cell == State::Alive && live == 2)
+		           ? State::Alive
+		           : State::Dead;
+	}
+};
+
+template<typename Layout>
+bool is_bijection(const size_t extent_0, const size_t extent_1) {
+	using Extents =
+	    stdex::extents<stdex::dynamic_extent, stdex::dynamic_extent>;
+	const typename Layout::template mapping<Extents> mapping(
+	    Extents(extent_0, extent_1));
+	std::vector<bool> used(mapping.required_span_size());
+	for (size_t i = 0; i < extent_0; ++i) {
+		for (size_t j = 0; j < extent_1; ++j) {
+			const auto index = mapping(i, j);
+			if (index < 0 || static_cast<size_t>(index) >= used.size()
+			    || used[index]) {
+				return false;
+			}
+			used[index] = true;
+		}
+	}
+	return true;
+}
+
+template<typename Layout>
+void check_layout(const Boundary boundary, const bool track_activity) {
+	constexpr size_t width  = 150;
+	constexpr size_t height = 97;
+
+	gol::GameOfLife    reference(width, height);
+	LayoutLife<Layout> automaton(width, height);
+	random_soup(reference, 0.3, 9);
+	random_soup(automaton, 0.3, 9);
+	reference.set_boundary(boundary);
+	automaton.set_boundary(boundary);
+	automaton.set_activity_tracking(track_activity);
+	automaton.set_threads(2);
+
+	bool same = true;
+	for (int generation = 0; generation < 25; ++generation) {
+		reference.step();
+		automaton.step();
+		same &= same_cells(reference, automaton);
+	}
+	CHECK(same);
+}
+} // namespace
+
+TEST_CASE("layouts map every cell to its own index") {
+	for (const size_t extent_0 : {1, 5, 13, 64, 70}) {
+		for (const size_t extent_1 : {1, 8, 21, 65}) {
+			CHECK(is_bijection<stdex::layout_right>(extent_0, extent_1));
+			CHECK(is_bijection<layout_tiled<5>>(extent_0, extent_1));
+			CHECK(is_bijection<layout_tiled<16>>(extent_0, extent_1));
+			CHECK(is_bijection<layout_morton<8>>(extent_0, extent_1));
+			CHECK(is_bijection<layout_morton<64>>(extent_0, extent_1));
+		}
+	}
+}
+
+TEST_CASE("automata step the same in every layout") {
+	for (const auto boundary : {Boundary::dead, Boundary::toroidal}) {
+		for (const bool track_activity : {false, true}) {
+			check_layout<layout_tiled<16>>(boundary, track_activity);
+			check_layout<layout_tiled<50>>(boundary, track_activity);
+			check_layout<layout_morton<32>>(boundary, track_activity);
+		}
+	}
+}
@@ -0,0 +1,141 @@
+#include "life_ensemble.hpp"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <stdexcept>
+#include <vector>
+
+#include "doctest.h"
+#include "game_of_life.hpp"
+#include "test_util.hpp"
+
+using namespace gol;
+using test_util::random_soup;
+
+namespace {
+bool same_grid(const GameOfLife&   dense,
+               const LifeEnsemble& ensemble,
+               const size_t        instance) {
+	for (size_t x = 0; x < dense.width(); ++x) {
+		for (size_t y = 0; y < dense.height(); ++y) {
+			if (dense(x, y) != ensemble(instance, x, y)) { return false; }
+		}
+	}
+	return true;
+}
+
+// A block, a blinker and a glider on a toroidal grid, which settle down
+// right away, after two generations and never.
+LifeEnsemble settling_ensemble() {
+	LifeEnsemble ensemble(6, 6, 3);
+	ensemble.set(0, 1, 1, State::Alive);
+	ensemble.set(0, 2, 1, State::Alive);
+	ensemble.set(0, 1, 2, State::Alive);
+	ensemble.set(0, 2, 2, State::Alive);
+
+	ensemble.set(1, 1, 2, State::Alive);
+	ensemble.set(1, 2, 2, State::Alive);
+	ensemble.set(1, 3, 2, State::Alive);
+
+	ensemble.set(2, 1, 0, State::Alive);
+	ensemble.set(2, 2, 1, State::Alive);
+	ensemble.set(2, 0, 2, State::Alive);
+	ensemble.set(2, 1, 2, State::Alive);
+	ensemble.set(2, 2, 2, State::Alive);
+	ensemble.set_boundary(Boundary::toroidal);
+	return ensemble;
+}
+} // namespace
+
+TEST_CASE("every instance matches its own dense grid") {
+	// 130 instances means two full batches and a partial one.
+	constexpr size_t instances = 130;
+	for (const auto boundary :
+	     {Boundary::dead, Boundary::toroidal, Boundary::reflective}) {
+		CAPTURE(static_cast<int>(boundary));
+		LifeEnsemble ensemble(23, 17, instances);
+		ensemble.set_boundary(boundary);
+		ensemble.set_threads(3);
+		std::vector<GameOfLife> dense;
+		for (size_t i = 0; i < instances; ++i) {
+			dense.emplace_back(23, 17);
+			random_soup(dense.back(), 0.35, static_cast<unsigned int>(i));
+			dense.back().set_boundary(boundary);
+			ensemble.assign(i, dense.back());
+		}
+		for (int generation = 0; generation < 15; ++generation) {
+			ensemble.step();
+			for (GameOfLife& grid : dense) { grid.step(); }
+		}
+		size_t mismatches = 0;
+		for (size_t i = 0; i < instances; ++i) {
+			mismatches += !same_grid(dense[i], ensemble, i);
+			CHECK(ensemble.generation(i) == 15);
+		}
+		CHECK(mismatches == 0);
+		size_t population = 0;
+		for (size_t x = 0; x < 23; ++x) {
+			for (size_t y = 0; y < 17; ++y) {
+				population += dense[129](x, y) == State::Alive;
+			}
+		}
+		CHECK(ensemble.population(129) == population);
+	}
+}
+
+TEST_CASE("stopped instances keep their cells") {
+	LifeEnsemble ensemble(5, 5, 2);
+	CHECK(ensemble.active_count() == 2);
+	for (const size_t instance : {0, 1}) {
+		// A blinker in both.
+		ensemble.set(instance, 1, 2, State::Alive);
+		ensemble.set(instance, 2, 2, State::Alive);
+		ensemble.set(instance, 3, 2, State::Alive);
+	}
+	ensemble.set_active(1, false);
+	ensemble.step();
+	CHECK(ensemble(0, 2, 1) == State::Alive);
+	CHECK(ensemble(0, 1, 2) == State::Dead);
+	CHECK(ensemble(1, 2, 1) == State::Dead);
+	CHECK(ensemble(1, 1, 2) == State::Alive);
+	CHECK(ensemble.generation(0) == 1);
+	CHECK(ensemble.generation(1) == 0);
+
+	GameOfLife copy(5, 5);
+	ensemble.copy_to(0, copy);
+	CHECK(copy(2, 3) == State::Alive);
+	GameOfLife wrong_size(3, 3);
+	CHECK_THROWS_AS(ensemble.copy_to(0, wrong_size), std::invalid_argument);
+	CHECK_THROWS_AS(ensemble.set_rule(cellular::rules::brians_brain),
+	                std::invalid_argument);
+}
+
+TEST_CASE("instances stop once they're still") {
+	LifeEnsemble ensemble = settling_ensemble();
+	ensemble.set_stop(LifeEnsemble::Stop::still);
+	ensemble.step(10);
+	CHECK(!ensemble.active(0));
+	CHECK(ensemble.generation(0) == 1);
+	CHECK(ensemble.active(1));
+	CHECK(ensemble.active(2));
+}
+
+TEST_CASE("instances stop once they repeat with period two") {
+	LifeEnsemble ensemble = settling_ensemble();
+	ensemble.set_stop(LifeEnsemble::Stop::period_two);
+	ensemble.step(10);
+	CHECK(!ensemble.active(0));
+	CHECK(!ensemble.active(1));
+	// The blinker is only known to repeat once it's back in its first phase.
+	CHECK(ensemble.generation(1) == 2);
+	CHECK(ensemble(1, 2, 2) == State::Alive);
+	CHECK(ensemble(1, 1, 2) == State::Alive);
+	CHECK(ensemble.active(2));
+	CHECK(ensemble.active_count() == 1);
+	CHECK(ensemble.population(2) == 5);
+
+	// Stepping stops early once nothing is active.
+	ensemble.set_active(2, false);
+	ensemble.step(1000);
+	CHECK(ensemble.active_count() == 0);
+	CHECK(ensemble.generation(2) == 10);
+}
@@ -0,0 +1,43 @@
+#include "packed_game_of_life.hpp"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include "doctest.h"
+#include "game_of_life.hpp"
+#include "test_util.hpp"
+
+using namespace gol;
+using test_util::random_soup;
+using test_util::same_cells;
+
+TEST_CASE("spinner") {
+	PackedGameOfLife automaton("./spinner.txt");
+	CHECK(automaton.width() == 5);
+	CHECK(automaton(2, 1) == State::Alive);
+	automaton.step();
+	CHECK(automaton(2, 1) == State::Dead);
+	CHECK(automaton(1, 2) == State::Alive);
+	CHECK(automaton.population() == 3);
+}
+
+TEST_CASE("matches the dense engine across word boundaries") {
+	// 130 columns means two full words and a partial one per row.
+	GameOfLife       dense(130, 37);
+	random_soup(dense, 0.35, 7);
+	PackedGameOfLife packed(dense);
+	for (int generation = 0; generation < 20; ++generation) {
+		dense.step();
+		packed.step();
+		REQUIRE(same_cells(dense, packed));
+	}
+}
+
+TEST_CASE("cell references") {
+	PackedGameOfLife automaton(70, 3);
+	automaton(69, 2) = State::Alive;
+	automaton(0, 0)  = automaton(69, 2);
+	CHECK(automaton(0, 0) == State::Alive);
+	automaton(0, 0) = automaton.cycle_state(automaton(0, 0));
+	CHECK(automaton(0, 0) == State::Dead);
+	CHECK(automaton.population() == 1);
+}
@@ -0,0 +1,53 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <memory>
+
+#include "cellular_thread_pool.hpp"
+#include "doctest.h"
+#include "game_of_life.hpp"
+#include "test_util.hpp"
+#include "wireworld.hpp"
+
+using test_util::random_states;
+using test_util::same_cells;
+
+TEST_CASE("parallel Game of Life matches serial stepping") {
+	gol::GameOfLife serial(123, 77);
+	random_states(serial, 2, 1);
+	gol::GameOfLife parallel = serial;
+	parallel.set_threads(4);
+
+	for (int generation = 0; generation < 16; ++generation) {
+		serial.step();
+		parallel.step();
+	}
+	CHECK(same_cells(serial, parallel));
+}
+
+TEST_CASE("parallel Wireworld matches serial stepping with a shared pool") {
+	auto pool = std::make_shared<cellular::ThreadPool>(3);
+
+	wireworld::Wireworld serial(64, 150);
+	random_states(serial, 4, 2);
+	wireworld::Wireworld first  = serial;
+	wireworld::Wireworld second = serial;
+	first.set_thread_pool(pool);
+	second.set_thread_pool(pool);
+
+	for (int generation = 0; generation < 16; ++generation) {
+		serial.step();
+		first.step();
+		second.step();
+	}
+	CHECK(same_cells(serial, first));
+	CHECK(same_cells(serial, second));
+}
+
+TEST_CASE("exceptions propagate out of the pool") {
+	cellular::ThreadPool pool(4);
+	CHECK_THROWS(pool.parallel_for(100, [](const size_t i) {
+		if (i == 57) { throw std::runtime_error("task failed"); }
+	}));
+	size_t sum = 0;
+	pool.parallel_for(1, [&](const size_t i) { sum += i + 1; });
+	CHECK(sum == 1);
+}
@@ -0,0 +1,122 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cellular_rule.hpp"
+#include "doctest.h"
+#include "game_of_life.hpp"
+#include "life_like.hpp"
+#include "packed_game_of_life.hpp"
+#include "test_util.hpp"
+
+namespace {
+using cellular::LifeLikeRule;
+namespace rules = cellular::rules;
+using test_util::mismatches;
+using test_util::random_soup;
+} // namespace
+
+TEST_CASE("rule strings") {
+	CHECK(LifeLikeRule::parse("B3/S23") == rules::life);
+	CHECK(LifeLikeRule::parse("b3/s23") == rules::life);
+	CHECK(LifeLikeRule::parse("S23/B3") == rules::life);
+	CHECK(LifeLikeRule::parse("23/3") == rules::life);
+	CHECK(LifeLikeRule::parse(" B36/S23 ") == rules::highlife);
+	CHECK(LifeLikeRule::parse("B2/S") == rules::seeds);
+	CHECK(LifeLikeRule::parse("B3678/S34678") == rules::day_and_night);
+	CHECK(LifeLikeRule::parse("/2/3") == rules::brians_brain);
+	CHECK(LifeLikeRule::parse("B2/S/C3") == rules::brians_brain);
+	CHECK(LifeLikeRule::parse("B2/S/3") == rules::brians_brain);
+
+	CHECK(rules::life.to_string() == "B3/S23");
+	CHECK(rules::brians_brain.to_string() == "B2/S/C3");
+	const LifeLikeRule star_wars = LifeLikeRule::parse("345/2/4");
+	CHECK(star_wars.to_string() == "B2/S345/C4");
+	CHECK(LifeLikeRule::parse(star_wars.to_string()) == star_wars);
+
+	for (const char* invalid :
+	     {"", "B3", "B9/S23", "B33/S23", "B3/S23/C1", "B3/S23/C17", "3",
+	      "B3/S23/C3/C4", "X3/S23", "23/3/x"}) {
+		CAPTURE(invalid);
+		CHECK_THROWS_AS(LifeLikeRule::parse(invalid), std::invalid_argument);
+	}
+}
+
+TEST_CASE("Generations rules cycle through their dying states") {
+	const LifeLikeRule rule = LifeLikeRule::parse("B2/S/C4");
+	CHECK(rule.next(0, 2) == 1);
+	CHECK(rule.next(0, 3) == 0);
+	CHECK(rule.next(1, 2) == 2);
+	CHECK(rule.next(2, 2) == 3);
+	CHECK(rule.next(3, 0) == 0);
+}
+
+TEST_CASE("B3/S23 matches GameOfLife") {
+	gol::GameOfLife     reference(123, 77);
+	life_like::LifeLike automaton(123, 77, "B3/S23");
+	random_soup(automaton, 0.4, 1);
+	for (size_t x = 0; x < automaton.width(); ++x) {
+		for (size_t y = 0; y < automaton.height(); ++y) {
+			reference(x, y) =
+			    static_cast<gol::State>(std::as_const(automaton)(x, y));
+		}
+	}
+	reference.step(30);
+	automaton.step(30);
+	CHECK(mismatches(automaton, reference) == 0);
+}
+
+TEST_CASE("packed kernels match the dense step for any rule") {
+	std::mt19937 rng(5);
+	// The specialized rules, and random ones through the runtime kernel.
+	std::vector<LifeLikeRule> checked{
+	    rules::life, rules::highlife, rules::seeds, rules::day_and_night};
+	for (int i = 0; i < 20; ++i) {
+		checked.push_back(
+		    {static_cast<std::uint16_t>(rng() & 0x1ff),
+		     static_cast<std::uint16_t>(rng() & 0x1ff)});
+	}
+	for (const LifeLikeRule& rule : checked) {
+		CAPTURE(rule.to_string());
+		life_like::LifeLike   dense(130, 41, rule);
+		gol::PackedGameOfLife packed(130, 41);
+		packed.set_rule(rule);
+		random_soup(dense, 0.3, 2);
+		for (size_t x = 0; x < dense.width(); ++x) {
+			for (size_t y = 0; y < dense.height(); ++y) {
+				packed(x, y) =
+				    static_cast<gol::State>(std::as_const(dense)(x, y));
+			}
+		}
+		for (int generation = 0; generation < 8; ++generation) {
+			dense.step();
+			packed.step();
+		}
+		CHECK(mismatches(dense, packed) == 0);
+	}
+
+	gol::PackedGameOfLife packed(8, 8);
+	CHECK_THROWS_AS(packed.set_rule(rules::brians_brain),
+	                std::invalid_argument);
+}
+
+TEST_CASE("Brian's Brain") {
+	// Two live cells side by side give birth to the cells above and below
+	// them, which fly apart while the original cells die out.
+	life_like::LifeLike automaton(6, 6, rules::brians_brain);
+	automaton.set_grid_from_string("******\n******\n**##**\n******\n"
+	                               "******\n******\n");
+	automaton.step();
+	CHECK(automaton(2, 2) == 2);
+	CHECK(automaton(3, 2) == 2);
+	CHECK(automaton(2, 1) == 1);
+	CHECK(automaton(3, 3) == 1);
+	automaton.step();
+	CHECK(automaton(2, 2) == 0);
+	CHECK(automaton(2, 1) == 2);
+	CHECK(automaton.state_to_char(automaton(2, 1)) == 'a');
+}
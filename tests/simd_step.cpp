@@ -0,0 +1,107 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "cellular_simd.hpp"
+#include "doctest.h"
+#include "test_util.hpp"
+#include "wireworld.hpp"
+
+using namespace cellular;
+using test_util::random_states;
+using test_util::same_cells;
+
+TEST_CASE("every supported instruction set matches the scalar kernel") {
+	const CountRule rule = CountRule::from(
+	    wireworld::State::ElectronHead,
+	    4,
+	    [](const wireworld::State state, const unsigned int count) {
+		    return (static_cast<unsigned int>(state) + count) % 4;
+	    });
+
+	std::mt19937                       rng(5);
+	std::uniform_int_distribution<int> state(0, 3);
+	for (size_t length : {1, 2, 3, 17, 31, 32, 33, 64, 100}) {
+		std::vector<std::uint8_t> lines(3 * length);
+		for (auto& cell : lines) { cell = state(rng); }
+		const std::uint8_t* above = lines.data();
+		const std::uint8_t* line  = above + length;
+		const std::uint8_t* below = line + length;
+
+		std::vector<std::uint8_t> expected(length);
+		simd::step_line(rule,
+		                above,
+		                line,
+		                below,
+		                expected.data(),
+		                length,
+		                simd::Isa::scalar);
+		for (const auto isa : {simd::Isa::ssse3, simd::Isa::avx2}) {
+			if (!simd::supported(isa)) { continue; }
+			std::vector<std::uint8_t> out(length);
+			simd::step_line(rule, above, line, below, out.data(), length, isa);
+			CHECK(out == expected);
+		}
+	}
+}
+
+TEST_CASE("vectorized Wireworld matches the rule") {
+	using wireworld::State;
+
+	wireworld::Wireworld automaton(40, 67);
+	random_states(automaton, 4, 6);
+
+	// Reference step, straight from the Wireworld rules.
+	const wireworld::Wireworld before = automaton;
+	automaton.step();
+	bool same = true;
+	for (size_t x = 0; x < before.width(); ++x) {
+		for (size_t y = 0; y < before.height(); ++y) {
+			unsigned int heads = 0;
+			for (int dx = -1; dx <= 1; ++dx) {
+				for (int dy = -1; dy <= 1; ++dy) {
+					const size_t nx = x + dx;
+					const size_t ny = y + dy;
+					if ((dx != 0 || dy != 0) && nx < before.width()
+					    && ny < before.height()) {
+						heads += before(nx, ny) == State::ElectronHead;
+					}
+				}
+			}
+			State expected = State::Empty;
+			switch (before(x, y)) {
+			case State::Empty:
+				break;
+			case State::ElectronHead:
+				expected = State::ElectronTail;
+				break;
+			case State::ElectronTail:
+				expected = State::Conductor;
+				break;
+			case State::Conductor:
+				expected = heads == 1 || heads == 2 ? State::ElectronHead
+				                                    : State::Conductor;
+				break;
+			}
+			same &= automaton(x, y) == expected;
+		}
+	}
+	CHECK(same);
+}
+
+TEST_CASE("step(generations) matches stepping one generation at a time") {
+	// Smaller than a tile, a few tiles with ragged edges, and one line.
+	for (const auto& [width, height] : {std::pair<size_t, size_t>{5, 3},
+	                                    {1100, 600},
+	                                    {1, 700}}) {
+		wireworld::Wireworld single(width, height);
+		random_states(single, 4, static_cast<unsigned int>(width + height));
+		wireworld::Wireworld blocked = single;
+		blocked.set_threads(2);
+
+		for (int i = 0; i < 21; ++i) { single.step(); }
+		blocked.step(21);
+		CHECK(same_cells(single, blocked));
+	}
+}
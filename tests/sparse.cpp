@@ -0,0 +1,151 @@
+#include "cellular_sparse.hpp"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <stdexcept>
+
+#include "doctest.h"
+#include "game_of_life.hpp"
+#include "life_like.hpp"
+#include "test_util.hpp"
+
+namespace {
+using test_util::random_soup;
+using test_util::random_states;
+using test_util::same_cells;
+
+/// Step a soup in the middle of `dense` and on a `SparseAutomaton` placed at
+/// (`left`, `top`), and check that they agree. The dead margin around the
+/// soup is wider than the amount of generations, so the dense grid's edges
+/// don't matter.
+template<size_t ChunkSize, typename Dense>
+void check_against_dense(Dense&              dense,
+                         const LifeLikeRule& rule,
+                         const std::int64_t  left,
+                         const std::int64_t  top) {
+	using StateType              = test_util::StateOf<Dense>;
+	constexpr size_t margin      = 70;
+	constexpr int    generations = 60;
+
+	random_states(dense, rule.states, 5, margin);
+
+	SparseAutomaton<StateType, ChunkSize> sparse(rule.count_rule());
+	sparse.assign(dense, left, top);
+	for (int i = 0; i < generations; ++i) {
+		dense.step();
+		sparse.step();
+	}
+	CHECK(sparse.generation() == generations);
+
+	Dense copy = dense;
+	sparse.copy_to(copy, left, top);
+	CHECK(same_cells(copy, dense));
+	size_t population = 0;
+	for (size_t x = 0; x < dense.width(); ++x) {
+		for (size_t y = 0; y < dense.height(); ++y) {
+			population += dense(x, y) != StateType();
+		}
+	}
+	// Nothing got out of the window.
+	CHECK(sparse.population() == population);
+}
+
+using Life = SparseAutomaton<gol::State>;
+using gol::State;
+
+void add_glider(Life& life, const std::int64_t x, const std::int64_t y) {
+	life.set(x + 1, y, State::Alive);
+	life.set(x + 2, y + 1, State::Alive);
+	life.set(x, y + 2, State::Alive);
+	life.set(x + 1, y + 2, State::Alive);
+	life.set(x + 2, y + 2, State::Alive);
+}
+} // namespace
+
+TEST_CASE("matches the dense engines") {
+	SUBCASE("Game of Life across negative chunks") {
+		gol::GameOfLife dense(250, 230);
+		check_against_dense<64>(dense, rules::life, -100, -190);
+	}
+	SUBCASE("a Generations rule with small chunks") {
+		life_like::LifeLike dense(240, 240, rules::brians_brain);
+		check_against_dense<16>(dense, rules::brians_brain, 3, -7);
+	}
+}
+
+TEST_CASE("neighbors of freed chunks are stepped") {
+	// Chunks this small empty all the time, and their neighbors have to see
+	// the cells that died with them.
+	for (unsigned int trial = 0; trial < 300; ++trial) {
+		CAPTURE(trial);
+		gol::GameOfLife soup(8, 8);
+		random_soup(soup, 0.5, trial);
+		gol::GameOfLife dense(40, 40);
+		for (size_t x = 0; x < 8; ++x) {
+			for (size_t y = 0; y < 8; ++y) {
+				dense(x + 16, y + 16) = soup(x, y);
+			}
+		}
+		const std::int64_t left = static_cast<std::int64_t>(trial % 4) - 20;
+		SparseAutomaton<State, 4> sparse(rules::life.count_rule());
+		sparse.assign(dense, left, left);
+		for (int generation = 0; generation < 16; ++generation) {
+			dense.step();
+			sparse.step();
+			gol::GameOfLife copy = dense;
+			sparse.copy_to(copy, left, left);
+			REQUIRE(same_cells(copy, dense));
+		}
+	}
+}
+
+TEST_CASE("a glider only keeps the chunks it's in") {
+	Life life(rules::life.count_rule());
+	// Straddling the four chunks around the origin.
+	add_glider(life, -2, -2);
+	CHECK(life.chunk_count() == 4);
+
+	// It moves a cell down and to the right every 4 generations, and after
+	// 1000 cells it's 15 chunks away.
+	life.step(4000);
+	CHECK(life.population() == 5);
+	CHECK(life.chunk_count() <= 4);
+	CHECK(life.pooled_chunks() > 0);
+	CHECK(life.get(998 + 1, 998) == State::Alive);
+	CHECK(life.get(998 + 2, 998 + 1) == State::Alive);
+	CHECK(life.get(998, 998 + 2) == State::Alive);
+	CHECK(life.get(998 + 1, 998 + 2) == State::Alive);
+	CHECK(life.get(998 + 2, 998 + 2) == State::Alive);
+	CHECK(life.get(-1, -2) == State::Dead);
+}
+
+TEST_CASE("empty chunks go back to the pool") {
+	Life life(rules::life.count_rule());
+	// A domino dies out right away.
+	life.set(-1, 0, State::Alive);
+	life.set(0, 0, State::Alive);
+	CHECK(life.chunk_count() == 2);
+	life.step();
+	CHECK(life.population() == 0);
+	CHECK(life.chunk_count() == 0);
+	// Along with the neighbors that were computed in case of births.
+	const size_t pooled = life.pooled_chunks();
+	CHECK(pooled >= 2);
+
+	// Reused by the next writes, and freed again once they're undone.
+	life.set(5, 5, State::Alive);
+	CHECK(life.pooled_chunks() == pooled - 1);
+	life.set(5, 5, State::Dead);
+	CHECK(life.chunk_count() == 1);
+	life.step();
+	CHECK(life.chunk_count() == 0);
+
+	add_glider(life, 10, 10);
+	life.clear();
+	CHECK(life.chunk_count() == 0);
+	CHECK(life.population() == 0);
+}
+
+TEST_CASE("rules that fill the plane are rejected") {
+	CHECK_THROWS_AS(Life(LifeLikeRule::parse("B03/S23").count_rule()),
+	                std::invalid_argument);
+}
@@ -0,0 +1,154 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include "doctest.h"
+#include "game_of_life.hpp"
+#include "test_util.hpp"
+#include "wireworld.hpp"
+
+namespace {
+using gol::State;
+using test_util::random_states;
+using Kind = Stabilization::Kind;
+
+/// Game of Life without a `CountRule`, so it steps through `next_state`.
+class ScalarLife : public Automaton<State> {
+public:
+	using Automaton<State>::Automaton;
+	char  state_to_char(State) const override { return '*'; }
+	State char_to_state(char) const override { return State::Dead; }
+	State cycle_state(const State current_cell) const override {
+		return current_cell;
+	}
+
+protected:
+	State next_state(const State  current_cell,
+	                 const size_t x,
+	                 const size_t y) override {
+		const unsigned int live = count_moore(x, y, State::Alive);
+		return live == 3 || (current_cell == State::Alive && live == 2)
+		           ? State::Alive
+		           : State::Dead;
+	}
+};
+
+/// Step `automaton` while checking its tracked hash against rehashing it
+/// from scratch.
+template<typename Grid>
+void check_hash(Grid& automaton) {
+	automaton.set_hash_tracking(true);
+	for (int generation = 0; generation < 20; ++generation) {
+		automaton.step();
+		Grid copy = automaton;
+		copy.set_hash_tracking(false);
+		REQUIRE(automaton.hash() == copy.hash());
+	}
+}
+} // namespace
+
+TEST_CASE("the tracked hash matches rehashing") {
+	SUBCASE("vectorized") {
+		gol::GameOfLife automaton(70, 300);
+		random_states(automaton, 2, 1);
+		check_hash(automaton);
+	}
+	SUBCASE("through next_state") {
+		ScalarLife automaton(70, 300);
+		random_states(automaton, 2, 2);
+		check_hash(automaton);
+	}
+	SUBCASE("threads, activity tracking and more states") {
+		wireworld::Wireworld automaton(200, 600);
+		random_states(automaton, 4, 3);
+		automaton.set_threads(3);
+		automaton.set_activity_tracking(true);
+		automaton.set_boundary(Boundary::toroidal);
+		check_hash(automaton);
+	}
+}
+
+TEST_CASE("the hash only depends on the cells") {
+	gol::GameOfLife a(16, 16);
+	gol::GameOfLife b(16, 16);
+	CHECK(a.hash() == 0);
+	a.set_hash_tracking(true);
+	// A blinker in a, stepped twice, and written straight into b.
+	a(4, 5) = State::Alive;
+	a(5, 5) = State::Alive;
+	a(6, 5) = State::Alive;
+	a.step(2);
+	b(4, 5) = State::Alive;
+	b(5, 5) = State::Alive;
+	b(6, 5) = State::Alive;
+	CHECK(a.hash() == b.hash());
+	a.step();
+	CHECK(a.hash() != b.hash());
+	// Writes are picked up by the next step, here a block in both.
+	for (gol::GameOfLife* grid : {&a, &b}) {
+		(*grid)(12, 12) = State::Alive;
+		(*grid)(13, 12) = State::Alive;
+		(*grid)(12, 13) = State::Alive;
+		(*grid)(13, 13) = State::Alive;
+	}
+	// A period later they're back in step.
+	a.step();
+	CHECK(a.hash() == b.hash());
+	b.step(2);
+	CHECK(a.hash() == b.hash());
+}
+
+TEST_CASE("the spinner oscillates from the start") {
+	gol::GameOfLife automaton("spinner.txt");
+	const Stabilization result = automaton.run_until_stable(100);
+	CHECK(result.kind == Kind::oscillating);
+	CHECK(result.period == 2);
+	CHECK(result.generation == 0);
+	CHECK(automaton.generation() == 2);
+}
+
+TEST_CASE("still lifes and extinction") {
+	gol::GameOfLife automaton(10, 10);
+	// Three cells of a block, which fill it in.
+	automaton(2, 2) = State::Alive;
+	automaton(3, 2) = State::Alive;
+	automaton(2, 3) = State::Alive;
+	Stabilization result = automaton.run_until_stable(100);
+	CHECK(result.kind == Kind::still);
+	CHECK(result.period == 1);
+	CHECK(result.generation == 1);
+
+	// A domino dies out right away.
+	gol::GameOfLife domino(10, 10);
+	domino(5, 5) = State::Alive;
+	domino(6, 5) = State::Alive;
+	result       = domino.run_until_stable(100);
+	CHECK(result.kind == Kind::extinct);
+	CHECK(result.period == 1);
+	CHECK(result.generation == 1);
+	CHECK(domino.generation() == 2);
+}
+
+TEST_CASE("a glider on a torus needs a long enough history") {
+	auto glider = [] {
+		gol::GameOfLife automaton(8, 8);
+		automaton(1, 0) = State::Alive;
+		automaton(2, 1) = State::Alive;
+		automaton(0, 2) = State::Alive;
+		automaton(1, 2) = State::Alive;
+		automaton(2, 2) = State::Alive;
+		automaton.set_boundary(Boundary::toroidal);
+		return automaton;
+	};
+	// It's back where it started after crossing the grid in 32 generations.
+	gol::GameOfLife automaton = glider();
+	Stabilization   result    = automaton.run_until_stable(100, 16);
+	CHECK(result.kind == Kind::unsettled);
+	CHECK(result.period == 0);
+	CHECK(result.generation == 100);
+
+	automaton = glider();
+	result    = automaton.run_until_stable(100, 32);
+	CHECK(result.kind == Kind::oscillating);
+	CHECK(result.period == 32);
+	CHECK(result.generation == 0);
+	CHECK(automaton.generation() == 32);
+}
@@ -0,0 +1,84 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include "cellular_layout.hpp"
+#include "cellular_static.hpp"
+#include "doctest.h"
+#include "game_of_life.hpp"
+#include "test_util.hpp"
+
+namespace {
+using gol::State;
+using test_util::random_soup;
+using test_util::same_cells;
+
+/// Game of Life without a `CountRule`, so it steps through `next_cell`.
+template<typename Layout>
+class StaticLife : public StaticAutomaton<StaticLife<Layout>, State, Layout> {
+public:
+	using StaticAutomaton<StaticLife, State, Layout>::StaticAutomaton;
+	char  state_to_char(State) const override { return '*'; }
+	State char_to_state(char) const override { return State::Dead; }
+	State cycle_state(const State current_cell) const override {
+		return current_cell;
+	}
+
+protected:
+	friend StaticAutomaton<StaticLife, State, Layout>;
+	State next_cell(const State  current_cell,
+	                const size_t x,
+	                const size_t y) const {
+		const unsigned int live = this->count_moore(x, y, State::Alive);
+		return live == 3 || (current_cell == State::Alive && live == 2)
+		           ? State::Alive
+		           : State::Dead;
+	}
+};
+
+/// Step `automaton` through the virtual interface, as the GUI does, next to
+/// `GameOfLife` and check that they agree.
+template<typename Layout>
+void check_against_game_of_life(StaticLife<Layout>& automaton,
+                                const unsigned int  seed) {
+	gol::GameOfLife expected(automaton.width(), automaton.height());
+	random_soup(automaton, 0.35, seed);
+	random_soup(expected, 0.35, seed);
+	expected.set_boundary(automaton.boundary());
+
+	Automaton<State, Layout>& stepped = automaton;
+	for (int generation = 0; generation < 12; ++generation) {
+		stepped.step();
+		expected.step();
+		REQUIRE(same_cells(automaton, expected));
+	}
+}
+
+template<typename Layout>
+void check_layout(const Boundary boundary, const unsigned int seed) {
+	StaticLife<Layout> automaton(61, 45);
+	automaton.set_boundary(boundary);
+	check_against_game_of_life(automaton, seed);
+}
+} // namespace
+
+TEST_CASE("StaticAutomaton steps like the virtual rule") {
+	for (const Boundary boundary : {Boundary::dead, Boundary::toroidal}) {
+		check_layout<stdex::layout_right>(boundary, 1);
+		check_layout<layout_tiled<16>>(boundary, 2);
+	}
+	SUBCASE("threads and activity tracking") {
+		StaticLife<layout_tiled<16>> automaton(200, 300);
+		automaton.set_threads(3);
+		automaton.set_activity_tracking(true);
+		check_against_game_of_life(automaton, 3);
+	}
+}
+
+TEST_CASE("StaticAutomaton keeps the tracked hash") {
+	StaticLife<stdex::layout_right> automaton(40, 40);
+	random_soup(automaton, 0.35, 4);
+	automaton.set_hash_tracking(true);
+	automaton.step(5);
+	StaticLife<stdex::layout_right> copy = automaton;
+	copy.set_hash_tracking(false);
+	CHECK(automaton.hash() == copy.hash());
+}
@@ -0,0 +1,177 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "cellular_stats.hpp"
+#include "doctest.h"
+#include "game_of_life.hpp"
+#include "test_util.hpp"
+#include "wireworld.hpp"
+
+namespace {
+using gol::State;
+using test_util::random_states;
+
+/// Game of Life without a `CountRule`, so it steps through `next_state`.
+class ScalarLife : public Automaton<State> {
+public:
+	using Automaton<State>::Automaton;
+	char  state_to_char(State) const override { return '*'; }
+	State char_to_state(char) const override { return State::Dead; }
+	State cycle_state(const State current_cell) const override {
+		return current_cell;
+	}
+
+protected:
+	State next_state(const State  current_cell,
+	                 const size_t x,
+	                 const size_t y) override {
+		const unsigned int live = count_moore(x, y, State::Alive);
+		return live == 3 || (current_cell == State::Alive && live == 2)
+		           ? State::Alive
+		           : State::Dead;
+	}
+};
+
+/// Amount of cells in each state, counted the slow way.
+template<typename Grid>
+std::vector<size_t> recount(const Grid& automaton, const size_t states) {
+	std::vector<size_t> ret(states);
+	for (size_t x = 0; x < automaton.width(); ++x) {
+		for (size_t y = 0; y < automaton.height(); ++y) {
+			++ret[static_cast<size_t>(automaton(x, y))];
+		}
+	}
+	while (!ret.empty() && ret.back() == 0) { ret.pop_back(); }
+	return ret;
+}
+
+/// Step `automaton` while checking every generation's statistics against a
+/// copy stepped without them.
+template<typename Grid>
+void check_stats(Grid& automaton, const size_t states) {
+	Grid                         plain = automaton;
+	std::vector<GenerationStats> seen;
+	automaton.add_observer(
+	    [&](const GenerationStats& stats) { seen.push_back(stats); });
+	for (size_t generation = 1; generation <= 12; ++generation) {
+		const Grid before = automaton;
+		automaton.step();
+		plain.step();
+		REQUIRE(seen.size() == generation);
+		const GenerationStats& stats = seen.back();
+		size_t                 changed = 0;
+		for (size_t x = 0; x < automaton.width(); ++x) {
+			for (size_t y = 0; y < automaton.height(); ++y) {
+				changed += before(x, y) != automaton(x, y);
+				CHECK(automaton(x, y) == plain(x, y));
+			}
+		}
+		CHECK(stats.generation == automaton.generation());
+		CHECK(stats.changed == changed);
+		CHECK(stats.population == recount(automaton, states));
+		CHECK(stats.seconds >= 0);
+	}
+}
+} // namespace
+
+TEST_CASE("a blinker's statistics") {
+	gol::GameOfLife automaton(5, 5);
+	automaton(1, 2) = State::Alive;
+	automaton(2, 2) = State::Alive;
+	automaton(3, 2) = State::Alive;
+	StatsLog log({"dead", "alive"});
+	automaton.add_observer(log.observer());
+	automaton.step(3);
+	REQUIRE(log.generations().size() == 3);
+	for (const GenerationStats& stats : log.generations()) {
+		CHECK(stats.evaluated == 25);
+		CHECK(stats.changed == 4);
+		CHECK(stats.population == std::vector<size_t>{22, 3});
+	}
+	CHECK(log.generations()[2].generation == 3);
+
+	std::ostringstream csv;
+	log.write_csv(csv);
+	const std::string header =
+	    "generation,seconds,evaluated,changed,dead,alive";
+	CHECK(csv.str().rfind(header + "\n1,", 0) == 0);
+	std::ostringstream json;
+	log.write_json(json);
+	CHECK(json.str().find("\"population\": {\"dead\": 22, \"alive\": 3}")
+	      != std::string::npos);
+}
+
+TEST_CASE("statistics match the grid") {
+	SUBCASE("vectorized") {
+		gol::GameOfLife automaton(70, 300);
+		random_states(automaton, 2, 1);
+		check_stats(automaton, 2);
+	}
+	SUBCASE("through next_state") {
+		ScalarLife automaton(70, 300);
+		random_states(automaton, 2, 2);
+		check_stats(automaton, 2);
+	}
+	SUBCASE("threads and activity tracking") {
+		wireworld::Wireworld automaton(200, 600);
+		random_states(automaton, 4, 3);
+		automaton.set_threads(3);
+		automaton.set_activity_tracking(true);
+		automaton.set_boundary(Boundary::toroidal);
+		check_stats(automaton, 4);
+	}
+}
+
+TEST_CASE("activity tracking only evaluates what changed") {
+	gol::GameOfLife automaton(600, 600);
+	automaton.set_activity_tracking(true);
+	automaton(1, 2) = State::Alive;
+	automaton(2, 2) = State::Alive;
+	automaton(3, 2) = State::Alive;
+	std::vector<GenerationStats> seen;
+	automaton.add_observer(
+	    [&](const GenerationStats& stats) { seen.push_back(stats); });
+	// Everything is evaluated the first time.
+	automaton.step(3);
+	REQUIRE(seen.size() == 3);
+	CHECK(seen[0].evaluated == 600 * 600);
+	CHECK(seen[2].evaluated < 600 * 600 / 10);
+	CHECK(seen[2].population == std::vector<size_t>{600 * 600 - 3, 3});
+
+	// Reading cells through the non-const `operator()` isn't a change.
+	size_t alive = 0;
+	for (size_t x = 0; x < automaton.width(); ++x) {
+		for (size_t y = 0; y < automaton.height(); ++y) {
+			alive += automaton(x, y) == State::Alive;
+		}
+	}
+	CHECK(alive == 3);
+	automaton.step();
+	REQUIRE(seen.size() == 4);
+	CHECK(seen[3].evaluated == seen[2].evaluated);
+}
+
+TEST_CASE("observers can be removed and writes are counted") {
+	gol::GameOfLife automaton(8, 8);
+	size_t          calls  = 0;
+	auto            count  = [&](const GenerationStats&) { ++calls; };
+	const size_t    handle = automaton.add_observer(count);
+	StatsLog log;
+	automaton.add_observer(log.observer());
+	automaton.step(2);
+	CHECK(calls == 2);
+	automaton.remove_observer(handle);
+	// A block, written between steps.
+	automaton(1, 1) = State::Alive;
+	automaton(1, 2) = State::Alive;
+	automaton(2, 1) = State::Alive;
+	automaton(2, 2) = State::Alive;
+	automaton.step();
+	CHECK(calls == 2);
+	REQUIRE(log.generations().size() == 3);
+	CHECK(log.generations()[1].population == std::vector<size_t>{64});
+	CHECK(log.generations()[2].population == std::vector<size_t>{60, 4});
+	CHECK(log.generations()[2].changed == 0);
+}
@@ -0,0 +1,44 @@
+// Built with the statistics compiled out, so it can't share the automata in
+// src/ with the other tests.
+#define CELLULAR_STATS 0
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "cellular.hpp"
+#include "doctest.h"
+
+namespace {
+enum class State : std::uint8_t { Dead, Alive };
+
+class Life : public cellular::Automaton<State> {
+public:
+	using Automaton<State>::Automaton;
+	char  state_to_char(State) const override { return '*'; }
+	State char_to_state(char) const override { return State::Dead; }
+	State cycle_state(const State current_cell) const override {
+		return current_cell;
+	}
+
+protected:
+	State next_state(const State  current_cell,
+	                 const size_t x,
+	                 const size_t y) override {
+		const unsigned int live = count_moore(x, y, State::Alive);
+		return live == 3 || (current_cell == State::Alive && live == 2)
+		           ? State::Alive
+		           : State::Dead;
+	}
+};
+} // namespace
+
+TEST_CASE("observers are never called without statistics") {
+	Life automaton(5, 5);
+	automaton(1, 2) = State::Alive;
+	automaton(2, 2) = State::Alive;
+	automaton(3, 2) = State::Alive;
+	size_t calls = 0;
+	automaton.add_observer([&](const cellular::GenerationStats&) { ++calls; });
+	automaton.step(4);
+	CHECK(calls == 0);
+	CHECK(automaton.generation() == 4);
+	CHECK(automaton(2, 2) == State::Alive);
+	CHECK(automaton(2, 1) == State::Dead);
+}
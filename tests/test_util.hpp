@@ -0,0 +1,72 @@
+#ifndef CELLULAR_TEST_UTIL_HPP_
+#define CELLULAR_TEST_UTIL_HPP_
+
+#include <cstddef>
+#include <random>
+#include <type_traits>
+#include <utility>
+
+/// Random grids and grid comparisons shared by the tests. A grid is anything
+/// with `width`, `height` and an `operator()` that takes `x` and `y`.
+namespace test_util {
+template<typename Grid>
+using StateOf = std::decay_t<decltype(std::declval<const Grid&>()(
+    std::size_t{}, std::size_t{}))>;
+
+/// Set every cell of `grid` to state 1 with a chance of `density`, and to
+/// the default state otherwise. Cells within `margin` of the edges are left
+/// as they are.
+template<typename Grid>
+void random_soup(Grid&              grid,
+                 const double       density,
+                 const unsigned int seed,
+                 const std::size_t  margin = 0) {
+	using State = StateOf<Grid>;
+	std::mt19937                rng(seed);
+	std::bernoulli_distribution alive(density);
+	for (std::size_t x = margin; x < grid.width() - margin; ++x) {
+		for (std::size_t y = margin; y < grid.height() - margin; ++y) {
+			grid(x, y) = alive(rng) ? static_cast<State>(1) : State();
+		}
+	}
+}
+
+/// Set every cell of `grid` to one of the first `states` states at random,
+/// but those within `margin` of the edges.
+template<typename Grid>
+void random_states(Grid&              grid,
+                   const int          states,
+                   const unsigned int seed,
+                   const std::size_t  margin = 0) {
+	std::mt19937                       rng(seed);
+	std::uniform_int_distribution<int> pick(0, states - 1);
+	for (std::size_t x = margin; x < grid.width() - margin; ++x) {
+		for (std::size_t y = margin; y < grid.height() - margin; ++y) {
+			grid(x, y) = static_cast<StateOf<Grid>>(pick(rng));
+		}
+	}
+}
+
+/// Amount of cells that differ between `a` and `b`, which are the same size.
+/// States are compared by value, so the grids can have different state
+/// types.
+template<typename A, typename B>
+std::size_t mismatches(const A& a, const B& b) {
+	std::size_t ret = 0;
+	for (std::size_t x = 0; x < a.width(); ++x) {
+		for (std::size_t y = 0; y < a.height(); ++y) {
+			ret += static_cast<int>(a(x, y)) != static_cast<int>(b(x, y));
+		}
+	}
+	return ret;
+}
+
+/// Whether `a` and `b` are the same size and have the same cells.
+template<typename A, typename B>
+bool same_cells(const A& a, const B& b) {
+	return a.width() == b.width() && a.height() == b.height()
+	       && mismatches(a, b) == 0;
+}
+} // namespace test_util
+
+#endif // CELLULAR_TEST_UTIL_HPP_